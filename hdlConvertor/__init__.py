@@ -1 +1 @@
-from ._hdlConvertor import HdlConvertor, ParseException
\ No newline at end of file
+from ._hdlConvertor import HdlConvertor, HdlExprTree, ParseException
\ No newline at end of file
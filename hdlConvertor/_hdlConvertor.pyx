@@ -1,4 +1,5 @@
 import sys
+from threading import Lock
 
 from cpython.ref cimport PyObject
 from cython.operator cimport dereference as deref
@@ -10,6 +11,7 @@ from libcpp cimport bool
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 from libcpp.pair cimport pair
+from libc.stdint cimport int64_t, uint32_t
 
 from hdlConvertor.hdlAst import HdlContext as PyHdlContext
 from hdlConvertor.language import Language as PyHdlLanguageEnum
@@ -20,12 +22,61 @@ cdef extern from "hdlConvertor/hdlObjects/hdlContext.h" namespace "hdlConvertor:
     cdef cppclass HdlContext:
         HdlContext()
 
+cdef extern from "hdlConvertor/hdlObjects/position.h" namespace "hdlConvertor::hdlObjects":
+    cdef cppclass Position:
+        pass
+    const bint Position_COMPACT "hdlConvertor::hdlObjects::Position::COMPACT"
+
+cdef extern from "hdlConvertor/hdlObjects/iHdlObj.h" namespace "hdlConvertor::hdlObjects":
+    cdef cppclass iHdlObj:
+        pass
+
+cdef extern from "hdlConvertor/hdlObjects/hdlExprTree.h" namespace "hdlConvertor::hdlObjects":
+    cdef cppclass iHdlExpr:
+        pass
+
+    cdef cppclass BigInteger:
+        BigInteger(int64_t v)
+
+    enum HdlValueType:
+        symb_NULL, symb_OPEN, symb_ALL, symb_OTHERS, symb_T, symb_AUTO
+
+    enum HdlOperatorType:
+        ARITH_SHIFT_RIGHT_ASSIGN
+
+    const char * HdlOperatorType_toString(HdlOperatorType opt) except +
+
+    cdef cppclass CppHdlExprTree "hdlConvertor::hdlObjects::HdlExprTree":
+        CppHdlExprTree(bool with_positions)
+        uint32_t add_none() except +
+        uint32_t add_value(HdlValueType value_type) except +
+        uint32_t add_id(const string & name) except +
+        uint32_t add_str(const string & s) except +
+        uint32_t add_int(const BigInteger & val, int bits) except +
+        uint32_t add_float(double val) except +
+        uint32_t add_array(const vector[uint32_t] & items) except +
+        uint32_t add_call(HdlOperatorType op, const vector[uint32_t] & args) except +
+        uint32_t root()
+        size_t size()
+        uint32_t append(const iHdlExpr * expr) except +
+        unique_ptr[iHdlExpr] to_expr(uint32_t n) except +
+
 cdef extern from "toPy.h" namespace "hdlConvertor":
+    ctypedef PyObject * (*ToPyLazyObjsFactory)(const vector[unique_ptr[iHdlObj]] * objs, void * owner) except NULL
+
     cdef cppclass ToPy:
+        ToPyLazyObjsFactory lazy_objs_factory
+        void * lazy_objs_owner
+        bool share_int_values
+
         ToPy()
 
-        @staticmethod
         PyObject * toPy(const HdlContext * c) except NULL
+        PyObject * toPy(const iHdlObj * o) except NULL
+        PyObject * toPy(const CppHdlExprTree & t, uint32_t n) except NULL
+
+include "lazyAst.pyx"
+include "hdlExprTree.pyx"
 
 cdef extern from "hdlConvertor/conversion_exception.h" namespace "hdlConvertor":
     cdef const char * get_cpp_py_error_message()
@@ -35,6 +86,36 @@ cdef extern from "hdlConvertor/language.h" namespace "hdlConvertor":
         VHDL, VERILOG1995, VERILOG2001, VERILOG2001_NOCONFIG, \
             VERILOG2005, SV2005, SV2009, SV2012, SV2017
 
+cdef extern from "hdlConvertor/parserContainer.h" namespace "hdlConvertor":
+    enum PredictionStrategy:
+        PREDICTION_LL, PREDICTION_SLL_LL
+
+    cdef cppclass ParserStats:
+        size_t parsed_cnt
+        size_t sll_fallback_cnt
+        void reset()
+
+cdef extern from "hdlConvertor/hdlAstBinary.h" namespace "hdlConvertor":
+    cdef cppclass HdlAstBinaryWriter:
+        HdlAstBinaryWriter()
+        void write(const HdlContext & ctx, const string & file_name) except + nogil
+
+cdef extern from "hdlConvertor/parseCache.h" namespace "hdlConvertor":
+    cdef cppclass ParseCache:
+        string dir
+        size_t get_hit_cnt()
+        size_t get_miss_cnt()
+        void reset_stats()
+
+cdef extern from "hdlConvertor/sourceMap.h" namespace "hdlConvertor":
+    cdef cppclass PreprocOutputSink:
+        pass
+
+cdef extern from "pyPreprocOutputSink.h" namespace "hdlConvertor":
+    cdef cppclass PyPreprocOutputSink(PreprocOutputSink):
+        PyPreprocOutputSink(PyObject * callback)
+        int raise_error() except -1
+
 cdef class ParseException(Exception):
     pass
 
@@ -48,6 +129,14 @@ cdef extern from "hdlConvertor/convertor.h" namespace "hdlConvertor":
     cdef cppclass Convertor:
         unique_ptr[HdlContext] c
         MacroDB defineDB
+        PredictionStrategy prediction
+        ParserStats stats
+        IncludeCache include_cache
+        bool preproc_fast_ifdef_skip
+        bool preproc_fast_copy
+        bool preproc_fast_macro_expansion
+        bool ast_arena
+        ParseCache parse_cache
 
         Convertor(HdlContext & _c)
 
@@ -56,24 +145,41 @@ cdef extern from "hdlConvertor/convertor.h" namespace "hdlConvertor":
             Language language,
             vector[string] include_dirs,
             bool hierarchy_only,
-            bool debug) except +raise_cpp_py_error
+            bool debug,
+            size_t jobs) except +raise_cpp_py_error nogil
 
         void parse_str(
             const string & hdl_str,
             Language language,
             vector[string] include_dirs,
             bool hierarchy_only,
-            bool debug) except +raise_cpp_py_error
+            bool debug) except +raise_cpp_py_error nogil
+
+        void load_ast(const string & file_name) except + nogil
+
+        void warmup_dfa(
+            const vector[string] & hdl_file_names,
+            Language language,
+            vector[string] include_dirs) except +raise_cpp_py_error nogil
+
+        @staticmethod
+        size_t get_dfa_state_cnt(Language language) except +raise_cpp_py_error nogil
 
         string verilog_pp(
             const string & filename,
             vector[string] incdirs,
-            Language mode) except +raise_cpp_py_error
+            Language mode) except +raise_cpp_py_error nogil
+
+        void verilog_pp(
+            const string & filename,
+            vector[string] incdirs,
+            Language mode,
+            PreprocOutputSink & sink) except +raise_cpp_py_error nogil
 
         string verilog_pp_str(
             const string & verilog_str,
             vector[string] incdirs,
-            Language mode) except +raise_cpp_py_error
+            Language mode) except +raise_cpp_py_error nogil
 
 cdef class HdlConvertor:
     """
@@ -81,16 +187,209 @@ cdef class HdlConvertor:
 
     :ivar thisptr: pointer on Convertor instance which is a wrapper around the parsers
     :ivar proproc_macro_db: dictinary of symbols defined in preprocessor
+    :ivar _lock: the lock for parse/parse_str/verilog_pp/verilog_pp_str/save_ast/load_ast,
+        the C++ part of these methods runs without the GIL
+        (different instances can parse in parallel in different threads,
+        the calls on the same instance are serialized),
+        the item access of preproc_macro_db and the conversion of the lazy lists
+        (see lazy_ast) take the lock as well
+    :attention: the iteration over preproc_macro_db and the modification of the macro
+        definitions returned from it are not protected by the lock,
+        they must not be done while other thread uses this instance
     """
 
+    # True if the extension is built with HDLCONVERTOR_COMPACT_POSITION
+    # (the stop line/column differs for the multi-line tokens, see hdlConvertor/hdlObjects/position.h)
+    COMPACT_POSITION = Position_COMPACT
+
     cdef unique_ptr[Convertor] thisptr
     cdef HdlContext context
     cdef public CppStdMapProxy preproc_macro_db
+    cdef bool _lazy_ast
+    cdef bool _share_int_values
+    cdef readonly object _lock
 
     # cdef map[string, object] proproc_macro_db;
     def __cinit__(self):
         self.thisptr.reset(new Convertor(self.context))
-        self.preproc_macro_db = CppStdMapProxy.from_ptr(&self.thisptr.get().defineDB)
+        self._lock = Lock()
+        self.preproc_macro_db = CppStdMapProxy.from_ptr(
+            &self.thisptr.get().defineDB, self._lock)
+
+    @property
+    def two_stage_prediction(self):
+        """
+        If True the SV/VHDL parser tries the cheaper SLL prediction first
+        and uses the full LL prediction only for the inputs where SLL fails
+        (the result is the same, only the speed differs)
+        """
+        return self.thisptr.get().prediction == PREDICTION_SLL_LL
+
+    @two_stage_prediction.setter
+    def two_stage_prediction(self, value):
+        if value:
+            self.thisptr.get().prediction = PREDICTION_SLL_LL
+        else:
+            self.thisptr.get().prediction = PREDICTION_LL
+
+    def get_parse_stats(self):
+        """
+        :return: dictionary with the number of parsed inputs ("parsed")
+            and the number of inputs which required fallback from SLL to LL
+            prediction ("sll_fallback")
+        """
+        stats = &self.thisptr.get().stats
+        return {
+            "parsed": stats.parsed_cnt,
+            "sll_fallback": stats.sll_fallback_cnt,
+        }
+
+    def reset_parse_stats(self):
+        self.thisptr.get().stats.reset()
+
+    @property
+    def include_cache_enabled(self):
+        """
+        If True the result of the preprocessing of the included files is reused
+        if the file and the macros used by it did not change
+        and the files with an include guard are skipped if the guard is already defined
+        """
+        return self.thisptr.get().include_cache.enabled
+
+    @include_cache_enabled.setter
+    def include_cache_enabled(self, value):
+        self.thisptr.get().include_cache.enabled = value
+
+    @property
+    def preproc_fast_ifdef_skip(self):
+        """
+        If True the `ifdef/`ifndef blocks in the files are resolved by a character level
+        scanner in the Verilog preprocessor and the inactive branches are skipped
+        without lexing and parsing (the syntax errors in them are not reported)
+        """
+        return self.thisptr.get().preproc_fast_ifdef_skip
+
+    @preproc_fast_ifdef_skip.setter
+    def preproc_fast_ifdef_skip(self, value):
+        self.thisptr.get().preproc_fast_ifdef_skip = value
+
+    @property
+    def preproc_fast_copy(self):
+        """
+        If True the Verilog preprocessor finds the lines with directives and macros
+        by a character level scanner and only these lines are processed by its lexer and parser,
+        the rest of the file is copied to the output as it is
+        """
+        return self.thisptr.get().preproc_fast_copy
+
+    @preproc_fast_copy.setter
+    def preproc_fast_copy(self, value):
+        self.thisptr.get().preproc_fast_copy = value
+
+    @property
+    def preproc_fast_macro_expansion(self):
+        """
+        If True (default) the macro calls in the replacement of other macro
+        are expanded by a string scanner in the Verilog preprocessor if possible,
+        otherwise the preprocessor lexer and parser is used for each nested macro call
+        """
+        return self.thisptr.get().preproc_fast_macro_expansion
+
+    @preproc_fast_macro_expansion.setter
+    def preproc_fast_macro_expansion(self, value):
+        self.thisptr.get().preproc_fast_macro_expansion = value
+
+    @property
+    def ast_arena(self):
+        """
+        If True the objects of the parsed AST are allocated in large memory blocks
+        owned by the HdlContext of this HdlConvertor (faster allocation and deallocation
+        of the large ASTs), the result of the parsing is the same
+        """
+        return self.thisptr.get().ast_arena
+
+    @ast_arena.setter
+    def ast_arena(self, value):
+        self.thisptr.get().ast_arena = value
+
+    @property
+    def lazy_ast(self):
+        """
+        If True the bodies of the modules, namespaces and functions in the result
+        of the parsing are converted to Python objects only when they are accessed
+        (the module names, ports and params are converted immediately),
+        the objects are the same as if converted immediately
+        """
+        return self._lazy_ast
+
+    @lazy_ast.setter
+    def lazy_ast(self, value):
+        self._lazy_ast = value
+
+    @property
+    def share_int_values(self):
+        """
+        If True all occurrences of the same integer value (not bitstring) with the same width
+        in the result of the parsing share a single HdlIntValue instance
+        (less memory and faster conversion, but the instance must not be modified in place)
+        """
+        return self._share_int_values
+
+    @share_int_values.setter
+    def share_int_values(self, value):
+        self._share_int_values = value
+
+    def get_include_cache_stats(self):
+        """
+        :return: dictionary with the number of includes resolved from the cache ("hit")
+            the number of includes which had to be preprocessed ("miss")
+            and the number of includes skipped because of the include guard ("guard_skip")
+        """
+        c = &self.thisptr.get().include_cache
+        return {
+            "hit": c.get_hit_cnt(),
+            "miss": c.get_miss_cnt(),
+            "guard_skip": c.get_guard_skip_cnt(),
+        }
+
+    def clear_include_cache(self):
+        self.thisptr.get().include_cache.clear()
+
+    @property
+    def parse_cache_dir(self):
+        """
+        The directory where the ASTs of the parsed inputs are stored in the binary AST format
+        (see save_ast), if the same input is parsed again (by any HdlConvertor or process
+        which uses this directory) the AST is loaded from it instead of parsing,
+        the key of the entry is the hash of the preprocessed input, its source map,
+        the language and the hierarchyOnly flag (None = cache disabled, default)
+        """
+        d = self.thisptr.get().parse_cache.dir
+        if d.empty():
+            return None
+        return str_decode(d)
+
+    @parse_cache_dir.setter
+    def parse_cache_dir(self, value):
+        with self._lock:
+            if value is None:
+                self.thisptr.get().parse_cache.dir = b""
+            else:
+                self.thisptr.get().parse_cache.dir = str_encode(value)
+
+    def get_parse_cache_stats(self):
+        """
+        :return: dictionary with the number of inputs loaded from the parse cache ("hit")
+            and the number of inputs which had to be parsed ("miss")
+        """
+        c = &self.thisptr.get().parse_cache
+        return {
+            "hit": c.get_hit_cnt(),
+            "miss": c.get_miss_cnt(),
+        }
+
+    def reset_parse_cache_stats(self):
+        self.thisptr.get().parse_cache.reset_stats()
 
     @staticmethod
     def _translate_Language_enum(langue):
@@ -122,7 +421,7 @@ cdef class HdlConvertor:
             raise ValueError(repr(lang) + " is not recognized"
                              " (expected hdlConvertor.language.Language value)")
 
-    def parse(self, filenames, langue, incdirs, hierarchyOnly=False, debug=True):
+    def parse(self, filenames, langue, incdirs, hierarchyOnly=False, debug=True, jobs=1):
         """
         :param filenames: sequence of filenames or filename
         :type filename: Union[str, List[str]]
@@ -130,6 +429,9 @@ cdef class HdlConvertor:
         :param incdirs: list of include directories
         :param hierarchyOnly: if True only names of components and modules are parsed
         :param debug: if True the debug logging is enabled
+        :param jobs: number of threads used to parse the files
+            (0 = number of CPUs), the order of objects in result
+            is the same as if the files were parsed sequentially
         :return: HdlContext instance
         """
         langue_value = self._translate_Language_enum(langue)
@@ -143,12 +445,29 @@ cdef class HdlConvertor:
         cdef object d_py
         cdef PyObject * d
         cdef ToPy toPy
+        cdef vector[string] _filenames
+        cdef vector[string] _incdirs
+        cdef Language _langue
+        cdef bool _hierarchyOnly
+        cdef bool _debug
+        cdef size_t _jobs
         if filenames:
-            self.thisptr.get().parse(
-                filenames, langue_value, incdirs, hierarchyOnly, debug)
-
-            toPy = ToPy()
-            d = toPy.toPy(&self.context)
+            _filenames = filenames
+            _incdirs = incdirs
+            _langue = langue_value
+            _hierarchyOnly = hierarchyOnly
+            _debug = debug
+            _jobs = jobs
+            with self._lock:
+                with nogil:
+                    self.thisptr.get().parse(
+                        _filenames, _langue, _incdirs, _hierarchyOnly, _debug, _jobs)
+
+                if self._lazy_ast:
+                    toPy.lazy_objs_factory = LazyObjList_new
+                    toPy.lazy_objs_owner = <void *> self
+                toPy.share_int_values = self._share_int_values
+                d = toPy.toPy(&self.context)
             if not d:
                 raise
             d_py = < object > d
@@ -156,6 +475,38 @@ cdef class HdlConvertor:
         else:
             return PyHdlContext()
 
+    def warmup_dfa(self, filenames, langue, incdirs):
+        """
+        Parse the representative files and discard the result,
+        this fills the prediction cache (DFA) of the parser
+        which is shared by all parsers in this process
+        and significantly speeds up the parsing of the similar code later
+
+        :param filenames: sequence of filenames or filename
+        :type filename: Union[str, List[str]]
+        :param langue: hdlConvertor.language.Language enum value
+        :param incdirs: list of include directories
+        :return: number of DFA states of the parser after warm up
+        :note: the DFA lives only in this process, it can not be stored to a file
+            (see Convertor::warmup_dfa)
+        """
+        langue_value = self._translate_Language_enum(langue)
+
+        if isinstance(filenames, string_type):
+            filenames = [filenames, ]
+
+        filenames = [str_encode(item) for item in filenames]
+        incdirs = [str_encode(item) for item in incdirs]
+        cdef vector[string] _filenames = filenames
+        cdef vector[string] _incdirs = incdirs
+        cdef Language _langue = langue_value
+        cdef size_t dfa_state_cnt
+        with self._lock:
+            with nogil:
+                self.thisptr.get().warmup_dfa(_filenames, _langue, _incdirs)
+                dfa_state_cnt = Convertor.get_dfa_state_cnt(_langue)
+        return dfa_state_cnt
+
     def parse_str(self, hdl_str, langue, incdirs, hierarchyOnly=False, debug=True):
         """
         :param hdl_str: HDL string to parse
@@ -174,12 +525,27 @@ cdef class HdlConvertor:
         cdef object d_py
         cdef PyObject * d
         cdef ToPy toPy
+        cdef string _hdl_str
+        cdef vector[string] _incdirs
+        cdef Language _langue
+        cdef bool _hierarchyOnly
+        cdef bool _debug
         if hdl_str:
-            self.thisptr.get().parse_str(
-                hdl_str, langue_value, incdirs, hierarchyOnly, debug)
-
-            toPy = ToPy()
-            d = toPy.toPy(&self.context)
+            _hdl_str = hdl_str
+            _incdirs = incdirs
+            _langue = langue_value
+            _hierarchyOnly = hierarchyOnly
+            _debug = debug
+            with self._lock:
+                with nogil:
+                    self.thisptr.get().parse_str(
+                        _hdl_str, _langue, _incdirs, _hierarchyOnly, _debug)
+
+                if self._lazy_ast:
+                    toPy.lazy_objs_factory = LazyObjList_new
+                    toPy.lazy_objs_owner = <void *> self
+                toPy.share_int_values = self._share_int_values
+                d = toPy.toPy(&self.context)
             if not d:
                 raise
             d_py = < object > d
@@ -187,20 +553,93 @@ cdef class HdlConvertor:
         else:
             return PyHdlContext()
 
-    def verilog_pp(self, filename, lang, incdirs=['.']):
+    def save_ast(self, filename):
+        """
+        Store the AST of this instance in to a file in the binary format
+        which can be memory mapped by the hdlConvertor::HdlAstBinaryFile
+        (include/hdlConvertor/hdlAstBinary.h) or loaded by load_ast
+
+        :type filename: str
+        :note: the AST contains the objects from all previous calls of parse/parse_str/load_ast
+            on this instance (the same objects as in the HdlContext returned by the last call)
+        """
+        filename = str_encode(filename)
+        cdef string _filename = filename
+        cdef HdlAstBinaryWriter w
+        with self._lock:
+            with nogil:
+                w.write(self.context, _filename)
+
+    def load_ast(self, filename):
+        """
+        Load the AST stored by save_ast and append its objects to the AST of this instance
+        (the result is the same as if the code was parsed by this instance)
+
+        :type filename: str
+        :return: HdlContext instance
+        :raise RuntimeError: if the file can not be read or it is not a valid binary AST file
+            (the AST of this instance is not modified)
+        """
+        filename = str_encode(filename)
+        cdef string _filename = filename
+        cdef object d_py
+        cdef PyObject * d
+        cdef ToPy toPy
+        with self._lock:
+            with nogil:
+                self.thisptr.get().load_ast(_filename)
+
+            if self._lazy_ast:
+                toPy.lazy_objs_factory = LazyObjList_new
+                toPy.lazy_objs_owner = <void *> self
+            toPy.share_int_values = self._share_int_values
+            d = toPy.toPy(&self.context)
+        if not d:
+            raise
+        d_py = < object > d
+        return d_py
+
+    def verilog_pp(self, filename, lang, incdirs=['.'], output_callback=None):
         """
         Execute Verilog preprocessor
 
         :type filename: Union[str, List[str]]
+        :param output_callback: if specified the output is not collected,
+            the callable is called with each chunk of the output (str) as it is produced
+            (the exception raised by the callable stops the preprocessor and it is propagated),
+            the callable runs with the lock of this instance held and it must not use
+            this instance (including preproc_macro_db and the lazy lists of the results)
+        :type output_callback: Optional[Callable[[str], None]]
         :return: string output from verilog preprocessor
+            (None if the output_callback is specified)
         """
         langue_value = self._translate_verilog_enum(lang)
 
         filename = str_encode(filename)
         incdirs = [str_encode(item) for item in incdirs]
 
-        data = self.thisptr.get().verilog_pp(filename, incdirs, langue_value)
-        data = str_decode(data)
+        cdef string _filename = filename
+        cdef vector[string] _incdirs = incdirs
+        cdef Language _langue = langue_value
+        cdef string _data
+        cdef unique_ptr[PyPreprocOutputSink] sink
+        if output_callback is not None:
+            sink.reset(new PyPreprocOutputSink(<PyObject *> output_callback))
+            with self._lock:
+                try:
+                    with nogil:
+                        self.thisptr.get().verilog_pp(_filename, _incdirs, _langue,
+                                                      deref(sink.get()))
+                except ParseException:
+                    # the exception from the callback has the priority
+                    sink.get().raise_error()
+                    raise
+            return None
+
+        with self._lock:
+            with nogil:
+                _data = self.thisptr.get().verilog_pp(_filename, _incdirs, _langue)
+        data = str_decode(_data)
 
         return data
 
@@ -215,7 +654,13 @@ cdef class HdlConvertor:
         verilog_str = str_encode(verilog_str)
         incdirs = [str_encode(item) for item in incdirs]
 
-        data = self.thisptr.get().verilog_pp_str(verilog_str, incdirs, langue_value)
-        data = str_decode(data)
+        cdef string _verilog_str = verilog_str
+        cdef vector[string] _incdirs = incdirs
+        cdef Language _langue = langue_value
+        cdef string _data
+        with self._lock:
+            with nogil:
+                _data = self.thisptr.get().verilog_pp_str(_verilog_str, _incdirs, _langue)
+        data = str_decode(_data)
 
         return data
@@ -1,5 +1,6 @@
-from typing import Union, List
+from typing import Union, List, Optional
 from hdlConvertor.hdlAst._expr import HdlName
+from hdlConvertor.hdlAst.utils import CodePosition
 
 
 class iHdlObj(object):
@@ -7,11 +8,13 @@ class iHdlObj(object):
     Object with direct representation in HDL
 
     :ivar doc: doc from the HDL related probably to this object
+    :ivar position: the position of the object in the code (None if not known)
     """
-    __slots__ = ["doc"]
+    __slots__ = ["doc", "position"]
 
     def __init__(self):
         self.doc = ""  # type: str
+        self.position = None  # type: Optional[CodePosition]
 
 
 class iHdlObjWithName(iHdlObj):
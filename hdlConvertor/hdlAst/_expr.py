@@ -183,6 +183,9 @@ class HdlIntValue(object):
     :ivar val: int value or bitstring string
     :ivar bits: number of bits if specified
     :ivar base: base for bitstring
+    :attention: if HdlConvertor.share_int_values is set the parser returns
+        the same instance for all occurrences of the same int value (not bitstring)
+        in the converted code, the instance should not be modified in place
     """
     __slots__ = ["val", "bits", "base"]
 
@@ -1,10 +1,20 @@
+from typing import Optional
 
 
 class CodePosition(object):
-    __slots__ = ["startLine", "stopLine", "startColumn", "stopColumn"]
+    """
+    The position of the object in the code
+    (the lines and columns are 1-based and the stop is inclusive)
 
-    def __init__(self, startLine, stopLine, startColumn, stopColumn):
+    :ivar file: the file where the object was defined (resolved from the source
+        map of the Verilog preprocessor, the lines are in the coordinates of this file,
+        None if not known)
+    """
+    __slots__ = ["startLine", "stopLine", "startColumn", "stopColumn", "file"]
+
+    def __init__(self, startLine, stopLine, startColumn, stopColumn, file=None):
         self.startLine = startLine  # type: int
         self.stopLine = stopLine  # type: int
         self.startColumn = startColumn  # type: int
         self.stopColumn = stopColumn  # type: int
+        self.file = file  # type: Optional[str]
@@ -0,0 +1,108 @@
+from hdlConvertor.hdlAst import HdlBuiltinFn
+
+
+# the names of the values without data (HdlValueType_toString)
+_HDL_EXPR_TREE_VALUE_TYPES = {
+    "NULL": symb_NULL,
+    "OPEN": symb_OPEN,
+    "ALL": symb_ALL,
+    "OTHERS": symb_OTHERS,
+    "T": symb_T,
+    "AUTO": symb_AUTO,
+}
+# HdlBuiltinFn name -> HdlOperatorType (resolved on first use)
+_HDL_EXPR_TREE_OPS = {}
+
+
+cdef HdlOperatorType _HdlExprTree_op(fn) except *:
+    if not _HDL_EXPR_TREE_OPS:
+        for i in range(<int> ARITH_SHIFT_RIGHT_ASSIGN + 1):
+            name = HdlOperatorType_toString(<HdlOperatorType> i).decode()
+            _HDL_EXPR_TREE_OPS[name] = i
+    return <HdlOperatorType> <int> _HDL_EXPR_TREE_OPS[HdlBuiltinFn(fn).name]
+
+
+cdef class HdlExprTree:
+    """
+    The flat representation of the expressions (hdlConvertor::hdlObjects::HdlExprTree)
+    which is used by the conversion of the expressions to Python
+
+    The nodes are identified by the int returned from the add_* methods,
+    the operands have to be added before the node which uses them,
+    a node can be an operand of multiple nodes.
+    """
+    cdef unique_ptr[CppHdlExprTree] thisptr
+
+    def __cinit__(self):
+        self.thisptr.reset(new CppHdlExprTree(True))
+
+    def __len__(self):
+        return self.thisptr.get().size()
+
+    def add_none(self):
+        return self.thisptr.get().add_none()
+
+    def add_value(self, value_type):
+        """
+        :param value_type: the name of the value without data
+            ("NULL", "OPEN", "ALL", "OTHERS", "T", "AUTO")
+        """
+        return self.thisptr.get().add_value(_HDL_EXPR_TREE_VALUE_TYPES[value_type])
+
+    def add_id(self, name):
+        return self.thisptr.get().add_id(str_encode(name))
+
+    def add_str(self, s):
+        return self.thisptr.get().add_str(str_encode(s))
+
+    def add_int(self, int64_t val, int bits=-1):
+        return self.thisptr.get().add_int(BigInteger(val), bits)
+
+    def add_float(self, double val):
+        return self.thisptr.get().add_float(val)
+
+    def add_array(self, items):
+        cdef vector[uint32_t] _items = items
+        return self.thisptr.get().add_array(_items)
+
+    def add_call(self, fn, args):
+        """
+        :type fn: HdlBuiltinFn
+        """
+        cdef vector[uint32_t] _args = args
+        return self.thisptr.get().add_call(_HdlExprTree_op(fn), _args)
+
+    def _root(self, n):
+        if n is None:
+            if not self.thisptr.get().size():
+                raise IndexError("HdlExprTree is empty")
+            return self.thisptr.get().root()
+        return n
+
+    def to_py(self, n=None, share_int_values=False):
+        """
+        Convert the expression of the node to the hdlConvertor.hdlAst objects
+        (a node shared by multiple nodes is converted to a single object)
+
+        :param n: the node (None = the last added node)
+        :param share_int_values: see HdlConvertor.share_int_values
+        """
+        cdef ToPy toPy
+        cdef uint32_t _n = self._root(n)
+        toPy.share_int_values = share_int_values
+        o = toPy.toPy(deref(self.thisptr.get()), _n)
+        res = <object> o
+        Py_DECREF(res)
+        return res
+
+    def rebuild(self, n=None):
+        """
+        :return: a new HdlExprTree with the expression of the node rebuilt to the pointer
+            based iHdlExpr (HdlExprTree::to_expr) and flattened again
+            (the shared nodes are copied for each of their users)
+        """
+        cdef uint32_t _n = self._root(n)
+        cdef unique_ptr[iHdlExpr] e = self.thisptr.get().to_expr(_n)
+        cdef HdlExprTree res = HdlExprTree()
+        res.thisptr.get().append(e.get())
+        return res
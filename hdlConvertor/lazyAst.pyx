@@ -0,0 +1,169 @@
+from cpython.ref cimport Py_INCREF, Py_DECREF
+
+
+cdef class LazyObjList(list):
+    """
+    The list of the objects from the body of the module/namespace/function
+    which are converted from the C++ AST only when the list is accessed
+    for the first time (see HdlConvertor.lazy_ast),
+    after that it behaves as a normal list
+
+    :ivar _owner: the HdlConvertor which owns the C++ objects
+        (its lock is held during the conversion)
+    :ivar _objs: the C++ objects which are not converted yet (NULL after conversion)
+    :note: len() does not convert the objects
+    :attention: the C code which accesses the list storage directly
+        (e.g. PySequence_Fast) sees the list empty until it is accessed from Python
+    """
+    cdef object _owner
+    cdef vector[unique_ptr[iHdlObj]] * _objs
+
+    cdef int _convert(self) except -1:
+        cdef ToPy toPy
+        cdef PyObject * o
+        cdef vector[unique_ptr[iHdlObj]] * objs = self._objs
+        if objs == NULL:
+            return 0
+        # the nested bodies are converted lazily as well
+        toPy.lazy_objs_factory = LazyObjList_new
+        toPy.lazy_objs_owner = <void *> self._owner
+        toPy.share_int_values = self._owner.share_int_values
+        res = []
+        with self._owner._lock:
+            for i in range(objs.size()):
+                o = toPy.toPy(<const iHdlObj *> deref(objs)[i].get())
+                res.append(<object> o)
+                Py_DECREF(<object> o)
+        self._objs = NULL
+        self._owner = None
+        list.extend(self, res)
+        return 0
+
+    def __len__(self):
+        if self._objs != NULL:
+            return self._objs.size()
+        return list.__len__(self)
+
+    def __getitem__(self, i):
+        self._convert()
+        return list.__getitem__(self, i)
+
+    def __setitem__(self, i, v):
+        self._convert()
+        list.__setitem__(self, i, v)
+
+    def __delitem__(self, i):
+        self._convert()
+        list.__delitem__(self, i)
+
+    def __iter__(self):
+        self._convert()
+        return list.__iter__(self)
+
+    def __reversed__(self):
+        self._convert()
+        return list.__reversed__(self)
+
+    def __contains__(self, v):
+        self._convert()
+        return list.__contains__(self, v)
+
+    def __richcmp__(self, other, int op):
+        self._convert()
+        if isinstance(other, LazyObjList):
+            (<LazyObjList> other)._convert()
+        if op == 0:
+            return list.__lt__(self, other)
+        elif op == 1:
+            return list.__le__(self, other)
+        elif op == 2:
+            return list.__eq__(self, other)
+        elif op == 3:
+            return list.__ne__(self, other)
+        elif op == 4:
+            return list.__gt__(self, other)
+        else:
+            return list.__ge__(self, other)
+
+    def __repr__(self):
+        self._convert()
+        return list.__repr__(self)
+
+    def __add__(self, other):
+        self._convert()
+        return list(self) + other
+
+    def __radd__(self, other):
+        # called instead of list.__add__ of other list which would see this list empty
+        self._convert()
+        return other + list(self)
+
+    def __mul__(self, n):
+        self._convert()
+        return list(self) * n
+
+    def __rmul__(self, n):
+        self._convert()
+        return list(self) * n
+
+    def __iadd__(self, other):
+        self._convert()
+        list.extend(self, other)
+        return self
+
+    def __reduce__(self):
+        self._convert()
+        return (list, (list(self),))
+
+    def append(self, v):
+        self._convert()
+        list.append(self, v)
+
+    def extend(self, v):
+        self._convert()
+        list.extend(self, v)
+
+    def insert(self, i, v):
+        self._convert()
+        list.insert(self, i, v)
+
+    def remove(self, v):
+        self._convert()
+        list.remove(self, v)
+
+    def pop(self, i=-1):
+        self._convert()
+        return list.pop(self, i)
+
+    def clear(self):
+        self._objs = NULL
+        self._owner = None
+        list.clear(self)
+
+    def index(self, *args):
+        self._convert()
+        return list.index(self, *args)
+
+    def count(self, v):
+        self._convert()
+        return list.count(self, v)
+
+    def sort(self, *args, **kwargs):
+        self._convert()
+        list.sort(self, *args, **kwargs)
+
+    def reverse(self):
+        self._convert()
+        list.reverse(self)
+
+    def copy(self):
+        self._convert()
+        return list(self)
+
+
+cdef PyObject * LazyObjList_new(const vector[unique_ptr[iHdlObj]] * objs, void * owner) except NULL:
+    cdef LazyObjList l = LazyObjList.__new__(LazyObjList)
+    l._owner = <object> owner
+    l._objs = <vector[unique_ptr[iHdlObj]] *> objs
+    Py_INCREF(l)
+    return <PyObject *> l
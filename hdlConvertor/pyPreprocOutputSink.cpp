@@ -0,0 +1,55 @@
+#include "pyPreprocOutputSink.h"
+
+#include <stdexcept>
+
+namespace hdlConvertor {
+
+PyPreprocOutputSink::PyPreprocOutputSink(PyObject *callback) :
+		callback(callback), error_type(nullptr), error_value(nullptr), error_tb(
+				nullptr) {
+}
+
+void PyPreprocOutputSink::write(std::string_view data) {
+	if (data.empty())
+		return;
+	PyGILState_STATE gil = PyGILState_Ensure();
+	bool ok = false;
+	if (!error_type) {
+		PyObject *py_data = PyUnicode_DecodeUTF8(data.data(), data.size(),
+				nullptr);
+		if (py_data) {
+			PyObject *res = PyObject_CallFunctionObjArgs(callback, py_data,
+					nullptr);
+			Py_DECREF(py_data);
+			if (res) {
+				Py_DECREF(res);
+				ok = true;
+			}
+		}
+		if (!ok)
+			PyErr_Fetch(&error_type, &error_value, &error_tb);
+	}
+	PyGILState_Release(gil);
+	if (!ok)
+		throw std::runtime_error("the preprocessor output callback failed");
+}
+
+int PyPreprocOutputSink::raise_error() {
+	if (!error_type)
+		return 0;
+	PyErr_Restore(error_type, error_value, error_tb);
+	error_type = error_value = error_tb = nullptr;
+	return -1;
+}
+
+PyPreprocOutputSink::~PyPreprocOutputSink() {
+	if (error_type) {
+		PyGILState_STATE gil = PyGILState_Ensure();
+		Py_XDECREF(error_type);
+		Py_XDECREF(error_value);
+		Py_XDECREF(error_tb);
+		PyGILState_Release(gil);
+	}
+}
+
+}
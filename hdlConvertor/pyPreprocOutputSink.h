@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Python.h>
+#include <string_view>
+
+#include <hdlConvertor/sourceMap.h>
+
+namespace hdlConvertor {
+
+/*
+ * The sink of the preprocessor output which passes each chunk of the output
+ * as str to the Python callable (the preprocessor runs without the GIL,
+ * the GIL is acquired only for the call of the callable)
+ *
+ * :ivar callback: the Python callable (borrowed reference, has to live as long as this sink)
+ * :ivar error_type: the exception raised by the callable (together with error_value and error_tb),
+ * 		the preprocessing is stopped by a C++ exception and the Python exception is raised
+ * 		again by raise_error() after the preprocessor returns
+ * :note: the chunks are the texts of the preprocessor tokens or the whole lines,
+ * 		they never split a UTF-8 character
+ * */
+class PyPreprocOutputSink: public PreprocOutputSink {
+public:
+	PyObject *callback;
+	PyObject *error_type;
+	PyObject *error_value;
+	PyObject *error_tb;
+
+	PyPreprocOutputSink(PyObject *callback);
+	PyPreprocOutputSink(const PyPreprocOutputSink &other) = delete;
+	PyPreprocOutputSink& operator=(const PyPreprocOutputSink &other) = delete;
+
+	virtual void write(std::string_view data) override;
+	/*
+	 * Set the exception raised by the callable as the current Python exception
+	 *
+	 * :return: -1 if there was an exception, 0 otherwise
+	 * */
+	int raise_error();
+	virtual ~PyPreprocOutputSink();
+};
+
+}
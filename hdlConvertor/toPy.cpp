@@ -12,13 +12,16 @@
 #include <hdlConvertor/hdlObjects/bigInteger.h>
 #include <hdlConvertor/hdlObjects/hdlDirection.h>
 #include <hdlConvertor/hdlObjects/hdlValue.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 #include <hdlConvertor/conversion_exception.h>
 
 namespace hdlConvertor {
 
 using namespace hdlObjects;
 
-ToPy::ToPy() {
+ToPy::ToPy() :
+		lazy_objs_factory(nullptr), lazy_objs_owner(nullptr), share_int_values(
+				false) {
 	hdlAst_module = PyImport_ImportModule("hdlConvertor.hdlAst");
 	if (hdlAst_module == nullptr) {
 		// this could happen only if there are missing files in library
@@ -77,9 +80,213 @@ std::string ToPy::PyObject_repr(PyObject *o) {
 	return ret;
 }
 
+PyObject* ToPy::attr_name(const char *name) {
+	auto &py_name = attr_name_cache[name];
+	if (!py_name)
+		py_name = PyUnicode_InternFromString(name);
+	return py_name;
+}
+
+int ToPy::set_attr(PyObject *py_inst, const char *name, PyObject *value) {
+	auto py_name = attr_name(name);
+	if (!py_name) {
+		Py_DECREF(value);
+		Py_DECREF(py_inst);
+		return -1;
+	}
+	int e = PyObject_SetAttr(py_inst, py_name, value);
+	Py_DECREF(value);
+	if (e < 0) {
+		Py_DECREF(py_inst);
+		return -1;
+	}
+	return 0;
+}
+
+// :return: true if the value of the slot can be shared between the instances
+static bool is_immutable_default(PyObject *v) {
+	return v == nullptr || v == Py_None || PyBool_Check(v)
+			|| PyLong_CheckExact(v) || PyFloat_CheckExact(v)
+			|| PyUnicode_CheckExact(v);
+}
+
+/*
+ * Resolve the names of the __slots__ of the class and its bases and their values
+ * in the prototype
+ *
+ * :return: false if the class is not compatible with ToPy::new_inst
+ * */
+static bool resolve_slots(PyTypeObject *t, PyObject *prototype,
+		std::vector<ToPySlot> &slots) {
+	auto mro = t->tp_mro;
+	if (!mro)
+		return false;
+	for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(mro); i++) {
+		auto base = reinterpret_cast<PyTypeObject*>(PyTuple_GET_ITEM(mro, i));
+		if (base == &PyBaseObject_Type)
+			continue;
+		PyObject *base_slots = base->tp_dict ?
+				PyDict_GetItemString(base->tp_dict, "__slots__") : nullptr;
+		if (!base_slots)
+			return false;
+		PyObject *names;
+		if (PyUnicode_Check(base_slots))
+			names = PyTuple_Pack(1, base_slots);
+		else
+			names = PySequence_Tuple(base_slots);
+		if (!names) {
+			PyErr_Clear();
+			return false;
+		}
+		for (Py_ssize_t n_i = 0; n_i < PyTuple_GET_SIZE(names); n_i++) {
+			PyObject *name = PyTuple_GET_ITEM(names, n_i);
+			if (!PyUnicode_Check(name)) {
+				Py_DECREF(names);
+				return false;
+			}
+			if (PyUnicode_CompareWithASCIIString(name, "__weakref__") == 0)
+				continue;
+			if (PyUnicode_GET_LENGTH(name) > 2
+					&& PyUnicode_READ_CHAR(name, 0) == '_'
+					&& PyUnicode_READ_CHAR(name, 1) == '_') {
+				// the name is mangled (or it is __dict__)
+				Py_DECREF(names);
+				return false;
+			}
+			PyObject *v = PyObject_GetAttr(prototype, name);
+			if (!v) {
+				if (!PyErr_ExceptionMatches(PyExc_AttributeError)) {
+					PyErr_Clear();
+					Py_DECREF(names);
+					return false;
+				}
+				// the slot is not set by __init__
+				PyErr_Clear();
+				continue;
+			}
+			bool is_list = PyList_CheckExact(v);
+			if (is_list ? PyList_GET_SIZE(v) != 0 : !is_immutable_default(v)) {
+				Py_DECREF(v);
+				Py_DECREF(names);
+				return false;
+			}
+			if (is_list) {
+				Py_DECREF(v);
+				v = nullptr;
+			}
+			Py_INCREF(name);
+			slots.push_back( { name, v });
+		}
+		Py_DECREF(names);
+	}
+	return true;
+}
+
+PyObject* ToPy::new_inst(PyObject *cls) {
+	auto _info = cls_info_cache.find(cls);
+	if (_info == cls_info_cache.end()) {
+		// resolve the slots of the class and their default values from the instance created by __init__
+		PyObject *prototype = PyObject_CallObject(cls, NULL);
+		if (!prototype)
+			return nullptr;
+		ToPyClsInfo info;
+		info.prototype = prototype;
+		auto t = reinterpret_cast<PyTypeObject*>(cls);
+		if (!PyType_Check(cls) || t->tp_new != PyBaseObject_Type.tp_new
+				|| t->tp_dictoffset != 0 || !resolve_slots(t, prototype, info.slots)) {
+			// the instance has __dict__, custom __new__ or non-trivial defaults
+			info.prototype = nullptr;
+			Py_DECREF(prototype);
+			info.release_slots();
+		}
+		_info = cls_info_cache.insert( { cls, std::move(info) }).first;
+	}
+	auto &info = _info->second;
+	if (!info.prototype)
+		return PyObject_CallObject(cls, NULL);
+
+	auto t = reinterpret_cast<PyTypeObject*>(cls);
+	PyObject *py_inst = t->tp_alloc(t, 0);
+	if (!py_inst)
+		return nullptr;
+	for (auto &s : info.slots) {
+		PyObject *v = s.value;
+		if (v) {
+			Py_INCREF(v);
+		} else {
+			v = PyList_New(0);
+			if (!v) {
+				Py_DECREF(py_inst);
+				return nullptr;
+			}
+		}
+		int e = PyObject_SetAttr(py_inst, s.name, v);
+		Py_DECREF(v);
+		if (e < 0) {
+			Py_DECREF(py_inst);
+			return nullptr;
+		}
+	}
+	return py_inst;
+}
+
+PyObject* ToPy::call(PyObject *callable, PyObject *const*args, size_t nargs) {
+#if PY_VERSION_HEX >= 0x03090000
+	return PyObject_Vectorcall(callable, args, nargs, nullptr);
+#elif PY_VERSION_HEX >= 0x03080000
+	return _PyObject_Vectorcall(callable, args, nargs, nullptr);
+#else
+	PyObject *py_args = PyTuple_New(nargs);
+	if (!py_args)
+		return nullptr;
+	for (size_t i = 0; i < nargs; i++) {
+		Py_INCREF(args[i]);
+		PyTuple_SET_ITEM(py_args, i, args[i]);
+	}
+	auto res = PyObject_Call(callable, py_args, nullptr);
+	Py_DECREF(py_args);
+	return res;
+#endif
+}
+
+int ToPy::toPy_objs(PyObject *py_inst, const char *prop_name,
+		const std::vector<std::unique_ptr<iHdlObj>> &objs) {
+	if (lazy_objs_factory == nullptr || objs.empty())
+		return toPy_arr(py_inst, prop_name, objs);
+	auto py_objs = lazy_objs_factory(&objs, lazy_objs_owner);
+	if (!py_objs) {
+		Py_DECREF(py_inst);
+		return -1;
+	}
+	return set_attr(py_inst, prop_name, py_objs);
+}
+
+/*
+ * Disable the cyclic garbage collector for the lifetime of this object
+ * (the conversion creates a large number of the objects without reference cycles
+ * and the collections triggered by the allocations would be only a wasted time)
+ * */
+class ToPyGcDisable {
+	bool was_enabled;
+public:
+	ToPyGcDisable() {
+#if PY_VERSION_HEX >= 0x030A0000
+		was_enabled = PyGC_Disable();
+#else
+		was_enabled = false;
+#endif
+	}
+	~ToPyGcDisable() {
+#if PY_VERSION_HEX >= 0x030A0000
+		if (was_enabled)
+			PyGC_Enable();
+#endif
+	}
+};
+
 PyObject* ToPy::toPy(const HdlContext *o) {
-	Py_INCREF(ContextCls);
-	PyObject *py_inst = PyObject_CallObject(ContextCls, NULL);
+	ToPyGcDisable _gc;
+	PyObject *py_inst = new_inst(ContextCls);
 	if (!py_inst)
 		return nullptr;
 	if (toPy_arr(py_inst, "objs", o->objs)) {
@@ -89,7 +296,7 @@ PyObject* ToPy::toPy(const HdlContext *o) {
 }
 
 PyObject* ToPy::toPy(const HdlLibrary *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlLibraryCls, NULL);
+	PyObject *py_inst = new_inst(HdlLibraryCls);
 	if (!py_inst)
 		return nullptr;
 	if (toPy(static_cast<const WithNameAndDoc*>(o), py_inst))
@@ -98,45 +305,13 @@ PyObject* ToPy::toPy(const HdlLibrary *o) {
 }
 
 PyObject* ToPy::toPy(const iHdlObj *o) {
-	auto c = dynamic_cast<const HdlContext*>(o);
-	if (c)
-		return toPy(c);
-	auto lib = dynamic_cast<const HdlLibrary*>(o);
-	if (lib)
-		return toPy(lib);
-	auto md = dynamic_cast<const HdlModuleDec*>(o);
-	if (md)
-		return toPy(md);
-	auto ex = dynamic_cast<const iHdlExpr*>(o);
-	if (ex)
-		return toPy(ex);
-	auto v = dynamic_cast<const HdlVariableDef*>(o);
-	if (v)
-		return toPy(v);
-	auto s = dynamic_cast<const iHdlStatement*>(o);
-	if (s)
-		return toPy(s);
-	auto mdef = dynamic_cast<const HdlModuleDef*>(o);
-	if (mdef)
-		return toPy(mdef);
-	auto ci = dynamic_cast<const HdlCompInstance*>(o);
-	if (ci)
-		return toPy(ci);
-	auto ns = dynamic_cast<const HdlNamespace*>(o);
-	if (ns)
-		return toPy(ns);
-	auto fn = dynamic_cast<const HdlFunctionDef*>(o);
-	if (fn)
-		return toPy(fn);
-
-	std::string err_msg;
-	if (o)
-		err_msg = std::string("ToPy::toPy unknown type of iHdlObj:")
-				+ std::string(typeid(*o).name());
-	else
-		err_msg = "ToPy::toPy called for nullptr";
-	PyErr_SetString(PyExc_ValueError, err_msg.c_str());
-	return nullptr;
+	if (!o) {
+		PyErr_SetString(PyExc_ValueError, "ToPy::toPy called for nullptr");
+		return nullptr;
+	}
+	return visit_iHdlObj(*o, [this](auto *obj) {
+		return toPy(obj);
+	});
 }
 
 int ToPy::toPy(const WithNameAndDoc *o, PyObject *py_inst) {
@@ -151,6 +326,9 @@ int ToPy::toPy(const WithNameAndDoc *o, PyObject *py_inst) {
 			return -1;
 	}
 	e = toPy(static_cast<const WithDoc*>(o), py_inst);
+	if (e < 0)
+		return e;
+	e = toPy(static_cast<const WithPos*>(o), py_inst);
 	if (e < 0)
 		return e;
 	return 0;
@@ -163,8 +341,39 @@ int ToPy::toPy(const WithDoc *o, PyObject *py_inst) {
 	return 0;
 }
 
+int ToPy::toPy(const WithPos *o, PyObject *py_inst) {
+	if (o->position.isKnown())
+		if (toPy_property(py_inst, "position", o->position))
+			return -1;
+	return 0;
+}
+
+PyObject* ToPy::toPy(const Position &o) {
+	PyObject *file = Py_None;
+	auto f = o.get_file();
+	if (f) {
+		// all positions from the same file share the same str
+		auto &py_f = file_cache[f.get()];
+		if (!py_f) {
+			py_f = toPy(*f);
+			if (!py_f)
+				return nullptr;
+		}
+		file = py_f;
+	}
+	PyObject *args[] = { PyLong_FromSize_t(o.get_start_line()), PyLong_FromSize_t(
+			o.get_stop_line()), PyLong_FromSize_t(o.get_start_column()),
+			PyLong_FromSize_t(o.get_stop_column()), file };
+	PyObject *res = nullptr;
+	if (args[0] && args[1] && args[2] && args[3])
+		res = call(CodePositionCls, args, 5);
+	for (size_t i = 0; i < 4; i++)
+		Py_XDECREF(args[i]);
+	return res;
+}
+
 PyObject* ToPy::toPy(const HdlModuleDef *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlModuleDefCls, NULL);
+	PyObject *py_inst = new_inst(HdlModuleDefCls);
 	if (py_inst == nullptr)
 		return nullptr;
 	if (toPy(static_cast<const WithNameAndDoc*>(o), py_inst))
@@ -173,18 +382,20 @@ PyObject* ToPy::toPy(const HdlModuleDef *o) {
 		if (toPy_property(py_inst, "module_name", o->entityName))
 			return nullptr;
 	}
-	if (toPy_arr(py_inst, "objs", o->objs))
+	if (toPy_objs(py_inst, "objs", o->objs))
 		return nullptr;
 
 	return py_inst;
 }
 
 PyObject* ToPy::toPy(const hdlObjects::HdlCompInstance *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlComponentInstCls, NULL);
+	PyObject *py_inst = new_inst(HdlComponentInstCls);
 	if (py_inst == nullptr)
 		return nullptr;
 	if (toPy_property(py_inst, "name", o->name))
 		return nullptr;
+	if (toPy(static_cast<const WithPos*>(o), py_inst))
+		return nullptr;
 	if (toPy_property(py_inst, "module_name", o->entityName))
 		return nullptr;
 	if (toPy_arr(py_inst, "param_map", o->genericMap))
@@ -196,7 +407,7 @@ PyObject* ToPy::toPy(const hdlObjects::HdlCompInstance *o) {
 }
 
 PyObject* ToPy::toPy(const HdlModuleDec *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlModuleDecCls, NULL);
+	PyObject *py_inst = new_inst(HdlModuleDecCls);
 	if (py_inst == nullptr)
 		return nullptr;
 	int e = toPy(static_cast<const WithNameAndDoc*>(o), py_inst);
@@ -213,25 +424,86 @@ PyObject* ToPy::toPy(const HdlModuleDec *o) {
 }
 
 PyObject* ToPy::toPy(const iHdlExpr *o) {
-	HdlCall *op = dynamic_cast<HdlCall*>(o->data);
-	if (op) {
-		return toPy(op);
-	} else {
-		HdlValue *literal = dynamic_cast<HdlValue*>(o->data);
-		if (literal)
-			return toPy(literal);
-		else if (o->data)
-			PyErr_SetString(PyExc_ValueError,
-					"ToPy::toPy - Expr is improperly initialized");
-		else
-			PyErr_SetString(PyExc_ValueError,
-					"ToPy::toPy - Expr has NULL data");
+	if (!o->data) {
+		PyErr_SetString(PyExc_ValueError, "ToPy::toPy - Expr has NULL data");
+		return nullptr;
 	}
-	return nullptr;
+	return visit_iHdlExprItem(*o->data, [this](auto *item) {
+		return toPy(item);
+	});
+}
+
+PyObject* ToPy::toPy(const HdlExprTree &t, HdlExprTree::node_id root) {
+	if (root >= t.size()) {
+		PyErr_SetString(PyExc_IndexError, "ToPy::toPy - invalid HdlExprTree node");
+		return nullptr;
+	}
+	// the operands have smaller index than the node, resolve which nodes are used
+	// by the expression and convert them from the leaves to the root
+	auto &used = expr_tree_used;
+	auto &objs = expr_tree_objs;
+	used.assign(root + 1, false);
+	objs.assign(root + 1, nullptr);
+	used[root] = true;
+	for (size_t i = root + 1; i-- > 0;) {
+		if (!used[i])
+			continue;
+		auto &n = t[i];
+		for (auto o = t.operands_begin(n); o != t.operands_end(n); ++o)
+			used[*o] = true;
+	}
+	auto release_objs = [&objs](size_t end) {
+		for (size_t i = 0; i < end; i++)
+			Py_XDECREF(objs[i]);
+	};
+	for (size_t i = 0; i <= root; i++) {
+		if (!used[i])
+			continue;
+		auto &n = t[i];
+		PyObject *py_o;
+		if (n.kind == EXPR_NODE_CALL || (n.kind == EXPR_NODE_VALUE
+				&& n.value_type == HdlValueType::symb_ARRAY)) {
+			PyObject *ops = PyList_New(n.operands_cnt);
+			if (ops) {
+				Py_ssize_t op_i = 0;
+				for (auto o = t.operands_begin(n); o != t.operands_end(n); ++o) {
+					Py_INCREF(objs[*o]);
+					PyList_SET_ITEM(ops, op_i++, objs[*o]);
+				}
+			}
+			if (!ops || n.kind == EXPR_NODE_VALUE) {
+				py_o = ops;
+			} else {
+				py_o = new_inst(HdlCallCls);
+				if (!py_o) {
+					Py_DECREF(ops);
+				} else if (toPy_property(py_o, "fn", n.op)) {
+					Py_DECREF(ops);
+					py_o = nullptr;
+				} else if (set_attr(py_o, "ops", ops)) {
+					py_o = nullptr;
+				}
+			}
+		} else if (n.kind == EXPR_NODE_VALUE) {
+			py_o = toPy_value(t, n);
+		} else {
+			Py_INCREF(Py_None);
+			py_o = Py_None;
+		}
+		if (!py_o) {
+			release_objs(i);
+			return nullptr;
+		}
+		objs[i] = py_o;
+	}
+	auto res = objs[root];
+	objs[root] = nullptr;
+	release_objs(root);
+	return res;
 }
 
 PyObject* ToPy::toPy(const HdlFunctionDef *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlFunctionDefCls, NULL);
+	PyObject *py_inst = new_inst(HdlFunctionDefCls);
 	if (py_inst == nullptr)
 		return nullptr;
 	if (toPy(static_cast<const WithNameAndDoc*>(o), py_inst))
@@ -254,80 +526,119 @@ PyObject* ToPy::toPy(const HdlFunctionDef *o) {
 		if (toPy_property(py_inst, "return_t", o->returnT))
 			return nullptr;
 	}
-	if (toPy_arr(py_inst, "body", o->body))
+	if (toPy_objs(py_inst, "body", o->body))
 		return nullptr;
 
 	return py_inst;
 }
 
-PyObject* ToPy::toPy(const HdlValue *o) {
-	auto t = o->type;
-
-	if (t == HdlValueType::symb_ID) {
-		assert(!o->_str.empty());
-		auto v = PyUnicode_FromString(o->_str.c_str());
+PyObject* ToPy::toPy_name(const HdlSymbol &o) {
+	assert(!o.empty());
+	// all occurrences of the identifier share the same HdlName (it is immutable)
+	auto &py_name = name_cache[o.id()];
+	if (!py_name) {
+		auto v = toPy(o);
 		if (!v)
 			return nullptr;
-		return PyObject_CallFunctionObjArgs(HdlNameCls, v, NULL);
-	} else if (t == HdlValueType::symb_INT) {
-		auto &_v = o->_int;
-		PyObject *v, *bits, *base = nullptr;
-		if (_v.is_bitstring()) {
-			v = PyUnicode_FromString(_v.bitstring.c_str());
-		} else {
-			v = PyLong_FromLong(_v.val);
+		py_name = call(HdlNameCls, &v, 1);
+		Py_DECREF(v);
+		if (!py_name)
+			return nullptr;
+	}
+	Py_INCREF(py_name);
+	return py_name;
+}
+
+PyObject* ToPy::toPy_int(const BigInteger &_v, int _bits) {
+	PyObject **cached = nullptr;
+	if (share_int_values && !_v.is_bitstring()) {
+		cached = &int_cache[ { _v.get_val(), _bits }];
+		if (*cached) {
+			Py_INCREF(*cached);
+			return *cached;
 		}
-		if (!v)
+	}
+	PyObject *v, *bits, *base = nullptr;
+	if (_v.is_bitstring()) {
+		auto bs = _v.get_bitstring();
+		v = PyUnicode_FromStringAndSize(bs.data(), bs.size());
+	} else {
+		v = PyLong_FromLongLong(_v.get_val());
+	}
+	if (!v)
+		return nullptr;
+	if (_v.is_bitstring()) {
+		base = PyLong_FromLong(_v.get_bitstring_base());
+		if (!base) {
+			Py_DECREF(v);
 			return nullptr;
-		if (_v.is_bitstring()) {
-			base = PyLong_FromLong(_v.bitstring_base);
-			if (!base) {
-				Py_DECREF(v);
-				return nullptr;
-			}
-		} else {
-			Py_INCREF(Py_None);
-			base = Py_None;
 		}
-		if (o->bits > 0) {
-			bits = PyLong_FromLong(o->bits);
-			if (!bits) {
-				Py_XDECREF(base);
-				Py_DECREF(v);
-				return nullptr;
-			}
-		} else {
-			Py_INCREF(Py_None);
-			bits = Py_None;
+	} else {
+		Py_INCREF(Py_None);
+		base = Py_None;
+	}
+	if (_bits > 0) {
+		bits = PyLong_FromLong(_bits);
+		if (!bits) {
+			Py_XDECREF(base);
+			Py_DECREF(v);
+			return nullptr;
 		}
+	} else {
+		Py_INCREF(Py_None);
+		bits = Py_None;
+	}
 
-		return PyObject_CallFunctionObjArgs(HdlIntValueCls, v, bits, base, NULL);
+	PyObject *args[] = { v, bits, base };
+	auto res = call(HdlIntValueCls, args, 3);
+	Py_DECREF(v);
+	Py_DECREF(bits);
+	Py_DECREF(base);
+	if (res && cached) {
+		Py_INCREF(res);
+		*cached = res;
+	}
+	return res;
+}
+
+PyObject* ToPy::toPy(const HdlValue *o) {
+	auto t = o->type;
+
+	if (t == HdlValueType::symb_ID) {
+		return toPy_name(o->_str);
+	} else if (t == HdlValueType::symb_INT) {
+		return toPy_int(o->_int, o->bits);
 	} else if (t == HdlValueType::symb_FLOAT) {
 		return PyFloat_FromDouble(o->_float);
 	} else if (t == HdlValueType::symb_STRING) {
-		return PyUnicode_FromString(o->_str.c_str());
-	} else if (t == HdlValueType::symb_OPEN) {
-		Py_RETURN_NONE;
+		return toPy(*o->_string);
 	} else if (t == HdlValueType::symb_ARRAY) {
 		assert(o->_arr);
-		auto val = PyList_New(o->_arr->size());
-		if (!val)
-			return nullptr;
-		size_t indx = 0;
-		for (auto &elem : *o->_arr) {
-			auto tmp = toPy(elem);
-			if (!tmp) {
-				Py_DECREF(val);
-				return nullptr;
-			}
-			int e = PyList_SetItem(val, indx, tmp);
-			if (e) {
-				Py_DECREF(val);
-				return nullptr;
-			}
-			indx++;
-		}
-		return val;
+		return toPy_list(*o->_arr);
+	} else {
+		return toPy_value(t);
+	}
+}
+
+PyObject* ToPy::toPy_value(const HdlExprTree &tree, const HdlExprNode &n) {
+	auto t = n.value_type;
+
+	if (t == HdlValueType::symb_ID) {
+		return toPy_name(tree.symbols[n.value]);
+	} else if (t == HdlValueType::symb_INT) {
+		return toPy_int(tree.ints[n.value], n.bits);
+	} else if (t == HdlValueType::symb_FLOAT) {
+		return PyFloat_FromDouble(tree.floats[n.value]);
+	} else if (t == HdlValueType::symb_STRING) {
+		return toPy(tree.strings[n.value]);
+	} else {
+		return toPy_value(t);
+	}
+}
+
+PyObject* ToPy::toPy_value(HdlValueType t) {
+	if (t == HdlValueType::symb_OPEN) {
+		Py_RETURN_NONE;
 	} else if (t == HdlValueType::symb_ALL) {
 		Py_INCREF(HdlAllCls);
 		return HdlAllCls;
@@ -339,9 +650,6 @@ PyObject* ToPy::toPy(const HdlValue *o) {
 	} else if (t == HdlValueType::symb_AUTO) {
 		Py_INCREF(HdlTypeAutoCls);
 		return HdlTypeAutoCls;
-	} else if (t == HdlValueType::symb_ALL) {
-		Py_INCREF(HdlAllCls);
-		return HdlAllCls;
 	} else if (t == HdlValueType::symb_OTHERS) {
 		Py_INCREF(HdlOthersCls);
 		return HdlOthersCls;
@@ -352,41 +660,46 @@ PyObject* ToPy::toPy(const HdlValue *o) {
 }
 
 PyObject* ToPy::toPy(const HdlOperatorType o) {
-	const char *name;
-	try {
-		name = HdlOperatorType_toString(o);
-	} catch (const std::runtime_error &e) {
-		PyErr_SetString(PyExc_ValueError, e.what());
-		return nullptr;
+	auto &py_op = op_cache[o];
+	if (!py_op) {
+		const char *name;
+		try {
+			name = HdlOperatorType_toString(o);
+		} catch (const std::runtime_error &e) {
+			PyErr_SetString(PyExc_ValueError, e.what());
+			return nullptr;
+		}
+		py_op = PyObject_GetAttrString(HdlBuiltinFnEnum, name);
+		if (!py_op)
+			return nullptr;
 	}
-	return PyObject_GetAttrString(HdlBuiltinFnEnum, name);
+	Py_INCREF(py_op);
+	return py_op;
 }
 
 PyObject* ToPy::toPy(const HdlDirection o) {
-	auto v = PyLong_FromLong(o);
-	if (!v) {
-		return nullptr;
+	auto &py_d = direction_cache[o];
+	if (!py_d) {
+		auto v = PyLong_FromLong(o);
+		if (!v) {
+			return nullptr;
+		}
+		py_d = call(HdlDirectionEnum, &v, 1);
+		Py_DECREF(v);
+		if (!py_d)
+			return nullptr;
 	}
-
-	return PyObject_CallFunctionObjArgs(HdlDirectionEnum, v, NULL);
+	Py_INCREF(py_d);
+	return py_d;
 }
 
 PyObject* ToPy::toPy(const HdlCall *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlCallCls, NULL);
+	PyObject *py_inst = new_inst(HdlCallCls);
 	if (!py_inst)
 		return nullptr;
 
-	auto op = toPy(o->op);
-	if (!op) {
-		Py_DECREF(py_inst);
+	if (toPy_property(py_inst, "fn", o->op))
 		return nullptr;
-	}
-	int e = PyObject_SetAttrString(py_inst, "fn", op);
-	if (e) {
-		Py_DECREF(op);
-		Py_DECREF(py_inst);
-		return nullptr;
-	}
 	if (toPy_arr(py_inst, "ops", o->operands)) {
 		return nullptr;
 	}
@@ -395,31 +708,22 @@ PyObject* ToPy::toPy(const HdlCall *o) {
 
 // [TODO] too similar with the code for HdlModuleDef
 PyObject* ToPy::toPy(const HdlNamespace *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlNamespaceCls, NULL);
+	PyObject *py_inst = new_inst(HdlNamespaceCls);
 	if (py_inst == nullptr)
 		return nullptr;
 	if (toPy(static_cast<const WithNameAndDoc*>(o), py_inst))
 		return nullptr;
-	if (toPy_arr(py_inst, "objs", o->objs))
+	if (toPy_objs(py_inst, "objs", o->objs))
 		return nullptr;
 
-	auto dec_only = PyBool_FromLong(o->defs_only);
-	if (!dec_only) {
-		Py_DECREF(py_inst);
+	if (toPy_property(py_inst, "declaration_only", o->defs_only))
 		return nullptr;
-	}
-
-	if (PyObject_SetAttrString(py_inst, "declaration_only", dec_only)) {
-		Py_DECREF(py_inst);
-		Py_DECREF(dec_only);
-		return nullptr;
-	}
 
 	return py_inst;
 }
 
 PyObject* ToPy::toPy(const HdlVariableDef *o) {
-	PyObject *py_inst = PyObject_CallObject(HdlVariableDefCls, NULL);
+	PyObject *py_inst = new_inst(HdlVariableDefCls);
 	if (!py_inst)
 		return nullptr;
 	if (toPy(static_cast<const WithNameAndDoc*>(o), py_inst))
@@ -450,7 +754,37 @@ PyObject* ToPy::toPy(const std::string &o) {
 	return PyUnicode_FromString(o.c_str());
 }
 
+PyObject* ToPy::toPy(const HdlSymbol &o) {
+	// the same symbols share the same str object
+	auto &py_str = symbol_cache[o.id()];
+	if (!py_str) {
+		py_str = PyUnicode_FromStringAndSize(o.c_str(), o.size());
+		if (!py_str)
+			return nullptr;
+	}
+	Py_INCREF(py_str);
+	return py_str;
+}
+
 ToPy::~ToPy() {
+	for (auto &s : symbol_cache)
+		Py_XDECREF(s.second);
+	for (auto &n : name_cache)
+		Py_XDECREF(n.second);
+	for (auto &i : int_cache)
+		Py_XDECREF(i.second);
+	for (auto &f : file_cache)
+		Py_XDECREF(f.second);
+	for (auto &n : attr_name_cache)
+		Py_XDECREF(n.second);
+	for (auto &c : cls_info_cache) {
+		Py_XDECREF(c.second.prototype);
+		c.second.release_slots();
+	}
+	for (auto &op : op_cache)
+		Py_XDECREF(op.second);
+	for (auto &d : direction_cache)
+		Py_XDECREF(d.second);
 	Py_XDECREF(HdlNamespaceCls);
 	Py_XDECREF(HdlFunctionDefCls);
 	Py_XDECREF(HdlComponentInstCls);
@@ -1,7 +1,10 @@
 #pragma once
 
 #include <Python.h>
+#include <functional>
+#include <utility>
 #include <vector>
+#include <unordered_map>
 
 #include <hdlConvertor/hdlObjects/hdlCompInstance.h>
 #include <hdlConvertor/hdlObjects/hdlContext.h>
@@ -9,6 +12,7 @@
 #include <hdlConvertor/hdlObjects/iHdlExpr.h>
 #include <hdlConvertor/hdlObjects/named.h>
 #include <hdlConvertor/hdlObjects/hdlCall.h>
+#include <hdlConvertor/hdlObjects/hdlExprTree.h>
 #include <hdlConvertor/hdlObjects/hdlOperatorType.h>
 #include <hdlConvertor/hdlObjects/hdlNamespace.h>
 #include <hdlConvertor/hdlObjects/hdlModuleDec.h>
@@ -28,6 +32,61 @@
 
 namespace hdlConvertor {
 
+/*
+ * The function which creates the Python list for the objects
+ * which converts the objects only when the list is accessed
+ *
+ * :param owner: the object which keeps the objects alive (ToPy::lazy_objs_owner)
+ * :return: new reference or nullptr with the Python exception set
+ * */
+typedef PyObject* (*ToPyLazyObjsFactory)(
+		const std::vector<std::unique_ptr<hdlObjects::iHdlObj>> *objs,
+		void *owner);
+
+/*
+ * The __slots__ attribute set by ToPy::new_inst
+ *
+ * :ivar name: the name of the slot (owned reference)
+ * :ivar value: the value of the slot in the prototype (owned reference),
+ * 		nullptr if the value is an empty list (each instance requires a new list)
+ * */
+class ToPySlot {
+public:
+	PyObject *name;
+	PyObject *value;
+};
+
+/*
+ * The information about the Python class of the AST node used to create its instances
+ * without the call of the __init__ (the __init__ of the classes in hdlConvertor.hdlAst
+ * only sets the default values of the __slots__)
+ *
+ * :ivar prototype: the instance created by cls(), the new instances get the same values
+ * 		in the slots (nullptr if the class is not compatible, cls() is used instead)
+ * :ivar slots: the slots which are set by the __init__, the new instances are allocated
+ * 		by tp_alloc and the slots are set by PyObject_SetAttr
+ * */
+class ToPyClsInfo {
+public:
+	PyObject *prototype;
+	std::vector<ToPySlot> slots;
+
+	void release_slots() {
+		for (auto &s : slots) {
+			Py_DECREF(s.name);
+			Py_XDECREF(s.value);
+		}
+		slots.clear();
+	}
+};
+
+class ToPyIntKeyHash {
+public:
+	size_t operator()(const std::pair<int64_t, int> &k) const {
+		return std::hash<int64_t>()(k.first) * 31 + std::hash<int>()(k.second);
+	}
+};
+
 class ToPy {
 	PyObject *hdlAst_module;
 	PyObject *ContextCls;
@@ -61,44 +120,94 @@ class ToPy {
 	PyObject *HdlComponentInstCls;
 	PyObject *HdlFunctionDefCls;
 	PyObject *HdlNamespaceCls;
+	// the Python str for each already converted HdlSymbol (HdlSymbol::id() -> str)
+	std::unordered_map<const void*, PyObject*> symbol_cache;
+	/*
+	 * The objects shared by all occurrences of the same value during the conversion
+	 * (HdlSymbol::id() -> HdlName, (value, bits) -> HdlIntValue for the non-bitstring integers
+	 * if share_int_values is set)
+	 * */
+	std::unordered_map<const void*, PyObject*> name_cache;
+	std::unordered_map<std::pair<int64_t, int>, PyObject*, ToPyIntKeyHash> int_cache;
+	// the Python str for each file name of the positions (Position::get_file() -> str)
+	std::unordered_map<const std::string*, PyObject*> file_cache;
+	// the interned Python str for the attribute names (the names are string literals)
+	std::unordered_map<const char*, PyObject*> attr_name_cache;
+	std::unordered_map<PyObject*, ToPyClsInfo> cls_info_cache;
+	// the members of HdlBuiltinFn/HdlDirection for each value of HdlOperatorType/HdlDirection
+	std::unordered_map<int, PyObject*> op_cache;
+	std::unordered_map<int, PyObject*> direction_cache;
+	/*
+	 * The flags of the nodes used by the converted HdlExprTree expression
+	 * and the Python objects for the nodes (reused for all trees)
+	 * */
+	std::vector<bool> expr_tree_used;
+	std::vector<PyObject*> expr_tree_objs;
 
 	std::string PyObject_repr(PyObject *o);
+	// :return: the HdlName for the identifier (shared for all occurrences of the identifier)
+	PyObject* toPy_name(const hdlObjects::HdlSymbol &o);
+	PyObject* toPy_int(const hdlObjects::BigInteger &v, int bits);
+	// convert the node of the tree which is not a call or an array
+	PyObject* toPy_value(const hdlObjects::HdlExprTree &t,
+			const hdlObjects::HdlExprNode &n);
+	// convert the value which does not have any data (HdlAll, None, ...)
+	PyObject* toPy_value(hdlObjects::HdlValueType t);
 
-	template<typename OBJ_T>
-	int toPy_arr(PyObject *parent, const std::string &prop_name,
-			const std::vector<OBJ_T> &objs) {
-
-		PyObject *parent_list = PyObject_GetAttrString(parent,
-				prop_name.c_str());
-		if (parent_list == nullptr) {
-			std::string err_msg = (std::string(
-					"ToPy::toPy_arr object does not have specified property:")
-					+ prop_name + std::string(" : ") + PyObject_repr(parent));
-			Py_DECREF(parent);
-			PyErr_SetString(PyExc_ValueError, err_msg.c_str());
-			return -1;
-		}
-		return toPy_arr<OBJ_T>(parent_list, objs);
-	}
+	// :return: the interned str for the attribute name (borrowed reference)
+	PyObject* attr_name(const char *name);
+	/*
+	 * Set the attribute of the instance
+	 *
+	 * :note: the reference to the value is stolen, the py_inst is released on error
+	 * */
+	int set_attr(PyObject *py_inst, const char *name, PyObject *value);
+	/*
+	 * Create a new instance of the AST class which has the constructor without arguments
+	 * (without calling of the __init__ if possible, see ToPyClsInfo)
+	 * */
+	PyObject* new_inst(PyObject *cls);
+	// call the class/function with the positional arguments (using vectorcall if available)
+	static PyObject* call(PyObject *callable, PyObject *const*args,
+			size_t nargs);
 
 	template<typename OBJ_T>
-	int toPy_arr(PyObject *py_list, const std::vector<OBJ_T> &objs) {
+	PyObject* toPy_list(const std::vector<OBJ_T> &objs) {
+		PyObject *py_list = PyList_New(objs.size());
+		if (!py_list)
+			return nullptr;
+		Py_ssize_t i = 0;
 		for (auto &o : objs) {
 			auto py_obj = toPy(o);
 			if (py_obj == nullptr) {
 				Py_DECREF(py_list);
-				return -1;
-			}
-			auto e = PyList_Append(py_list, py_obj);
-			Py_DECREF(py_obj);
-			if (e) {
-				Py_DECREF(py_list);
-				return e;
+				return nullptr;
 			}
+			PyList_SET_ITEM(py_list, i++, py_obj);
 		}
-		return 0;
+		return py_list;
 	}
 
+	template<typename OBJ_T>
+	int toPy_arr(PyObject *parent, const char *prop_name,
+			const std::vector<OBJ_T> &objs) {
+		if (objs.empty())
+			return 0; // the empty list is already set by the constructor
+		auto py_list = toPy_list(objs);
+		if (!py_list) {
+			Py_DECREF(parent);
+			return -1;
+		}
+		return set_attr(parent, prop_name, py_list);
+	}
+
+	/*
+	 * Convert the body of the module/namespace/function
+	 * (lazily if the lazy_objs_factory is specified)
+	 * */
+	int toPy_objs(PyObject *py_inst, const char *prop_name,
+			const std::vector<std::unique_ptr<hdlObjects::iHdlObj>> &objs);
+
 	template<typename OBJ_T>
 	int toPy_property(PyObject *py_inst, const char *prop_name,
 			const std::unique_ptr<OBJ_T> &o) {
@@ -107,12 +216,7 @@ class ToPy {
 			Py_DECREF(py_inst);
 			return -1;
 		}
-		int e = PyObject_SetAttrString(py_inst, prop_name, py_o);
-		if (e < 0) {
-			Py_DECREF(py_inst);
-			return -1;
-		}
-		return 0;
+		return set_attr(py_inst, prop_name, py_o);
 	}
 	template<typename OBJ_T>
 	int toPy_property(PyObject *py_inst, const char *prop_name,
@@ -122,15 +226,26 @@ class ToPy {
 			Py_DECREF(py_inst);
 			return -1;
 		}
-		int e = PyObject_SetAttrString(py_inst, prop_name, py_o);
-		if (e < 0) {
-			Py_DECREF(py_inst);
-			return -1;
-		}
-		return 0;
+		return set_attr(py_inst, prop_name, py_o);
 	}
 public:
+	/*
+	 * If specified the bodies of the modules, namespaces and functions are not converted,
+	 * the factory is used to create the lists which convert them on the first access
+	 * (the C++ objects have to live as long as the lists)
+	 * */
+	ToPyLazyObjsFactory lazy_objs_factory;
+	void *lazy_objs_owner;
+	/*
+	 * If true all occurrences of the same integer value (not bitstring) with the same width
+	 * are converted to a single HdlIntValue instance (the HdlIntValue is mutable,
+	 * the instance must not be modified in place)
+	 * */
+	bool share_int_values;
+
 	ToPy();
+	ToPy(const ToPy&) = delete;
+	ToPy& operator=(const ToPy&) = delete;
 
 	// automatic conversion from std::unique_ptr<T> to const T * for any type
 	template<typename T>
@@ -140,6 +255,10 @@ public:
 
 	int toPy(const hdlObjects::WithNameAndDoc *o, PyObject *py_inst);
 	int toPy(const hdlObjects::WithDoc *o, PyObject *py_inst);
+	// set the position of the object (only if it is known)
+	int toPy(const hdlObjects::WithPos *o, PyObject *py_inst);
+
+	PyObject* toPy(const hdlObjects::Position &o);
 
 	PyObject* toPy(const hdlConvertor::hdlObjects::HdlExprAndStm &o);
 	PyObject* toPy(const hdlObjects::iHdlStatement *o);
@@ -150,6 +269,13 @@ public:
 	PyObject* toPy(const hdlObjects::HdlDirection o);
 	PyObject* toPy(const hdlObjects::HdlModuleDec *o);
 	PyObject* toPy(const hdlObjects::iHdlExpr *o);
+	/*
+	 * Convert the expression of the node of the flat tree, converted from the leaves
+	 * to the root without recursion (a node shared by multiple nodes is converted
+	 * to a single Python object)
+	 * */
+	PyObject* toPy(const hdlObjects::HdlExprTree &t,
+			hdlObjects::HdlExprTree::node_id n);
 	PyObject* toPy(const hdlObjects::HdlFunctionDef *o);
 	PyObject* toPy(const hdlObjects::iHdlObj *o);
 	PyObject* toPy(const hdlObjects::HdlCall *o);
@@ -170,6 +296,7 @@ public:
 	PyObject* toPy(const hdlObjects::HdlStmWait *o);
 	PyObject* toPy(const hdlObjects::HdlStmImport *o);
 	PyObject* toPy(const std::string &o);
+	PyObject* toPy(const hdlObjects::HdlSymbol &o);
 	PyObject* toPy(bool o);
 	~ToPy();
 };
@@ -1,4 +1,5 @@
 #include "toPy.h"
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 #include <tuple>
 
 namespace hdlConvertor {
@@ -9,7 +10,7 @@ PyObject* ToPy::toPy(const HdlStmExpr *o) {
 	return toPy(o->expr);
 }
 PyObject* ToPy::toPy(const HdlStmIf *o) {
-	auto py_inst = PyObject_CallObject(HdlStmIfCls, NULL);
+	auto py_inst = new_inst(HdlStmIfCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -28,7 +29,7 @@ PyObject* ToPy::toPy(const HdlStmIf *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmBlock *o) {
-	auto py_inst = PyObject_CallObject(HdlStmBlockCls, NULL);
+	auto py_inst = new_inst(HdlStmBlockCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -39,7 +40,7 @@ PyObject* ToPy::toPy(const HdlStmBlock *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmCase *o) {
-	auto py_inst = PyObject_CallObject(HdlStmCaseCls, NULL);
+	auto py_inst = new_inst(HdlStmCaseCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -56,7 +57,7 @@ PyObject* ToPy::toPy(const HdlStmCase *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmFor *o) {
-	auto py_inst = PyObject_CallObject(HdlStmForCls, NULL);
+	auto py_inst = new_inst(HdlStmForCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -72,7 +73,7 @@ PyObject* ToPy::toPy(const HdlStmFor *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmForIn *o) {
-	auto py_inst = PyObject_CallObject(HdlStmForInCls, NULL);
+	auto py_inst = new_inst(HdlStmForInCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -86,7 +87,7 @@ PyObject* ToPy::toPy(const HdlStmForIn *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmReturn *o) {
-	auto py_inst = PyObject_CallObject(HdlStmReturnCls, NULL);
+	auto py_inst = new_inst(HdlStmReturnCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -117,47 +118,29 @@ PyObject* ToPy::toPy(const HdlStmAssign *o) {
 			time_delay = Py_None;
 		}
 		if (o->event_delay && o->event_delay->size()) {
-			event_delay = PyList_New(o->event_delay->size());
+			event_delay = toPy_list(*o->event_delay);
 			if (!event_delay)
 				break;
-			for (size_t i = 0; i < o->event_delay->size(); i++) {
-				auto py_obj = toPy((*o->event_delay)[i]);
-				if (py_obj == nullptr) {
-					e = -1;
-					break;
-				}
-				if (PyList_SetItem(event_delay, i, py_obj)) {
-					e = -1;
-					break;
-				}
-			}
-			if (e)
-				break;
 		}
 
-		py_inst = PyObject_CallFunctionObjArgs(HdlStmAssignCls, src, dst,
-				time_delay, event_delay, NULL);
+		PyObject *args[] = { src, dst, time_delay, event_delay };
+		py_inst = call(HdlStmAssignCls, args, event_delay ? 4 : 3);
 		if (!py_inst) {
 			break;
 		}
-		auto _o = dynamic_cast<const HdlStmAssign*>(o);
-		e = PyObject_SetAttrString(py_inst, "is_blocking",
-				PyBool_FromLong((long) _o->is_blocking));
-
+		e = toPy_property(py_inst, "is_blocking", o->is_blocking);
 	} while (0);
-	if (e || !py_inst) {
-		Py_DECREF(src);
-		Py_DECREF(dst);
-		Py_DECREF(time_delay);
-		Py_DECREF(event_delay);
-
+	Py_XDECREF(src);
+	Py_XDECREF(dst);
+	Py_XDECREF(time_delay);
+	Py_XDECREF(event_delay);
+	if (e || !py_inst)
 		return nullptr;
-	}
 	return py_inst;
 }
 
 PyObject* ToPy::toPy(const HdlStmWhile *o) {
-	auto py_inst = PyObject_CallObject(HdlStmWhileCls, NULL);
+	auto py_inst = new_inst(HdlStmWhileCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -169,27 +152,20 @@ PyObject* ToPy::toPy(const HdlStmWhile *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmProcess *o) {
-	auto py_inst = PyObject_CallObject(HdlStmProcessCls, NULL);
+	auto py_inst = new_inst(HdlStmProcessCls);
 	if (!py_inst) {
 		return nullptr;
 	}
 
 	if (o->sensitivity_list) {
-		auto sl = PyList_New(0);
+		// the empty list is a valid value (it is None if not specified)
+		auto sl = toPy_list(*o->sensitivity_list);
 		if (!sl) {
 			Py_DECREF(py_inst);
 			return nullptr;
 		}
-		if (PyObject_SetAttrString(py_inst, "sensitivity", sl)) {
-			Py_DECREF(py_inst);
-			Py_DECREF(sl);
+		if (set_attr(py_inst, "sensitivity", sl))
 			return nullptr;
-		}
-
-		if (toPy_arr(sl, *o->sensitivity_list.get())) {
-			Py_DECREF(py_inst);
-			return nullptr;
-		}
 	}
 	if (toPy_property(py_inst, "body", o->body))
 		return nullptr;
@@ -197,7 +173,7 @@ PyObject* ToPy::toPy(const HdlStmProcess *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmImport *o) {
-	auto py_inst = PyObject_CallObject(HdlImportCls, NULL);
+	auto py_inst = new_inst(HdlImportCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -209,7 +185,7 @@ PyObject* ToPy::toPy(const HdlStmImport *o) {
 }
 
 PyObject* ToPy::toPy(const HdlStmWait *o) {
-	auto py_inst = PyObject_CallObject(HdlStmWaitCls, NULL);
+	auto py_inst = new_inst(HdlStmWaitCls);
 	if (!py_inst) {
 		return nullptr;
 	}
@@ -220,92 +196,47 @@ PyObject* ToPy::toPy(const HdlStmWait *o) {
 }
 PyObject* ToPy::toPy(const iHdlStatement *o) {
 	PyObject *py_inst = nullptr;
-	do {
-		auto ex = dynamic_cast<const HdlStmExpr*>(o);
-		if (ex) {
-			// @attention currently ignoring labels, doc etc
-			return toPy(ex);
-		}
-		auto n = dynamic_cast<const HdlStmNop*>(o);
-		if (n) {
-			// @attention currently ignoring labels, doc etc
-			Py_RETURN_NONE;
-		}
-		auto b = dynamic_cast<const HdlStmBlock*>(o);
-		if (b) {
-			py_inst = toPy(b);
-			break;
-		}
-		auto i = dynamic_cast<const HdlStmIf*>(o);
-		if (i) {
-			py_inst = toPy(i);
-			break;
-		}
-		auto c = dynamic_cast<const HdlStmCase*>(o);
-		if (c) {
-			py_inst = toPy(c);
-			break;
-		}
-		auto f = dynamic_cast<const HdlStmFor*>(o);
-		if (f) {
-			py_inst = toPy(f);
-			break;
-		}
-		auto fi = dynamic_cast<const HdlStmForIn*>(o);
-		if (fi) {
-			py_inst = toPy(fi);
-			break;
-		}
-		auto r = dynamic_cast<const HdlStmReturn*>(o);
-		if (r) {
-			py_inst = toPy(r);
-			break;
-		}
-		auto br = dynamic_cast<const HdlStmBreak*>(o);
-		if (br) {
-			py_inst = PyObject_CallObject(HdlStmBreakCls, NULL);
-			break;
-		}
-		auto cn = dynamic_cast<const HdlStmContinue*>(o);
-		if (cn) {
-			py_inst = PyObject_CallObject(HdlStmContinueCls, NULL);
-			break;
-		}
-		auto a = dynamic_cast<const HdlStmAssign*>(o);
-		if (a) {
-			py_inst = toPy(a);
-			break;
-		}
-		auto w = dynamic_cast<const HdlStmWhile*>(o);
-		if (w) {
-			py_inst = toPy(w);
-			break;
-		}
-		auto p = dynamic_cast<const HdlStmProcess*>(o);
-		if (p) {
-			py_inst = toPy(p);
-			break;
-		}
-		auto wa = dynamic_cast<const HdlStmWait*>(o);
-		if (wa) {
-			py_inst = toPy(wa);
-			break;
-		}
-		auto im = dynamic_cast<const HdlStmImport*>(o);
-		if (im) {
-			py_inst = toPy(im);
-			break;
-		}
+	switch (o->obj_kind) {
+	case OBJ_STM_EXPR:
+		// @attention currently ignoring labels, doc etc
+		return toPy(static_cast<const HdlStmExpr*>(o));
+	case OBJ_STM_NOP:
+		// @attention currently ignoring labels, doc etc
+		Py_RETURN_NONE;
+	case OBJ_STM_BREAK:
+		py_inst = new_inst(HdlStmBreakCls);
+		break;
+	case OBJ_STM_CONTINUE:
+		py_inst = new_inst(HdlStmContinueCls);
+		break;
+	case OBJ_STM_BLOCK:
+	case OBJ_STM_IF:
+	case OBJ_STM_CASE:
+	case OBJ_STM_FOR:
+	case OBJ_STM_FOR_IN:
+	case OBJ_STM_RETURN:
+	case OBJ_STM_ASSIGN:
+	case OBJ_STM_WHILE:
+	case OBJ_STM_PROCESS:
+	case OBJ_STM_WAIT:
+	case OBJ_STM_IMPORT:
+		py_inst = visit_iHdlStatement(*o, [this](auto *stm) {
+			return toPy(stm);
+		});
+		break;
+	default:
 		std::string err_msg = std::string("Invalid StatementType:")
-				+ typeid(*o).name();
+				+ HdlObjKind_toString(o->obj_kind);
 		PyErr_SetString(PyExc_TypeError, err_msg.c_str());
 		return nullptr;
-	} while (0);
+	}
 	if (!py_inst)
 		return nullptr;
 
 	if (toPy(static_cast<const WithDoc*>(o), py_inst))
 		return nullptr;
+	if (toPy(static_cast<const WithPos*>(o), py_inst))
+		return nullptr;
 
 	if (toPy_arr(py_inst, "labels", o->labels)) {
 		return nullptr;
@@ -327,12 +258,7 @@ PyObject* ToPy::toPy(const hdlConvertor::hdlObjects::HdlExprAndStm &o) {
 		Py_DECREF(py_inst);
 		return nullptr;
 	}
-
-	int e = PyTuple_SetItem(py_inst, 0, c);
-	if (e) {
-		Py_DECREF(py_inst);
-		return nullptr;
-	}
+	PyTuple_SET_ITEM(py_inst, 0, c);
 
 	// fill statements in elif/case
 	auto stms = toPy(o.stm);
@@ -340,11 +266,7 @@ PyObject* ToPy::toPy(const hdlConvertor::hdlObjects::HdlExprAndStm &o) {
 		Py_DECREF(py_inst);
 		return nullptr;
 	}
-	e = PyTuple_SetItem(py_inst, 1, stms);
-	if (e) {
-		Py_DECREF(py_inst);
-		return nullptr;
-	}
+	PyTuple_SET_ITEM(py_inst, 1, stms);
 	return py_inst;
 }
 
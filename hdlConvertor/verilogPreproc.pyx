@@ -2,7 +2,7 @@ from libcpp cimport bool
 from libcpp.string cimport string
 from libcpp.vector cimport vector
 from libcpp.cast cimport dynamic_cast
-from libcpp.map cimport map
+from libcpp.utility cimport pair
 from cython.operator cimport dereference as deref
 from cython.operator cimport preincrement as preinc
 from enum import Enum
@@ -37,7 +37,31 @@ cdef extern from "hdlConvertor/verilogPreproc/macro_def_verilog.h" namespace "hd
                         const string & body)
 
 cdef extern from "hdlConvertor/verilogPreproc/macroDB.h" namespace "hdlConvertor::verilog_pp":
-    ctypedef map[string, aMacroDef * ] MacroDB
+    cdef cppclass MacroDB:
+        cppclass const_iterator:
+            const pair[string, aMacroDef * ]& operator*()
+            const_iterator operator++()
+            bint operator==(const_iterator)
+            bint operator!=(const_iterator)
+        const_iterator begin()
+        const_iterator end()
+        const_iterator find(const string & name)
+        # the definition from the DB or from its base, NULL if not defined
+        aMacroDef * get(const string & name)
+        bint contains(const string & name)
+        const_iterator erase(const_iterator) except +
+        void insert_or_assign(const string & name, aMacroDef * d)
+        size_t size()
+        void clear()
+        void set_persistent(const string & name, bool is_persistent) except +
+
+cdef extern from "hdlConvertor/verilogPreproc/includeCache.h" namespace "hdlConvertor::verilog_pp":
+    cdef cppclass IncludeCache:
+        bool enabled
+        size_t get_hit_cnt()
+        size_t get_miss_cnt()
+        size_t get_guard_skip_cnt()
+        void clear()
 
 # [TODO] use smart pointers as this potentially can cause segfault if used incorrectly
 cdef class MacroDefVerilogProxy:
@@ -51,13 +75,18 @@ cdef class MacroDefVerilogProxy:
     :ivar thisptr: C++ pointer on MacroDefVerilog object
     :ivar is_reference_borrowed: flag which tells if the C++ object should be deallocated
         after this python proxy is deallocated
+    :ivar _db: the MacroDB which contains the C++ object (NULL if it is not in any)
+    :ivar _db_key: the name of the C++ object in the _db
     """
     cdef MacroDefVerilog * thisptr
     cdef bint is_reference_borrowed 
+    cdef MacroDB * _db
+    cdef string _db_key
 
     def __cinit__(self):
         self.thisptr = NULL
         self.is_reference_borrowed = False
+        self._db = NULL
 
     def get_body(self):
         """
@@ -115,7 +144,11 @@ cdef class MacroDefVerilogProxy:
 
     @is_persistent.setter
     def is_persistent(self, value):
-        self.thisptr.is_persistent = value
+        if self._db != NULL:
+            # the MacroDB tracks the non persistent macros
+            self._db.set_persistent(self._db_key, value)
+        else:
+            self.thisptr.is_persistent = value
 
     @property
     def defined_in_file(self):
@@ -175,7 +208,7 @@ class NonAccessibleCppObject:
     pass
 
 
-ctypedef map[string, aMacroDef * ].iterator MacroDB_iterator
+ctypedef MacroDB.const_iterator MacroDB_iterator
 
 cdef MacroDB_iterator_key(MacroDB_iterator it):
     k = < object > deref(it).first
@@ -185,21 +218,26 @@ cdef MacroDB_iterator_key(MacroDB_iterator it):
 # typedef because dynamc_cast type can not end with '*'
 ctypedef MacroDefVerilog * MacroDefVerilogPtr 
 
-cdef MacroDB_iterator_value(MacroDB_iterator it):
+cdef MacroDB_value(MacroDB * db, const string & key, aMacroDef * v):
     cdef MacroDefVerilog * v_v
-    v = deref(it).second
     assert v != NULL, "MacroDB contains nullptr, but it should not be there"
     v_v = dynamic_cast[MacroDefVerilogPtr](v)
     if v_v != NULL:
         p = MacroDefVerilogProxy()
         (< MacroDefVerilogProxy > p).thisptr = v_v
         (< MacroDefVerilogProxy > p).is_reference_borrowed = True
+        (< MacroDefVerilogProxy > p)._db = db
+        (< MacroDefVerilogProxy > p)._db_key = key
         return p
 
     # Backup case, if object is something unknown to this cython implementation
     return NonAccessibleCppObject()
 
+cdef MacroDB_iterator_value(MacroDB * db, MacroDB_iterator it):
+    return MacroDB_value(db, deref(it).first, deref(it).second)
+
 cdef class CppStdMapIterator:
+    cdef MacroDB * db
     cdef MacroDB_iterator it
     cdef MacroDB_iterator end
     cdef object t
@@ -217,9 +255,9 @@ cdef class CppStdMapIterator:
             if self.t == CppStdMapIteratorType.KEYS:
                 res = MacroDB_iterator_key(self.it)
             elif self.t == CppStdMapIteratorType.VALUES:
-                res = MacroDB_iterator_value(self.it)
+                res = MacroDB_iterator_value(self.db, self.it)
             elif self.t == CppStdMapIteratorType.ITEMS:
-                res = (MacroDB_iterator_key(self.it), MacroDB_iterator_value(self.it))
+                res = (MacroDB_iterator_key(self.it), MacroDB_iterator_value(self.db, self.it))
             else:
                 raise AssertionError(self.t)
 
@@ -228,51 +266,71 @@ cdef class CppStdMapIterator:
 
 _RaiseKeyError = object()  # singleton for no-default behavior of CppStdMapProxy
 cdef class CppStdMapProxy:
+    """
+    The dict like proxy of the MacroDB of the HdlConvertor
+
+    :ivar _lock: the lock of the HdlConvertor, held during the access to the items
+    :note: the iteration is not protected by the lock
+    """
     cdef MacroDB * thisptr
+    cdef object _lock
 
     @staticmethod
-    cdef from_ptr(MacroDB * thisptr):
+    cdef from_ptr(MacroDB * thisptr, object lock):
         self = CppStdMapProxy()
         self.thisptr = thisptr
+        self._lock = lock
         return self
+
     def get(self, key, value=None):
-        v = deref(self.thisptr).find(self.__keytransform__(key))
-        if v == deref(self.thisptr).end():
-            return value
-        else:
-            return MacroDB_iterator_value(v)
+        cdef string k = self.__keytransform__(key)
+        cdef aMacroDef * v
+        with self._lock:
+            v = deref(self.thisptr).get(k)
+            if v == NULL:
+                return value
+            else:
+                return MacroDB_value(self.thisptr, k, v)
 
     def setdefault(self, k, default=None):
-        v = deref(self.thisptr).find(self.__keytransform__(k))
-        if v == deref(self.thisptr).end():
-            self[k] = default
-            return default
-        else:
-            return MacroDB_iterator_value(v)
+        cdef string _k = self.__keytransform__(k)
+        cdef aMacroDef * v
+        with self._lock:
+            v = deref(self.thisptr).get(_k)
+            if v != NULL:
+                return MacroDB_value(self.thisptr, _k, v)
+        self[k] = default
+        return default
 
     def pop(self, k, v=_RaiseKeyError):
-        it = deref(self.thisptr).find(self.__keytransform__(k))
-        if it == deref(self.thisptr).end():
-            if v is _RaiseKeyError:
-                raise KeyError()
+        cdef string _k = self.__keytransform__(k)
+        cdef aMacroDef * d
+        with self._lock:
+            d = deref(self.thisptr).get(_k)
+            if d == NULL:
+                if v is _RaiseKeyError:
+                    raise KeyError()
+                else:
+                    return v
             else:
-                return v
-        else:
-            return MacroDB_iterator_value(it)
+                return MacroDB_value(self.thisptr, _k, d)
 
     def __getitem__(self, key):
         """
         :type key: str
         """
-        v = deref(self.thisptr).find(self.__keytransform__(key))
-        if v == deref(self.thisptr).end():
-            raise KeyError()
-        else:
-            return MacroDB_iterator_value(v)
+        cdef string k = self.__keytransform__(key)
+        cdef aMacroDef * v
+        with self._lock:
+            v = deref(self.thisptr).get(k)
+            if v == NULL:
+                raise KeyError()
+            else:
+                return MacroDB_value(self.thisptr, k, v)
 
     def __contains__(self, key):
-        v = deref(self.thisptr).find(self.__keytransform__(key))
-        return v != deref(self.thisptr).end()
+        with self._lock:
+            return deref(self.thisptr).contains(self.__keytransform__(key))
 
     def __setitem__(self, key, value):
         cdef aMacroDef * v = NULL
@@ -287,22 +345,28 @@ cdef class CppStdMapProxy:
             v = (< MacroDefVerilogProxy > v_v).thisptr
             # the c++ object now belongs to the MacroDB object
             (< MacroDefVerilogProxy > v_v).is_reference_borrowed = True
+            (< MacroDefVerilogProxy > v_v)._db = self.thisptr
+            (< MacroDefVerilogProxy > v_v)._db_key = self.__keytransform__(key)
 
         # [TODO] it may be better to let user specify this flag directly
         v.is_persistent = True
-        deref(self.thisptr)[self.__keytransform__(key)] = v
+        with self._lock:
+            deref(self.thisptr).insert_or_assign(self.__keytransform__(key), v)
 
     def __delitem__(self, key):
-        # self.thisptr.erase(self.__keytransform__(key))
-        v = deref(self.thisptr).find(self.__keytransform__(key))
-        if v == deref(self.thisptr).end():
-            raise KeyError()
-        else:
-            del deref(v).second
-            deref(self.thisptr).erase(v)
+        cdef aMacroDef * d
+        with self._lock:
+            v = deref(self.thisptr).find(self.__keytransform__(key))
+            if v == deref(self.thisptr).end():
+                raise KeyError()
+            else:
+                d = deref(v).second
+                deref(self.thisptr).erase(v)
+                del d
 
     def __iter(self, t):
         cdef CppStdMapIterator self_it = CppStdMapIterator(t)
+        self_it.db = self.thisptr
         self_it.it = deref(self.thisptr).begin()
         self_it.end = deref(self.thisptr).end()
         return self_it
@@ -317,7 +381,8 @@ cdef class CppStdMapProxy:
         return self.__iter(CppStdMapIteratorType.KEYS)
 
     def __len__(self):
-        return deref(self.thisptr).size()
+        with self._lock:
+            return deref(self.thisptr).size()
 
     def __keytransform__(self, key):
         return str_encode(key)
@@ -329,7 +394,8 @@ cdef class CppStdMapProxy:
     def clear(self):
         for v in self.values():
             del v
-        deref(self.thisptr).clear()
+        with self._lock:
+            deref(self.thisptr).clear()
 
     def copy(self):
         raise AssertionError(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <list>
 #include <iostream>
@@ -9,7 +10,9 @@
 #include <hdlConvertor/conversion_exception.h>
 #include <hdlConvertor/syntaxErrorLogger.h>
 #include <hdlConvertor/language.h>
+#include <hdlConvertor/parseCache.h>
 #include <hdlConvertor/parserContainer.h>
+#include <hdlConvertor/universal_fs.h>
 #include <hdlConvertor/hdlObjects/hdlContext.h>
 #include <hdlConvertor/verilogPreproc/verilogPreproc.h>
 
@@ -19,23 +22,105 @@ class Convertor {
 
 public:
 	bool hierarchyOnly;
-	static bool debug;
+	static std::atomic<bool> debug;
 	hdlObjects::HdlContext& c;
 	verilog_pp::MacroDB defineDB;
+	// the prediction mode used by SV/VHDL parsers
+	PredictionStrategy prediction;
+	ParserStats stats;
+	// cache of the preprocessed include files (shared by all parsed files)
+	verilog_pp::IncludeCache include_cache;
+	// if true the inactive `ifdef branches in the files are skipped without lexing
+	// (see VerilogPreprocContainer::fast_ifdef_skip)
+	bool preproc_fast_ifdef_skip;
+	// if true only the lines with directives and macros are processed by the preprocessor
+	// lexer and parser (see VerilogPreprocContainer::fast_copy)
+	bool preproc_fast_copy;
+	// if true the nested macro calls are expanded without the preprocessor lexer and parser
+	// if possible (see VerilogPreprocContainer::fast_macro_expansion)
+	bool preproc_fast_macro_expansion;
+	// if true the AST objects are allocated in the ObjectArena of the HdlContext
+	// (allocated in large blocks and released at once with the context)
+	bool ast_arena;
+	// on-disk cache of the parsed ASTs (disabled by default, see ParseCache)
+	ParseCache parse_cache;
 
 	Convertor(hdlObjects::HdlContext& c);
 
+	/*
+	 * Parse the files and append the result to the context "c"
+	 *
+	 * :param jobs: the number of worker threads used for parsing
+	 *     (0 = number of hardware threads, 1 = parse in this thread)
+	 * :note: in parallel mode each file is parsed to its own HdlContext
+	 *     with its own copy of the persistent preprocessor macros,
+	 *     the results are appended to "c" in the order of fileNames
+	 * */
 	void parse(const std::vector<std::string> &fileNames, Language lang,
-			std::vector<std::string> incdirs, bool hierarchyOnly, bool debug);
+			std::vector<std::string> incdirs, bool hierarchyOnly, bool debug,
+			size_t jobs = 1);
 	void parse_str(const std::string &hdl_str, Language lang,
 			std::vector<std::string> incdirs, bool hierarchyOnly, bool debug);
+	/*
+	 * Append the objects from the binary AST file (see HdlAstBinaryWriter) to the context "c"
+	 *
+	 * :throw std::runtime_error: if the file can not be read or it is not a valid binary AST file
+	 * 		(the objects of "c" are not modified)
+	 * */
+	void load_ast(const std::filesystem::path &file_name);
+
+	/*
+	 * Parse the files and discard the result, only to fill the prediction DFA of the parsers
+	 *
+	 * :note: the DFA of ANTLR4 parser is shared by all instances of the parser in this process,
+	 *     after the warm up all subsequent parsing (from any Convertor) uses the learned DFA states
+	 *     and does not have to perform the costly ATN simulation again
+	 * :note: the syntax errors in the files are ignored
+	 * :note: the DFA can not be stored to a file and loaded in an other process,
+	 *     in antlr4 C++ runtime the DFA states reference ATN config sets and shared prediction
+	 *     contexts which have no serialization, a loaded DFA could not be extended by the parser
+	 * */
+	void warmup_dfa(const std::vector<std::string> &fileNames, Language lang,
+			std::vector<std::string> incdirs);
+	/*
+	 * :return: the number of DFA states currently learned by the parser for the language
+	 * :note: does not wait for the parsers running in other threads, the states which they
+	 *     are adding at the moment may not be counted yet
+	 * */
+	static size_t get_dfa_state_cnt(Language lang);
 
 	std::string verilog_pp(const std::string &filename,
 			const std::vector<std::string> incdirs, Language lang);
+	/*
+	 * Preprocess the file and write the output to the sink as it is produced
+	 * (the output is not kept in memory)
+	 * */
+	void verilog_pp(const std::string &filename,
+			const std::vector<std::string> incdirs, Language lang,
+			PreprocOutputSink &sink);
 	std::string verilog_pp_str(const std::string &verilog_str,
 			const std::vector<std::string> incdirs, Language lang);
 
 	virtual ~Convertor();
+
+protected:
+	// cached snapshot of the persistent macros of defineDB
+	std::shared_ptr<verilog_pp::MacroDBSnapshot> persistent_macro_defs;
+	size_t persistent_macro_defs_version;
+
+	/*
+	 * :return: the snapshot of the persistent macros of defineDB which is used
+	 * 		as a base of the temporary MacroDB instances (rebuilt only if defineDB changed)
+	 * */
+	std::shared_ptr<verilog_pp::MacroDBSnapshot> get_persistent_macro_defs();
+	/*
+	 * :param use_parse_cache: if false the file is always parsed (parse_cache is not used)
+	 * */
+	void parse_file(const std::string &fileName, Language lang,
+			std::vector<std::string> &incdirs, hdlObjects::HdlContext &ctx,
+			verilog_pp::MacroDB &_defineDB, bool use_parse_cache = true);
+	void parse_parallel(const std::vector<std::string> &fileNames,
+			Language lang, std::vector<std::string> &incdirs, size_t jobs);
 };
 
 }
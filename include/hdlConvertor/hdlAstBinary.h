@@ -0,0 +1,407 @@
+#pragma once
+
+#include <stdint.h>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <hdlConvertor/universal_fs.h>
+#include <hdlConvertor/hdlObjects/hdlCall.h>
+#include <hdlConvertor/hdlObjects/hdlCompInstance.h>
+#include <hdlConvertor/hdlObjects/hdlContext.h>
+#include <hdlConvertor/hdlObjects/hdlFunctionDef.h>
+#include <hdlConvertor/hdlObjects/hdlLibrary.h>
+#include <hdlConvertor/hdlObjects/hdlModuleDec.h>
+#include <hdlConvertor/hdlObjects/hdlModuleDef.h>
+#include <hdlConvertor/hdlObjects/hdlNamespace.h>
+#include <hdlConvertor/hdlObjects/hdlStm_others.h>
+#include <hdlConvertor/hdlObjects/hdlStmAssign.h>
+#include <hdlConvertor/hdlObjects/hdlStmBlock.h>
+#include <hdlConvertor/hdlObjects/hdlStmCase.h>
+#include <hdlConvertor/hdlObjects/hdlStmExpr.h>
+#include <hdlConvertor/hdlObjects/hdlStmFor.h>
+#include <hdlConvertor/hdlObjects/hdlStmIf.h>
+#include <hdlConvertor/hdlObjects/hdlStmProcess.h>
+#include <hdlConvertor/hdlObjects/hdlStmWhile.h>
+#include <hdlConvertor/hdlObjects/hdlValue.h>
+#include <hdlConvertor/hdlObjects/hdlVariableDef.h>
+#include <hdlConvertor/hdlObjects/iHdlExpr.h>
+#include <hdlConvertor/hdlObjects/iHdlStatement.h>
+
+namespace hdlConvertor {
+
+/*
+ * Compact binary serialization of the HdlContext
+ *
+ * The file is designed to be memory mapped and read in place, the nodes are accessed
+ * without the deserialization of the whole tree (similar to flatbuffers).
+ * All numbers are little-endian uint32_t aligned to 4B, the references to the nodes
+ * and lists are the offsets from the beginning of the file (0 = nullptr/None).
+ *
+ * * header: "HDLB", version, offset of the root node (HDLB_CONTEXT),
+ *   offset of the string table, offset of the position table, size of the file, 2x reserved
+ * * node: uint16_t kind (HdlAstBinaryNodeKind), uint16_t number of fields,
+ *   index in the position table (HdlAstBinary::NONE if not known), fields
+ * * list: number of items, items
+ * * string table: number of strings, offsets[number of strings + 1] (relative to the end
+ *   of the offsets), the data of the strings (not terminated by \0, the string 0 is always "")
+ * * position table: number of positions, {start_line, stop_line, start_column, stop_column, file (str)}
+ *
+ * The fields of the nodes are specified next to HdlAstBinaryNodeKind items,
+ * "str" is the index in the string table, "node"/"list" are the offsets and the "flags"
+ * are the HdlAstBinaryFlags. The format version is incremented on every incompatible change.
+ * */
+enum HdlAstBinaryNodeKind {
+	HDLB_CONTEXT = 1, // objs: list
+	HDLB_LIBRARY, // name: str, doc: str
+	HDLB_NAMESPACE, // name: str, doc: str, flags, objs: list
+	HDLB_MODULE_DEC, // name: str, doc: str, generics: list, ports: list
+	HDLB_MODULE_DEF, // name: str, doc: str, entity_name: node, objs: list
+	HDLB_COMP_INSTANCE, // doc: str, name: node, entity_name: node, generic_map: list, port_map: list
+	HDLB_VARIABLE_DEF, // name: str, doc: str, type: node, value: node, direction (HdlDirection), flags
+	HDLB_FUNCTION_DEF, // name: str, doc: str, return_t: node, params: list (0 if None), body: list, flags
+
+	// the statements start with HdlAstBinary::STM_FIELD_CNT fields: doc: str, labels: list (of str), flags
+	HDLB_STM_EXPR, // expr: node
+	HDLB_STM_NOP,
+	HDLB_STM_BREAK,
+	HDLB_STM_CONTINUE,
+	HDLB_STM_BLOCK, // statements: list
+	HDLB_STM_IF, // cond: node, if_true: node, elifs: list (of HDLB_EXPR_AND_STM), if_false: node
+	HDLB_STM_CASE, // select_on: node, cases: list (of HDLB_EXPR_AND_STM), default: node
+	HDLB_STM_FOR, // init: node, cond: node, step: node, body: node
+	HDLB_STM_FOR_IN, // var_defs: list, collection: node, body: node
+	HDLB_STM_RETURN, // val: node
+	HDLB_STM_ASSIGN, // dst: node, src: node, time_delay: node, event_delay: list (0 if None), flags
+	HDLB_STM_WHILE, // cond: node, body: node
+	HDLB_STM_DO_WHILE, // body: node, cond: node
+	HDLB_STM_PROCESS, // sensitivity: list (0 if None), body: node
+	HDLB_STM_WAIT, // val: list
+	HDLB_STM_IMPORT, // path: list
+	HDLB_EXPR_AND_STM, // expr: node, stm: node (item of the if/case, not a statement)
+
+	// expressions
+	HDLB_CALL, // op: str (HdlOperatorType_toString), operands: list
+	HDLB_ID, // name: str
+	HDLB_STRING, // value: str
+	HDLB_INT, // value_low, value_high (int64_t), bits (int32_t, -1 if not specified)
+	HDLB_BITSTRING, // value: str, base, bits (int32_t, -1 if not specified)
+	HDLB_FLOAT, // value_low, value_high (the bits of the double)
+	HDLB_ARRAY, // items: list
+	HDLB_NULL,
+	HDLB_OPEN,
+	HDLB_ALL,
+	HDLB_OTHERS,
+	HDLB_TYPE_T,
+	HDLB_AUTO_T,
+	HDLB_EXPR_NONE, // iHdlExpr without the data
+};
+
+const char* HdlAstBinaryNodeKind_toString(HdlAstBinaryNodeKind k);
+
+enum HdlAstBinaryFlags {
+	// HDLB_NAMESPACE
+	HDLB_FLAG_DEFS_ONLY = 1 << 0,
+	// HDLB_VARIABLE_DEF
+	HDLB_FLAG_IS_LATCHED = 1 << 0,
+	HDLB_FLAG_IS_CONST = 1 << 1,
+	HDLB_FLAG_IS_STATIC = 1 << 2,
+	// HDLB_FUNCTION_DEF (+ HDLB_FLAG_IS_STATIC)
+	HDLB_FLAG_IS_OPERATOR = 1 << 0,
+	HDLB_FLAG_IS_VIRTUAL = 1 << 3,
+	HDLB_FLAG_IS_TASK = 1 << 4,
+	HDLB_FLAG_IS_DECLARATION_ONLY = 1 << 5,
+	// statements
+	HDLB_FLAG_IN_PREPROC = 1 << 0,
+	// HDLB_STM_ASSIGN
+	HDLB_FLAG_IS_BLOCKING = 1 << 0,
+};
+
+class HdlAstBinary {
+public:
+	static constexpr char MAGIC[4] = { 'H', 'D', 'L', 'B' };
+	static constexpr uint32_t VERSION = 1;
+	static constexpr uint32_t NONE = UINT32_MAX;
+	static constexpr size_t HEADER_SIZE = 8 * sizeof(uint32_t);
+	static constexpr size_t NODE_HEADER_SIZE = 2 * sizeof(uint32_t);
+	static constexpr size_t STM_FIELD_CNT = 3;
+	static constexpr size_t POSITION_SIZE = 5;
+
+	// convert the native uint32_t to/from the little-endian
+	static inline uint32_t to_le32(uint32_t v) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		return __builtin_bswap32(v);
+#else
+		return v;
+#endif
+	}
+};
+
+/*
+ * Writer of the binary AST format (see HdlAstBinaryNodeKind)
+ *
+ * :note: the file is built in memory and written at once
+ * */
+class HdlAstBinaryWriter {
+	std::vector<uint32_t> _nodes;
+	std::vector<uint32_t> _positions;
+	std::unordered_map<std::string, uint32_t> _string_ids;
+	std::vector<const std::string*> _strings;
+	// HdlSymbol::id() -> index in the string table
+	std::unordered_map<const void*, uint32_t> _symbol_ids;
+
+	// :return: the offset of the next node/list in the file
+	uint32_t offset() const;
+	uint32_t str(const std::string &s);
+	uint32_t str(const hdlObjects::HdlSymbol &s);
+	uint32_t position(const hdlObjects::Position &pos);
+	uint32_t node(HdlAstBinaryNodeKind kind, const hdlObjects::Position *pos,
+			std::initializer_list<uint32_t> fields);
+	uint32_t list(const std::vector<uint32_t> &items);
+	template<typename OBJ_T>
+	uint32_t list(const std::vector<OBJ_T> &objs) {
+		std::vector<uint32_t> items;
+		items.reserve(objs.size());
+		for (auto &o : objs)
+			items.push_back(write(o));
+		return list(items);
+	}
+	template<typename OBJ_T>
+	uint32_t list(const std::unique_ptr<std::vector<OBJ_T>> &objs) {
+		if (!objs)
+			return 0;
+		return list(*objs);
+	}
+	template<typename T>
+	uint32_t write(const std::unique_ptr<T> &o) {
+		return write(o.get());
+	}
+	// the node with the common fields of the statement before the fields
+	uint32_t stm_node(HdlAstBinaryNodeKind kind,
+			const hdlObjects::iHdlStatement *o,
+			std::initializer_list<uint32_t> fields);
+
+	uint32_t write(const std::string &o);
+	uint32_t write(const hdlObjects::HdlExprAndStm &o);
+	uint32_t write(const hdlObjects::iHdlObj *o);
+	uint32_t write(const hdlObjects::iHdlExpr *o);
+	uint32_t write(const hdlObjects::iHdlStatement *o);
+	uint32_t write(const hdlObjects::HdlLibrary *o);
+	uint32_t write(const hdlObjects::HdlNamespace *o);
+	uint32_t write(const hdlObjects::HdlModuleDec *o);
+	uint32_t write(const hdlObjects::HdlModuleDef *o);
+	uint32_t write(const hdlObjects::HdlCompInstance *o);
+	uint32_t write(const hdlObjects::HdlVariableDef *o);
+	uint32_t write(const hdlObjects::HdlFunctionDef *o);
+	uint32_t write(const hdlObjects::HdlStmExpr *o);
+	uint32_t write(const hdlObjects::HdlStmNop *o);
+	uint32_t write(const hdlObjects::HdlStmBreak *o);
+	uint32_t write(const hdlObjects::HdlStmContinue *o);
+	uint32_t write(const hdlObjects::HdlStmBlock *o);
+	uint32_t write(const hdlObjects::HdlStmIf *o);
+	uint32_t write(const hdlObjects::HdlStmCase *o);
+	uint32_t write(const hdlObjects::HdlStmFor *o);
+	uint32_t write(const hdlObjects::HdlStmForIn *o);
+	uint32_t write(const hdlObjects::HdlStmReturn *o);
+	uint32_t write(const hdlObjects::HdlStmAssign *o);
+	uint32_t write(const hdlObjects::HdlStmWhile *o);
+	uint32_t write(const hdlObjects::HdlStmDoWhile *o);
+	uint32_t write(const hdlObjects::HdlStmProcess *o);
+	uint32_t write(const hdlObjects::HdlStmWait *o);
+	uint32_t write(const hdlObjects::HdlStmImport *o);
+
+public:
+	// :param first_obj: the index of the first object of ctx.objs which is written
+	void write(const hdlObjects::HdlContext &ctx, std::ostream &out,
+			size_t first_obj = 0);
+	void write(const hdlObjects::HdlContext &ctx,
+			const std::filesystem::path &file_name, size_t first_obj = 0);
+};
+
+class HdlAstBinaryFile;
+class HdlAstBinaryList;
+
+class HdlAstBinaryPosition {
+public:
+	uint32_t start_line;
+	uint32_t stop_line;
+	uint32_t start_column;
+	uint32_t stop_column;
+	// empty if the file is not known
+	std::string_view file;
+};
+
+/*
+ * The view of the node in the HdlAstBinaryFile (valid only while the file is opened)
+ *
+ * :note: the null node (nullptr in the AST) is represented by the node with offset 0
+ * :note: the fields are accessed by the index specified in HdlAstBinaryNodeKind,
+ * 		the accessors throw std::out_of_range if the file is corrupted
+ * */
+class HdlAstBinaryNode {
+	const HdlAstBinaryFile *_file;
+	uint32_t _offset;
+public:
+	HdlAstBinaryNode(const HdlAstBinaryFile *file, uint32_t offset);
+
+	bool is_null() const {
+		return _offset == 0;
+	}
+	uint32_t offset() const {
+		return _offset;
+	}
+	HdlAstBinaryNodeKind kind() const;
+	size_t field_cnt() const;
+	bool has_position() const;
+	HdlAstBinaryPosition position() const;
+
+	uint32_t u32(size_t field_i) const;
+	int32_t i32(size_t field_i) const;
+	std::string_view str(size_t field_i) const;
+	HdlAstBinaryNode node(size_t field_i) const;
+	HdlAstBinaryList list(size_t field_i) const;
+	// the value of HDLB_INT
+	int64_t int_value() const;
+	// the value of HDLB_FLOAT
+	double float_value() const;
+};
+
+/*
+ * The view of the list in the HdlAstBinaryFile, the items are nodes or strings
+ * (depending on the field, see HdlAstBinaryNodeKind)
+ * */
+class HdlAstBinaryList {
+	const HdlAstBinaryFile *_file;
+	uint32_t _offset;
+public:
+	HdlAstBinaryList(const HdlAstBinaryFile *file, uint32_t offset);
+
+	bool is_null() const {
+		return _offset == 0;
+	}
+	uint32_t offset() const {
+		return _offset;
+	}
+	size_t size() const;
+	HdlAstBinaryNode operator[](size_t i) const;
+	std::string_view str(size_t i) const;
+};
+
+/*
+ * Reader of the binary AST format, the file is memory mapped
+ * (if supported on the platform) and the nodes are read on demand
+ *
+ * :attention: the nodes/lists/strings are valid only while this object exists
+ * */
+class HdlAstBinaryFile {
+	const uint8_t *_data;
+	size_t _size;
+	void *_mapping;
+	size_t _mapping_size;
+	std::string _owned_data;
+
+	uint32_t _strings_cnt;
+	const uint8_t *_string_offsets;
+	const char *_string_data;
+	uint32_t _positions_cnt;
+	uint32_t _positions;
+
+	void load(const uint8_t *data, size_t size);
+
+public:
+	/*
+	 * :throw std::runtime_error: if the file can not be opened or it is not in supported format
+	 * */
+	HdlAstBinaryFile(const std::filesystem::path &file_name);
+	// the data has to live longer than this object
+	HdlAstBinaryFile(const uint8_t *data, size_t size);
+	HdlAstBinaryFile(const HdlAstBinaryFile &other) = delete;
+	HdlAstBinaryFile& operator=(const HdlAstBinaryFile &other) = delete;
+
+	uint32_t version() const;
+	HdlAstBinaryNode root() const;
+	std::string_view str(uint32_t i) const;
+	HdlAstBinaryPosition position(uint32_t i) const;
+	// :return: the uint32_t on the offset in the file (checks the bounds)
+	uint32_t u32_at(size_t offset) const;
+
+	~HdlAstBinaryFile();
+};
+
+/*
+ * Reconstruction of the HdlContext from the binary AST format (inverse of the HdlAstBinaryWriter)
+ *
+ * :note: the names are interned in the SymbolTable of the context, the objects are allocated
+ * 		in the ObjectArena::current (if set)
+ * :note: in HDLCONVERTOR_COMPACT_POSITION mode the positions are resolved from a SourceLines
+ * 		table created for the loaded file (the positions with unknown line or column are not known)
+ * */
+class HdlAstBinaryLoader {
+	const HdlAstBinaryFile &_file;
+	hdlObjects::HdlContext &_ctx;
+	// index in the string table -> symbol
+	std::unordered_map<uint32_t, hdlObjects::HdlSymbol> _symbols;
+	// the file names shared by the positions
+	std::unordered_map<std::string_view, std::shared_ptr<const std::string>> _files;
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+	// each position has its own start and stop line in this table (see position())
+	std::unique_ptr<SourceLines> _lines;
+	size_t _lines_end;
+	std::unordered_map<std::string_view, size_t> _file_ids;
+#endif
+
+	hdlObjects::HdlSymbol symbol(const HdlAstBinaryNode &n, size_t field_i);
+	hdlObjects::Position position(const HdlAstBinaryNode &n);
+	/*
+	 * :return: the node/list in the field of the parent
+	 * :throw std::runtime_error: if it is not stored before the parent in the file
+	 * 		(the children are always written first, anything else is a corrupted file)
+	 * */
+	HdlAstBinaryNode child(const HdlAstBinaryNode &parent, size_t field_i);
+	HdlAstBinaryList child_list(const HdlAstBinaryNode &parent,
+			size_t field_i);
+	template<typename OBJ_T, typename LOAD_FN>
+	void load_list(const HdlAstBinaryNode &parent, size_t field_i,
+			std::vector<OBJ_T> &res, LOAD_FN load_item) {
+		auto l = child_list(parent, field_i);
+		res.reserve(l.size());
+		for (size_t i = 0; i < l.size(); i++) {
+			auto item = l[i];
+			if (item.offset() >= l.offset())
+				throw std::runtime_error(
+						"the binary AST file has invalid reference");
+			res.push_back(load_item(item));
+		}
+	}
+	std::vector<std::string> load_str_list(const HdlAstBinaryNode &parent,
+			size_t field_i);
+
+	std::unique_ptr<hdlObjects::iHdlObj> load_obj(const HdlAstBinaryNode &n);
+	std::unique_ptr<hdlObjects::iHdlExpr> load_expr(const HdlAstBinaryNode &n);
+	std::unique_ptr<std::vector<std::unique_ptr<hdlObjects::iHdlExpr>>> load_expr_list(
+			const HdlAstBinaryNode &parent, size_t field_i);
+	std::unique_ptr<hdlObjects::iHdlStatement> load_stm(
+			const HdlAstBinaryNode &n);
+	hdlObjects::HdlExprAndStm load_expr_and_stm(const HdlAstBinaryNode &n);
+	std::unique_ptr<hdlObjects::HdlVariableDef> load_var(
+			const HdlAstBinaryNode &n);
+	std::unique_ptr<hdlObjects::HdlFunctionDef> load_function(
+			const HdlAstBinaryNode &n);
+
+public:
+	HdlAstBinaryLoader(const HdlAstBinaryFile &file,
+			hdlObjects::HdlContext &ctx);
+	/*
+	 * Append the objects from the file to the context
+	 *
+	 * :throw std::runtime_error: if the file is corrupted (the context is not modified)
+	 * */
+	void load();
+};
+
+}
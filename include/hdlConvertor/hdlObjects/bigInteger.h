@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdint.h>
 #include <string>
+#include <string_view>
 
 namespace hdlConvertor {
 namespace hdlObjects {
@@ -8,8 +10,12 @@ namespace hdlObjects {
 /*
  * Container of the bitstring or the exact integer value
  *
- * @note if bitstring_base == INVALID_BASE the integer value "val" is used
- * 		otherwise the "bitstring" is used
+ * The integer value and the bitstrings up to INLINE_BITSTRING_SIZE characters
+ * are stored inline in the object (no heap allocation), only the longer bitstrings
+ * are allocated on the heap.
+ *
+ * @note if get_bitstring_base() == INVALID_BASE the integer value get_val() is used
+ * 		otherwise the get_bitstring() is used
  * */
 class BigInteger {
 public:
@@ -19,15 +25,36 @@ public:
 	static constexpr int DEC_BASE = 10;
 	static constexpr int HEX_BASE = 16;
 	static constexpr int CHAR_BASE = 256;
+	static constexpr size_t INLINE_BITSTRING_SIZE = 16;
+
+protected:
+	union {
+		int64_t _val;
+		char _bitstring_inline[INLINE_BITSTRING_SIZE];
+		char *_bitstring_heap;
+	};
+	uint32_t _bitstring_size;
+	int16_t _bitstring_base;
 
-	int64_t val;
-	std::string bitstring;
-	int bitstring_base;
+	void _set_bitstring(std::string_view bit_string);
+	void _release();
 
+public:
 	BigInteger(int64_t v);
-	BigInteger(const std::string & _bit_string, int base);
+	BigInteger(std::string_view _bit_string, int base);
+	BigInteger(const BigInteger &other);
+	BigInteger(BigInteger &&other);
+	BigInteger& operator=(const BigInteger &other);
+	BigInteger& operator=(BigInteger &&other);
 
 	bool is_bitstring() const;
+	// :return: the integer value (0 for the bitstring)
+	int64_t get_val() const;
+	// :return: the bitstring (empty for the integer value)
+	std::string_view get_bitstring() const;
+	int get_bitstring_base() const;
+
+	~BigInteger();
 };
 
 
@@ -20,6 +20,8 @@ public:
 	HdlCall(HdlOperatorType operatorType, std::unique_ptr<iHdlExpr> op0);
 	HdlCall(std::unique_ptr<iHdlExpr> op0, HdlOperatorType operatorType,
 			std::unique_ptr<iHdlExpr> op1);
+	HdlCall(HdlOperatorType operatorType,
+			std::vector<std::unique_ptr<iHdlExpr>> &&operands);
 
 	static HdlCall* call(std::unique_ptr<iHdlExpr> fn,
 			std::vector<std::unique_ptr<iHdlExpr>> &operands);
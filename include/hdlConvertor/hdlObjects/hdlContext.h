@@ -3,17 +3,37 @@
 #include <vector>
 #include <memory>
 #include <hdlConvertor/hdlObjects/iHdlObj.h>
+#include <hdlConvertor/hdlObjects/objectArena.h>
+#include <hdlConvertor/hdlObjects/hdlSymbol.h>
+#include <hdlConvertor/sourceLines.h>
 
 namespace hdlConvertor {
 namespace hdlObjects {
 
 /*
  * Container of any HDL objects
+ *
+ * :ivar arenas: the memory of the objects allocated in ObjectArena
+ * 		(declared before objs so the objects are destroyed first)
+ * :ivar symbol_tables: the tables of the HdlSymbol instances used by the objects
+ * :ivar source_lines: the line tables of the parsed inputs used by the compact Position
+ * 		of the objects (empty if HDLCONVERTOR_COMPACT_POSITION is not used)
  * */
 class HdlContext {
 public:
+	std::vector<std::unique_ptr<ObjectArena>> arenas;
+	std::vector<std::unique_ptr<SymbolTable>> symbol_tables;
+	std::vector<std::unique_ptr<SourceLines>> source_lines;
 	std::vector<std::unique_ptr<iHdlObj>> objs;
 
+	/*
+	 * :return: the arena for the objects of this context (created on first use)
+	 * */
+	ObjectArena& get_arena();
+	/*
+	 * :return: the table for the symbols of the objects of this context (created on first use)
+	 * */
+	SymbolTable& get_symbol_table();
 	~HdlContext();
 };
 
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <hdlConvertor/hdlObjects/bigInteger.h>
+#include <hdlConvertor/hdlObjects/hdlOperatorType.h>
+#include <hdlConvertor/hdlObjects/hdlSymbol.h>
+#include <hdlConvertor/hdlObjects/hdlValue.h>
+#include <hdlConvertor/hdlObjects/position.h>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+class iHdlExpr;
+
+enum HdlExprNodeKind {
+	EXPR_NODE_NONE, // nullptr operand or iHdlExpr without data
+	EXPR_NODE_CALL,
+	EXPR_NODE_VALUE,
+};
+
+/*
+ * The node of HdlExprTree
+ *
+ * :ivar op: the operator of the EXPR_NODE_CALL
+ * :ivar value_type: the type of the EXPR_NODE_VALUE
+ * :ivar bits: the width of the symb_INT value (-1 if not specified)
+ * :ivar value: index of the value in HdlExprTree::ints/floats/symbols/strings
+ * 		for symb_INT/symb_FLOAT/symb_ID/symb_STRING
+ * :ivar operands_begin: index of the first operand of the call or item of the symb_ARRAY
+ * 		in HdlExprTree::operands
+ * :ivar operands_cnt: number of the operands/items
+ * */
+class HdlExprNode {
+public:
+	HdlExprNodeKind kind;
+	HdlOperatorType op;
+	HdlValueType value_type;
+	int bits;
+	uint32_t value;
+	uint32_t operands_begin;
+	uint32_t operands_cnt;
+};
+
+/*
+ * Flat representation of the expressions, all nodes are stored in a single array
+ * and refer to their operands by index (instead of iHdlExpr -> iHdlExprItem -> vector<unique_ptr<iHdlExpr>>
+ * which requires multiple heap objects per operator)
+ *
+ * The operands of the node always have smaller index than the node itself
+ * (the nodes are in post-order if appended from iHdlExpr), the node can be
+ * an operand of multiple nodes.
+ *
+ * :ivar nodes: the nodes of all expressions in this tree
+ * :ivar with_positions: if false the positions of the nodes are not stored
+ * 		(e.g. for the conversions which do not use the positions of the expressions)
+ * :ivar positions: the positions of the nodes (positions[i] belongs to nodes[i],
+ * 		empty if with_positions is false)
+ * :ivar operands: the indexes of the operands of the nodes (see HdlExprNode::operands_begin)
+ * :ivar ints: the values of symb_INT nodes
+ * :ivar floats: the values of symb_FLOAT nodes
+ * :ivar symbols: the values of symb_ID nodes
+ * :ivar strings: the values of symb_STRING nodes
+ * */
+class HdlExprTree {
+public:
+	using node_id = uint32_t;
+
+	bool with_positions;
+	std::vector<HdlExprNode> nodes;
+	std::vector<Position> positions;
+	std::vector<node_id> operands;
+	std::vector<BigInteger> ints;
+	std::vector<double> floats;
+	std::vector<HdlSymbol> symbols;
+	std::vector<std::string> strings;
+
+	HdlExprTree(bool with_positions = true);
+
+	node_id add_none();
+	// add the value without data (symb_NULL, symb_OPEN, symb_ALL, symb_OTHERS, symb_T, symb_AUTO)
+	node_id add_value(HdlValueType value_type);
+	node_id add_id(const HdlSymbol &name);
+	node_id add_str(const std::string &str);
+	node_id add_int(const BigInteger &val, int bits = -1);
+	node_id add_float(double val);
+	node_id add_array(const std::vector<node_id> &items);
+	node_id add_call(HdlOperatorType op, const std::vector<node_id> &args);
+
+	const HdlExprNode& operator[](node_id n) const {
+		return nodes[n];
+	}
+	const node_id* operands_begin(const HdlExprNode &n) const {
+		return operands.data() + n.operands_begin;
+	}
+	const node_id* operands_end(const HdlExprNode &n) const {
+		return operands.data() + n.operands_begin + n.operands_cnt;
+	}
+	// :return: the last added node (the root of the last appended expression)
+	node_id root() const {
+		return nodes.size() - 1;
+	}
+	size_t size() const {
+		return nodes.size();
+	}
+	void clear();
+
+	/*
+	 * Append the flat copy of the expression (the expression is not modified)
+	 *
+	 * :return: the id of the root node of the expression
+	 * */
+	node_id append(const iHdlExpr *expr);
+	static HdlExprTree from_expr(const iHdlExpr &expr,
+			bool with_positions = true);
+	/*
+	 * Rebuild the pointer based expression from the node
+	 * (for the code which requires iHdlExpr)
+	 * */
+	std::unique_ptr<iHdlExpr> to_expr(node_id n) const;
+	std::unique_ptr<iHdlExpr> to_expr() const {
+		return to_expr(root());
+	}
+
+protected:
+	node_id _add_node(HdlExprNodeKind kind);
+	// :raise std::out_of_range: if any of the operands is not added yet
+	void _check_operands(const node_id *begin, const node_id *end) const;
+	void _set_operands(HdlExprNode &n, const node_id *begin,
+			const node_id *end);
+};
+
+}
+}
@@ -17,6 +17,7 @@ public:
 
 	std::vector<std::unique_ptr<iHdlObj>> objs;
 
+	HdlModuleDef();
 	~HdlModuleDef();
 };
 
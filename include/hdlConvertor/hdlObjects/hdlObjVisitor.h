@@ -0,0 +1,287 @@
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+#include <hdlConvertor/hdlObjects/iHdlObj.h>
+#include <hdlConvertor/hdlObjects/iHdlExprItem.h>
+#include <hdlConvertor/hdlObjects/iHdlExpr.h>
+#include <hdlConvertor/hdlObjects/iHdlStatement.h>
+#include <hdlConvertor/hdlObjects/hdlCall.h>
+#include <hdlConvertor/hdlObjects/hdlValue.h>
+#include <hdlConvertor/hdlObjects/hdlLibrary.h>
+#include <hdlConvertor/hdlObjects/hdlNamespace.h>
+#include <hdlConvertor/hdlObjects/hdlModuleDec.h>
+#include <hdlConvertor/hdlObjects/hdlModuleDef.h>
+#include <hdlConvertor/hdlObjects/hdlCompInstance.h>
+#include <hdlConvertor/hdlObjects/hdlVariableDef.h>
+#include <hdlConvertor/hdlObjects/hdlFunctionDef.h>
+#include <hdlConvertor/hdlObjects/hdlStmAssign.h>
+#include <hdlConvertor/hdlObjects/hdlStmBlock.h>
+#include <hdlConvertor/hdlObjects/hdlStmCase.h>
+#include <hdlConvertor/hdlObjects/hdlStmExpr.h>
+#include <hdlConvertor/hdlObjects/hdlStmFor.h>
+#include <hdlConvertor/hdlObjects/hdlStmIf.h>
+#include <hdlConvertor/hdlObjects/hdlStmProcess.h>
+#include <hdlConvertor/hdlObjects/hdlStmWhile.h>
+#include <hdlConvertor/hdlObjects/hdlStm_others.h>
+
+/*
+ * Type dispatch for the HDL AST objects based on iHdlObj::obj_kind and iHdlExprItem::item_kind
+ * (a switch and static_cast instead of a chain of dynamic_cast)
+ * */
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+/*
+ * The kind of the objects of the type T (specialized for each AST class)
+ * */
+template<typename T>
+struct HdlObjKindOf;
+template<>
+struct HdlObjKindOf<iHdlExpr> {
+	static constexpr HdlObjKind value = OBJ_EXPR;
+};
+template<>
+struct HdlObjKindOf<HdlLibrary> {
+	static constexpr HdlObjKind value = OBJ_LIBRARY;
+};
+template<>
+struct HdlObjKindOf<HdlNamespace> {
+	static constexpr HdlObjKind value = OBJ_NAMESPACE;
+};
+template<>
+struct HdlObjKindOf<HdlModuleDec> {
+	static constexpr HdlObjKind value = OBJ_MODULE_DEC;
+};
+template<>
+struct HdlObjKindOf<HdlModuleDef> {
+	static constexpr HdlObjKind value = OBJ_MODULE_DEF;
+};
+template<>
+struct HdlObjKindOf<HdlCompInstance> {
+	static constexpr HdlObjKind value = OBJ_COMP_INSTANCE;
+};
+template<>
+struct HdlObjKindOf<HdlVariableDef> {
+	static constexpr HdlObjKind value = OBJ_VARIABLE_DEF;
+};
+template<>
+struct HdlObjKindOf<HdlFunctionDef> {
+	static constexpr HdlObjKind value = OBJ_FUNCTION_DEF;
+};
+template<>
+struct HdlObjKindOf<HdlStmAssign> {
+	static constexpr HdlObjKind value = OBJ_STM_ASSIGN;
+};
+template<>
+struct HdlObjKindOf<HdlStmBlock> {
+	static constexpr HdlObjKind value = OBJ_STM_BLOCK;
+};
+template<>
+struct HdlObjKindOf<HdlStmBreak> {
+	static constexpr HdlObjKind value = OBJ_STM_BREAK;
+};
+template<>
+struct HdlObjKindOf<HdlStmCase> {
+	static constexpr HdlObjKind value = OBJ_STM_CASE;
+};
+template<>
+struct HdlObjKindOf<HdlStmContinue> {
+	static constexpr HdlObjKind value = OBJ_STM_CONTINUE;
+};
+template<>
+struct HdlObjKindOf<HdlStmDoWhile> {
+	static constexpr HdlObjKind value = OBJ_STM_DO_WHILE;
+};
+template<>
+struct HdlObjKindOf<HdlStmExpr> {
+	static constexpr HdlObjKind value = OBJ_STM_EXPR;
+};
+template<>
+struct HdlObjKindOf<HdlStmFor> {
+	static constexpr HdlObjKind value = OBJ_STM_FOR;
+};
+template<>
+struct HdlObjKindOf<HdlStmForIn> {
+	static constexpr HdlObjKind value = OBJ_STM_FOR_IN;
+};
+template<>
+struct HdlObjKindOf<HdlStmIf> {
+	static constexpr HdlObjKind value = OBJ_STM_IF;
+};
+template<>
+struct HdlObjKindOf<HdlStmImport> {
+	static constexpr HdlObjKind value = OBJ_STM_IMPORT;
+};
+template<>
+struct HdlObjKindOf<HdlStmNop> {
+	static constexpr HdlObjKind value = OBJ_STM_NOP;
+};
+template<>
+struct HdlObjKindOf<HdlStmProcess> {
+	static constexpr HdlObjKind value = OBJ_STM_PROCESS;
+};
+template<>
+struct HdlObjKindOf<HdlStmReturn> {
+	static constexpr HdlObjKind value = OBJ_STM_RETURN;
+};
+template<>
+struct HdlObjKindOf<HdlStmWait> {
+	static constexpr HdlObjKind value = OBJ_STM_WAIT;
+};
+template<>
+struct HdlObjKindOf<HdlStmWhile> {
+	static constexpr HdlObjKind value = OBJ_STM_WHILE;
+};
+template<typename T>
+struct HdlExprItemKindOf;
+template<>
+struct HdlExprItemKindOf<HdlCall> {
+	static constexpr HdlExprItemKind value = EXPR_ITEM_CALL;
+};
+template<>
+struct HdlExprItemKindOf<HdlValue> {
+	static constexpr HdlExprItemKind value = EXPR_ITEM_VALUE;
+};
+inline bool is_statement(HdlObjKind k) {
+	return k >= OBJ_STM_ASSIGN;
+}
+
+/*
+ * :return: the object casted to T if it is an instance of T else nullptr
+ * 		(the replacement of dynamic_cast for the AST classes)
+ * */
+template<typename T>
+const T* hdl_obj_cast(const iHdlObj *o) {
+	if (o && o->obj_kind == HdlObjKindOf<T>::value)
+		return static_cast<const T*>(o);
+	return nullptr;
+}
+template<typename T>
+T* hdl_obj_cast(iHdlObj *o) {
+	return const_cast<T*>(hdl_obj_cast<T>(static_cast<const iHdlObj*>(o)));
+}
+template<>
+inline const iHdlStatement* hdl_obj_cast<iHdlStatement>(const iHdlObj *o) {
+	if (o && is_statement(o->obj_kind))
+		return static_cast<const iHdlStatement*>(o);
+	return nullptr;
+}
+
+template<typename T>
+const T* hdl_expr_item_cast(const iHdlExprItem *o) {
+	if (o && o->item_kind == HdlExprItemKindOf<T>::value)
+		return static_cast<const T*>(o);
+	return nullptr;
+}
+template<typename T>
+T* hdl_expr_item_cast(iHdlExprItem *o) {
+	return const_cast<T*>(hdl_expr_item_cast<T>(
+			static_cast<const iHdlExprItem*>(o)));
+}
+
+/*
+ * Call the visitor with the statement casted to its actual type
+ *
+ * :param visitor: a callable object with an overload for a const pointer of each statement class
+ * 		(e.g. a generic lambda, an overload for a base class can handle multiple classes),
+ * 		all overloads have to return the same type
+ * */
+template<typename VISITOR_T>
+auto visit_iHdlStatement(const iHdlStatement &o, VISITOR_T &&visitor) {
+	switch (o.obj_kind) {
+	case OBJ_STM_ASSIGN:
+		return visitor(static_cast<const HdlStmAssign*>(&o));
+	case OBJ_STM_BLOCK:
+		return visitor(static_cast<const HdlStmBlock*>(&o));
+	case OBJ_STM_BREAK:
+		return visitor(static_cast<const HdlStmBreak*>(&o));
+	case OBJ_STM_CASE:
+		return visitor(static_cast<const HdlStmCase*>(&o));
+	case OBJ_STM_CONTINUE:
+		return visitor(static_cast<const HdlStmContinue*>(&o));
+	case OBJ_STM_DO_WHILE:
+		return visitor(static_cast<const HdlStmDoWhile*>(&o));
+	case OBJ_STM_EXPR:
+		return visitor(static_cast<const HdlStmExpr*>(&o));
+	case OBJ_STM_FOR:
+		return visitor(static_cast<const HdlStmFor*>(&o));
+	case OBJ_STM_FOR_IN:
+		return visitor(static_cast<const HdlStmForIn*>(&o));
+	case OBJ_STM_IF:
+		return visitor(static_cast<const HdlStmIf*>(&o));
+	case OBJ_STM_IMPORT:
+		return visitor(static_cast<const HdlStmImport*>(&o));
+	case OBJ_STM_NOP:
+		return visitor(static_cast<const HdlStmNop*>(&o));
+	case OBJ_STM_PROCESS:
+		return visitor(static_cast<const HdlStmProcess*>(&o));
+	case OBJ_STM_RETURN:
+		return visitor(static_cast<const HdlStmReturn*>(&o));
+	case OBJ_STM_WAIT:
+		return visitor(static_cast<const HdlStmWait*>(&o));
+	case OBJ_STM_WHILE:
+		return visitor(static_cast<const HdlStmWhile*>(&o));
+	default:
+		throw std::runtime_error(
+				std::string("Invalid kind of iHdlStatement:")
+						+ HdlObjKind_toString(o.obj_kind));
+	}
+}
+
+/*
+ * Call the visitor with the object casted to its actual type
+ *
+ * :note: the statements are passed as iHdlStatement (to allow the processing
+ * 		of their common properties), use visit_iHdlStatement to resolve them further
+ * :see: visit_iHdlStatement
+ * */
+template<typename VISITOR_T>
+auto visit_iHdlObj(const iHdlObj &o, VISITOR_T &&visitor) {
+	switch (o.obj_kind) {
+	case OBJ_EXPR:
+		return visitor(static_cast<const iHdlExpr*>(&o));
+	case OBJ_LIBRARY:
+		return visitor(static_cast<const HdlLibrary*>(&o));
+	case OBJ_NAMESPACE:
+		return visitor(static_cast<const HdlNamespace*>(&o));
+	case OBJ_MODULE_DEC:
+		return visitor(static_cast<const HdlModuleDec*>(&o));
+	case OBJ_MODULE_DEF:
+		return visitor(static_cast<const HdlModuleDef*>(&o));
+	case OBJ_COMP_INSTANCE:
+		return visitor(static_cast<const HdlCompInstance*>(&o));
+	case OBJ_VARIABLE_DEF:
+		return visitor(static_cast<const HdlVariableDef*>(&o));
+	case OBJ_FUNCTION_DEF:
+		return visitor(static_cast<const HdlFunctionDef*>(&o));
+	default:
+		if (is_statement(o.obj_kind))
+			return visitor(static_cast<const iHdlStatement*>(&o));
+		throw std::runtime_error(
+				std::string("Invalid kind of iHdlObj:")
+						+ HdlObjKind_toString(o.obj_kind));
+	}
+}
+
+/*
+ * Call the visitor with the expression item casted to its actual type
+ *
+ * :see: visit_iHdlStatement
+ * */
+template<typename VISITOR_T>
+auto visit_iHdlExprItem(const iHdlExprItem &o, VISITOR_T &&visitor) {
+	switch (o.item_kind) {
+	case EXPR_ITEM_CALL:
+		return visitor(static_cast<const HdlCall*>(&o));
+	case EXPR_ITEM_VALUE:
+		return visitor(static_cast<const HdlValue*>(&o));
+	default:
+		throw std::runtime_error("Invalid kind of iHdlExprItem");
+	}
+}
+
+}
+}
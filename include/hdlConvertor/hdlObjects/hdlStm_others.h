@@ -7,14 +7,26 @@ namespace hdlObjects {
  * HDL AST node for loop-control statements
  * */
 class HdlStmBreak: public iHdlStatement {
+public:
+	HdlStmBreak() :
+			iHdlStatement(OBJ_STM_BREAK) {
+	}
 };
 class HdlStmContinue: public iHdlStatement {
+public:
+	HdlStmContinue() :
+			iHdlStatement(OBJ_STM_CONTINUE) {
+	}
 };
 
 /*
  * HDL AST node for nop statement
  * */
 class HdlStmNop: public iHdlStatement {
+public:
+	HdlStmNop() :
+			iHdlStatement(OBJ_STM_NOP) {
+	}
 };
 
 class HdlStmImport: public iHdlStatement {
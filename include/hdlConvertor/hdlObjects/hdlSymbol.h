@@ -0,0 +1,209 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+class SymbolTable;
+
+/*
+ * The string of the HdlSymbol
+ *
+ * :ivar table: the table which owns this item, the items of the same table are unique
+ * 		(nullptr if the item is owned by the HdlSymbol instances, see HdlSymbol)
+ * :ivar ref_cnt: the number of the HdlSymbol instances which use this item
+ * 		(used only if the item is not owned by a table)
+ * */
+class HdlSymbolItem {
+public:
+	const SymbolTable *table;
+	mutable std::atomic<size_t> ref_cnt;
+	std::string str;
+
+	HdlSymbolItem(const SymbolTable *table, const std::string &str);
+	HdlSymbolItem(const HdlSymbolItem &other) = delete;
+	HdlSymbolItem& operator=(const HdlSymbolItem &other) = delete;
+};
+
+/*
+ * The table of the unique instances of the strings used in the HDL AST (identifiers)
+ *
+ * :ivar current: the table used by the HdlSymbol instances created in this thread
+ * 		(nullptr = the symbols own their strings)
+ * :ivar _items: the unique strings (the key is the view of the string in the item)
+ * :note: the table has to live longer than the symbols created from it
+ * 		(HdlContext owns the table of its objects)
+ * */
+class SymbolTable {
+	std::unordered_map<std::string_view, std::unique_ptr<HdlSymbolItem>> _items;
+
+public:
+	static thread_local SymbolTable *current;
+
+	SymbolTable();
+	SymbolTable(const SymbolTable &other) = delete;
+	SymbolTable& operator=(const SymbolTable &other) = delete;
+
+	/*
+	 * :return: the unique instance of the string in this table
+	 * */
+	const HdlSymbolItem* intern(const std::string &str);
+	size_t size() const;
+};
+
+/*
+ * Set the SymbolTable::current for the lifetime of this object
+ * */
+class SymbolTableScope {
+	SymbolTable *prev;
+public:
+	SymbolTableScope(SymbolTable *table);
+	SymbolTableScope(const SymbolTableScope &other) = delete;
+	SymbolTableScope& operator=(const SymbolTableScope &other) = delete;
+	~SymbolTableScope();
+};
+
+/*
+ * The handle of the interned string (e.g. the name of a signal)
+ *
+ * The same strings from the same SymbolTable share a single instance
+ * and the copy or the comparison of such symbols is a copy/comparison of a pointer.
+ * The symbols created outside of any SymbolTable (SymbolTable::current == nullptr)
+ * share the reference counted string with their copies only
+ * (so the strings are released with the last symbol and there is no process wide table).
+ * The symbol converts implicitly to const std::string & so it can be used
+ * in place of a std::string where it is only read.
+ *
+ * :ivar _item: the item with the string
+ * */
+class HdlSymbol {
+	const HdlSymbolItem *_item;
+
+	static const HdlSymbolItem EMPTY;
+
+	void _acquire() const {
+		if (_item->table == nullptr)
+			_item->ref_cnt++;
+	}
+	void _release() const {
+		if (_item->table == nullptr && --_item->ref_cnt == 0)
+			delete _item;
+	}
+public:
+	HdlSymbol() :
+			_item(&EMPTY) {
+	}
+	HdlSymbol(const std::string &str);
+	HdlSymbol(const char *str) :
+			HdlSymbol(std::string(str)) {
+	}
+	HdlSymbol(const HdlSymbol &other) :
+			_item(other._item) {
+		_acquire();
+	}
+	HdlSymbol(HdlSymbol &&other) :
+			_item(other._item) {
+		other._item = &EMPTY;
+	}
+	HdlSymbol& operator=(const HdlSymbol &other) {
+		other._acquire();
+		_release();
+		_item = other._item;
+		return *this;
+	}
+	HdlSymbol& operator=(HdlSymbol &&other) {
+		if (this != &other) {
+			_release();
+			_item = other._item;
+			other._item = &EMPTY;
+		}
+		return *this;
+	}
+	~HdlSymbol() {
+		_release();
+	}
+
+	const std::string& str() const {
+		return _item->str;
+	}
+	operator const std::string&() const {
+		return _item->str;
+	}
+	const char* c_str() const {
+		return _item->str.c_str();
+	}
+	size_t size() const {
+		return _item->str.size();
+	}
+	bool empty() const {
+		return _item->str.empty();
+	}
+	/*
+	 * :return: the identity of the symbol (same for the same strings from the same SymbolTable)
+	 * */
+	const void* id() const {
+		return _item;
+	}
+
+	bool operator==(const HdlSymbol &other) const {
+		if (_item == other._item)
+			return true;
+		// the items of the same table are unique, the strings are compared only
+		// if the symbols come from a different tables
+		if (_item->table && _item->table == other._item->table)
+			return false;
+		return _item->str == other._item->str;
+	}
+	bool operator!=(const HdlSymbol &other) const {
+		return !(*this == other);
+	}
+	bool operator==(const std::string &other) const {
+		return _item->str == other;
+	}
+	bool operator!=(const std::string &other) const {
+		return _item->str != other;
+	}
+	bool operator==(const char *other) const {
+		return _item->str == other;
+	}
+	bool operator!=(const char *other) const {
+		return _item->str != other;
+	}
+};
+
+inline bool operator==(const std::string &a, const HdlSymbol &b) {
+	return b == a;
+}
+inline bool operator!=(const std::string &a, const HdlSymbol &b) {
+	return b != a;
+}
+inline std::ostream& operator<<(std::ostream &str, const HdlSymbol &s) {
+	return str << s.str();
+}
+inline std::string operator+(const std::string &a, const HdlSymbol &b) {
+	return a + b.str();
+}
+inline std::string operator+(const HdlSymbol &a, const std::string &b) {
+	return a.str() + b;
+}
+
+}
+}
+
+namespace std {
+
+template<>
+struct hash<hdlConvertor::hdlObjects::HdlSymbol> {
+	size_t operator()(const hdlConvertor::hdlObjects::HdlSymbol &s) const {
+		return hash<string>()(s.str());
+	}
+};
+
+}
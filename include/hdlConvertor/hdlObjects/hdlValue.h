@@ -1,9 +1,11 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include <hdlConvertor/hdlObjects/bigInteger.h>
+#include <hdlConvertor/hdlObjects/hdlSymbol.h>
 #include <hdlConvertor/hdlObjects/iHdlExprItem.h>
 
 namespace hdlConvertor {
@@ -27,24 +29,45 @@ class iHdlExpr;
 
 /*
  * HDL AST node for value of any type
+ *
+ * The value is stored in a union, only the member for the type is valid:
+ *
+ * * symb_INT - _int
+ * * symb_FLOAT - _float
+ * * symb_ID - _str
+ * * symb_STRING - _string
+ * * symb_ARRAY - _arr
+ * * others - no value
+ *
+ * :ivar bits: the width of the symb_INT value (-1 if not specified)
+ * :attention: the type can be changed only to the type which uses the same member
+ * :note: the string literals are not interned in the SymbolTable, they are rarely repeated
+ * 		and the table would keep them until the end of the HdlContext
  * */
-class HdlValue: public virtual iHdlExprItem {
+class HdlValue: public iHdlExprItem {
 public:
 	HdlValueType type;
 	int bits;
-	BigInteger _int;
-	double _float;
-	std::string _str;
-	std::unique_ptr<std::vector<std::unique_ptr<iHdlExpr>>> _arr;
+	union {
+		BigInteger _int;
+		double _float;
+		// the name of the ID
+		HdlSymbol _str;
+		// the value of the STRING (a pointer so the size of the HdlValue is not increased)
+		std::unique_ptr<std::string> _string;
+		std::unique_ptr<std::vector<std::unique_ptr<iHdlExpr>>> _arr;
+	};
 
 	HdlValue();
+	// the value is initialized to 0/empty value of the type
 	HdlValue(HdlValueType type);
 	HdlValue(const HdlValue &other);
 	HdlValue(BigInteger __int);
 	HdlValue(const BigInteger &value, int bits);
 	HdlValue(double __float);
 	HdlValue(std::string __str);
-	HdlValue(const std::unique_ptr<std::vector<std::unique_ptr<iHdlExpr>>> arr);
+	HdlValue(std::unique_ptr<std::vector<std::unique_ptr<iHdlExpr>>> arr);
+	HdlValue& operator=(const HdlValue &other) = delete;
 
 	virtual iHdlExprItem* clone() const override;
 
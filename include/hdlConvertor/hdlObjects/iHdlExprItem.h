@@ -1,17 +1,46 @@
 #pragma once
 
+#include <cstddef>
+#include <hdlConvertor/hdlObjects/objectArena.h>
+
 namespace hdlConvertor {
 namespace hdlObjects {
 
+/*
+ * The type of the iHdlExprItem instance
+ * (allows to resolve the type without dynamic_cast, see hdlObjVisitor.h)
+ * */
+enum HdlExprItemKind {
+	EXPR_ITEM_CALL,
+	EXPR_ITEM_VALUE,
+};
+
 /*
  * Interface for data of HDL expression
+ *
+ * :ivar item_kind: the type of this object
  * */
 class iHdlExprItem {
 public:
+	// allocated in ObjectArena::current if set (see ObjectArena)
+	static void* operator new(std::size_t size) {
+		return ObjectArena::allocate_object(size);
+	}
+	static void operator delete(void *ptr) {
+		ObjectArena::deallocate_object(ptr);
+	}
+
+	HdlExprItemKind item_kind;
+
+	iHdlExprItem(HdlExprItemKind _item_kind) :
+			item_kind(_item_kind) {
+	}
 	virtual iHdlExprItem * clone() const = 0;
 	virtual ~iHdlExprItem() {
 	}
 };
+static_assert(alignof(iHdlExprItem) <= ObjectArena::ARENA_OBJ_TAG,
+		"the objects in ObjectArena are not aligned more than ARENA_OBJ_TAG");
 
 }
 }
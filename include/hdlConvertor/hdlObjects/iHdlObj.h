@@ -1,16 +1,69 @@
 #pragma once
 
+#include <cstddef>
+#include <hdlConvertor/hdlObjects/objectArena.h>
+
 namespace hdlConvertor {
 namespace hdlObjects {
 
+/*
+ * The type of the iHdlObj instance
+ * (allows to resolve the type without dynamic_cast, see hdlObjVisitor.h)
+ * */
+enum HdlObjKind {
+	OBJ_EXPR,
+	OBJ_LIBRARY,
+	OBJ_NAMESPACE,
+	OBJ_MODULE_DEC,
+	OBJ_MODULE_DEF,
+	OBJ_COMP_INSTANCE,
+	OBJ_VARIABLE_DEF,
+	OBJ_FUNCTION_DEF,
+	OBJ_STM_ASSIGN,
+	OBJ_STM_BLOCK,
+	OBJ_STM_BREAK,
+	OBJ_STM_CASE,
+	OBJ_STM_CONTINUE,
+	OBJ_STM_DO_WHILE,
+	OBJ_STM_EXPR,
+	OBJ_STM_FOR,
+	OBJ_STM_FOR_IN,
+	OBJ_STM_IF,
+	OBJ_STM_IMPORT,
+	OBJ_STM_NOP,
+	OBJ_STM_PROCESS,
+	OBJ_STM_RETURN,
+	OBJ_STM_WAIT,
+	OBJ_STM_WHILE,
+};
+
+const char* HdlObjKind_toString(HdlObjKind k);
+
 /*
  * Interface for object which can appear in HDL AST
+ *
+ * :ivar obj_kind: the type of this object
  * */
 class iHdlObj {
 public:
+	// allocated in ObjectArena::current if set (see ObjectArena)
+	static void* operator new(std::size_t size) {
+		return ObjectArena::allocate_object(size);
+	}
+	static void operator delete(void *ptr) {
+		ObjectArena::deallocate_object(ptr);
+	}
+
+	HdlObjKind obj_kind;
+
+	iHdlObj(HdlObjKind _obj_kind) :
+			obj_kind(_obj_kind) {
+	}
 	virtual ~iHdlObj() {
 	}
 };
+static_assert(alignof(iHdlObj) <= ObjectArena::ARENA_OBJ_TAG,
+		"the objects in ObjectArena are not aligned more than ARENA_OBJ_TAG");
 
 
 }
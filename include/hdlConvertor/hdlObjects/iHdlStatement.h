@@ -25,7 +25,7 @@ public:
 	// if true the statement is part of VHDL generate or other compile time evaluated statement
 	bool in_preproc;
 
-	iHdlStatement();
+	iHdlStatement(HdlObjKind _obj_kind);
 	virtual ~iHdlStatement() override;
 };
 
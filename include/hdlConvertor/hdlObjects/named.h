@@ -2,6 +2,7 @@
 
 #include <string>
 #include <hdlConvertor/hdlObjects/position.h>
+#include <hdlConvertor/hdlObjects/hdlSymbol.h>
 
 namespace hdlConvertor {
 namespace hdlObjects {
@@ -11,7 +12,7 @@ namespace hdlObjects {
  * */
 class Named {
 public:
-	std::string name;
+	HdlSymbol name;
 
 	Named();
 	Named(const std::string &name);
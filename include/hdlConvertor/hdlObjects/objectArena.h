@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+/*
+ * Bump allocator for the AST objects (iHdlObj, iHdlExprItem)
+ *
+ * The objects allocated while the arena is ObjectArena::current are placed
+ * in the large blocks of this arena, the delete of such object only calls its destructor
+ * and the memory is released at once with the whole arena.
+ *
+ * :ivar current: the arena used for the allocation of the AST objects in this thread
+ * 		(nullptr = the objects are allocated on the heap)
+ * :ivar _blocks: the memory blocks of this arena (aligned to HEAP_OBJ_ALIGN)
+ * :ivar _free_ptr: the first free byte in the actual block
+ * :ivar _free_size: the number of free bytes in the actual block
+ * :ivar _allocated_size: the total size of all blocks
+ * :note: the arena has to live longer than the objects allocated in it
+ * 		(HdlContext owns the arenas of its objects)
+ * :note: the objects do not have any header, the arena is marked in the address of the object,
+ * 		the objects on the heap are aligned to HEAP_OBJ_ALIGN and the objects in the arena
+ * 		are placed at the addresses HEAP_OBJ_ALIGN * n + ARENA_OBJ_TAG, the delete only checks
+ * 		this bit (the AST classes must not require the alignment larger than ARENA_OBJ_TAG)
+ * */
+class ObjectArena {
+	struct BlockDeleter {
+		void operator()(char *b) const;
+	};
+	std::vector<std::unique_ptr<char[], BlockDeleter>> _blocks;
+	char *_free_ptr;
+	size_t _free_size;
+	size_t _allocated_size;
+
+public:
+	static constexpr size_t BLOCK_SIZE = 1 << 20;
+	static constexpr size_t HEAP_OBJ_ALIGN = 16;
+	static constexpr size_t ARENA_OBJ_TAG = HEAP_OBJ_ALIGN / 2;
+	static thread_local ObjectArena *current;
+
+	ObjectArena();
+	ObjectArena(const ObjectArena &other) = delete;
+	ObjectArena& operator=(const ObjectArena &other) = delete;
+
+	void* allocate(size_t size);
+	size_t get_allocated_size() const;
+
+	/*
+	 * The implementation of the operator new/delete of the AST objects
+	 * (the objects allocated in arena and on heap can be mixed)
+	 * */
+	static void* allocate_object(size_t size);
+	static void deallocate_object(void *ptr) {
+		// the memory in arena is released with the arena
+		if (reinterpret_cast<uintptr_t>(ptr) & ARENA_OBJ_TAG)
+			return;
+		::operator delete(ptr, std::align_val_t(HEAP_OBJ_ALIGN));
+	}
+};
+
+/*
+ * Set the ObjectArena::current for the lifetime of this object
+ * */
+class ObjectArenaScope {
+	ObjectArena *prev;
+public:
+	ObjectArenaScope(ObjectArena *arena);
+	ObjectArenaScope(const ObjectArenaScope &other) = delete;
+	ObjectArenaScope& operator=(const ObjectArenaScope &other) = delete;
+	~ObjectArenaScope();
+};
+
+}
+}
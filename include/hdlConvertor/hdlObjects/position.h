@@ -1,6 +1,11 @@
 #pragma once
 #include <stddef.h>
+#include <stdint.h>
 #include <limits>
+#include <memory>
+#include <string>
+
+#include <hdlConvertor/sourceLines.h>
 
 namespace hdlConvertor {
 namespace hdlObjects {
@@ -9,19 +14,78 @@ namespace hdlObjects {
  * Container for position in code.
  * NOTE: stopXX are inclusive coordinates and not one beyond i.e. [startXXX, stopXXX] and not [startXXX, stopXXX)
  * Also, corrdinates are 1-based indexing i.e. first line and column is indexed as 1 and not 0.
+ *
+ * The lines and columns are accessed by get_start_line() etc. which work in both
+ * representations of the position:
+ *
+ * * default - the lines/columns are resolved from the tokens during parsing and stored
+ * 		in the public members startLine/stopLine/startColumn/stopColumn/file
+ * * HDLCONVERTOR_COMPACT_POSITION - only the index of the first character and the length
+ * 		in the parser input are stored, the lines/columns are resolved on demand
+ * 		from the SourceLines table of the parsed input (16B instead of 48B per object),
+ * 		API break: the members startLine etc. do not exist in this mode, only the methods
+ *
+ * :ivar file: the file where the object was defined if it differs from the parsed input
+ * 		(resolved from the source map of the preprocessor, nullptr if not known)
+ * :note: if the source map is available the lines are in the coordinates of the original file,
+ * 		the columns are always in the coordinates of the preprocessor output
+ * :note: in compact mode the stop line/column is computed from start + length, it is the position
+ * 		of the last character of the stop token, in default mode the stop line is the line where
+ * 		the stop token starts and the stop column is its start column + its length - 1,
+ * 		the values differ for the multi-line stop tokens (e.g. a string with the line continuation)
+ * :ivar COMPACT: true if HDLCONVERTOR_COMPACT_POSITION is used
  * */
 class Position {
 public:
 	static constexpr size_t INVALID = std::numeric_limits<size_t>::max();
 
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+	static constexpr bool COMPACT = true;
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+	/*
+	 * :ivar start: index of the first character in the parser input (in characters, same as in ANTLR tokens)
+	 * :ivar length: number of the characters
+	 * :ivar lines: the line table of the parsed input (nullptr if the position is not known)
+	 * :note: the positions in the inputs larger than 4G characters are not known
+	 * */
+	uint32_t start;
+	uint32_t length;
+	const SourceLines *lines;
+
+	Position();
+	Position(uint32_t start, uint32_t length, const SourceLines *lines);
+	template<class ELEM_T>
+	void update_from_elem(ELEM_T *elem) {
+		auto _start = elem->getStart()->getStartIndex();
+		auto _stop = elem->getStop()->getStopIndex();
+		if (SourceLines::current == nullptr || _start >= INVALID_INDEX
+				|| _stop >= INVALID_INDEX) {
+			*this = Position();
+			return;
+		}
+		start = _start;
+		length = _stop >= _start ? _stop - _start + 1 : 0;
+		lines = SourceLines::current;
+	}
+	size_t get_start_line() const;
+	size_t get_stop_line() const;
+	size_t get_start_column() const;
+	size_t get_stop_column() const;
+	std::shared_ptr<const std::string> get_file() const;
+#else
+	static constexpr bool COMPACT = false;
+
 	size_t startLine;
 	size_t stopLine;
 	size_t startColumn;
 	size_t stopColumn;
+	std::shared_ptr<const std::string> file;
 
 	Position();
 	Position(size_t startLine, size_t stopLine, size_t startColumn,
 			size_t stopColumn);
+	Position(size_t startLine, size_t stopLine, size_t startColumn,
+			size_t stopColumn, std::shared_ptr<const std::string> file);
 	template<class ELEM_T>
 	void update_from_elem(ELEM_T *elem) {
 		startLine = elem->getStart()->getLine();
@@ -29,7 +93,28 @@ public:
 		startColumn = elem->getStart()->getCharPositionInLine() + 1;
 		stopColumn = elem->getStop()->getCharPositionInLine() +
 				(elem->getStop()->getStopIndex() - elem->getStop()->getStartIndex()) + 1;
+		apply_source_map();
+	}
+private:
+	// translate the lines using SourceMap::current (if there is any)
+	void apply_source_map();
+public:
+	size_t get_start_line() const {
+		return startLine;
+	}
+	size_t get_stop_line() const {
+		return stopLine;
+	}
+	size_t get_start_column() const {
+		return startColumn;
+	}
+	size_t get_stop_column() const {
+		return stopColumn;
+	}
+	std::shared_ptr<const std::string> get_file() const {
+		return file;
 	}
+#endif
 	bool isKnown() const;
 };
 
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <iostream>
 
 #include <antlr4-runtime.h>
@@ -8,7 +9,8 @@ namespace hdlConvertor {
 
 class NotImplementedLogger {
 public:
-	static bool ENABLE;
+	// shared by all threads (the parsing may run without the Python GIL)
+	static std::atomic<bool> ENABLE;
 
 	static void print(const char *msg, antlr4::ParserRuleContext *ctx);
 	static void print(const std::string &msg, antlr4::ParserRuleContext *ctx);
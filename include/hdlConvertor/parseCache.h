@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <string>
+#include <string_view>
+
+#include <hdlConvertor/language.h>
+#include <hdlConvertor/sourceMap.h>
+#include <hdlConvertor/hdlObjects/hdlContext.h>
+
+namespace hdlConvertor {
+
+/*
+ * On-disk cache of the parsed ASTs in the binary AST format (see HdlAstBinaryWriter),
+ * shared by all Convertor instances and processes which use the same directory
+ *
+ * The entry is identified by the hash of everything the AST depends on: the parser input
+ * (the output of the preprocessor for Verilog/SV), its source map, the language,
+ * the hierarchyOnly flag, the format of the positions and the version of the binary AST format.
+ * The preprocessor always runs (the macros defined by the file are the same as without the cache),
+ * the cache replaces the lexing, parsing and the construction of the AST.
+ *
+ * :ivar dir: the directory with the cache files (UTF-8, the cache is disabled if empty)
+ * :note: the inputs with syntax errors are not stored, the errors while writing or reading
+ * 		the cache are ignored (the input is parsed as if it was not cached)
+ * :note: the entry is written to a temporary file and renamed, the concurrent writers
+ * 		of the same entry do not corrupt it
+ * */
+class ParseCache {
+	std::atomic<size_t> _hit_cnt;
+	std::atomic<size_t> _miss_cnt;
+
+public:
+	std::string dir;
+
+	ParseCache();
+	ParseCache(const ParseCache &other) = delete;
+	ParseCache& operator=(const ParseCache &other) = delete;
+
+	bool enabled() const {
+		return !dir.empty();
+	}
+	/*
+	 * :param source_map: the source map of the input (nullptr if the input was not preprocessed)
+	 * :return: the key of the entry for the input
+	 * */
+	std::string key(std::string_view input, const SourceMap *source_map,
+			Language lang, bool hierarchyOnly) const;
+	/*
+	 * Append the objects of the entry to the context
+	 *
+	 * :return: true if the entry was found and loaded
+	 * */
+	bool load(const std::string &key, hdlObjects::HdlContext &ctx);
+	// store the objects of the context starting from ctx.objs[first_obj]
+	void store(const std::string &key, const hdlObjects::HdlContext &ctx,
+			size_t first_obj);
+
+	size_t get_hit_cnt() const;
+	size_t get_miss_cnt() const;
+	void reset_stats();
+};
+
+}
@@ -4,17 +4,55 @@
 #include <fstream>
 #include <functional>
 #include <memory>
+#include <atomic>
 
 #include <antlr4-runtime.h>
 
 #include <hdlConvertor/hdlObjects/hdlContext.h>
 #include <hdlConvertor/syntaxErrorLogger.h>
 #include <hdlConvertor/notImplementedLogger.h>
+#include <hdlConvertor/parseCache.h>
 #include <hdlConvertor/universal_fs.h>
+#include <hdlConvertor/utf8CharStream.h>
+#include <hdlConvertor/sourceLines.h>
 #include <hdlConvertor/verilogPreproc/macroDB.h>
 
 namespace hdlConvertor {
 
+/*
+ * Strategy of the prediction used by ANTLR4 parsers
+ *
+ * PREDICTION_LL - the full LL prediction (default ANTLR4 behavior)
+ * PREDICTION_SLL_LL - the input is parsed with cheaper SLL prediction and BailErrorStrategy first,
+ *                     if it fails the input is parsed again with the full LL prediction
+ *                     (the result is the same, the SLL fails only on syntax errors or for the ambiguous input)
+ * */
+enum PredictionStrategy {
+	PREDICTION_LL = 0,
+	PREDICTION_SLL_LL = 1,
+};
+
+/*
+ * Counters of the parser container runs (shared between threads)
+ *
+ * :ivar parsed_cnt: number of the inputs processed by ANTLR4 parser
+ * :ivar sll_fallback_cnt: number of the inputs which had to be parsed again
+ * 		with the full LL prediction because the SLL prediction failed
+ * */
+class ParserStats {
+public:
+	std::atomic<size_t> parsed_cnt;
+	std::atomic<size_t> sll_fallback_cnt;
+
+	ParserStats() :
+			parsed_cnt(0), sll_fallback_cnt(0) {
+	}
+	void reset() {
+		parsed_cnt = 0;
+		sll_fallback_cnt = 0;
+	}
+};
+
 template<class antlrLexerT, class antlrParserT, class hdlParserT>
 class iParserContainer {
 public:
@@ -25,8 +63,14 @@ public:
 	std::unique_ptr<hdlParserT> hdlParser;
 	Language lang;
 	verilog_pp::MacroDB &defineDB;
-
-	void initParser(antlr4::ANTLRInputStream &input_stream) {
+	PredictionStrategy prediction;
+	// optional, if specified the counters are updated after each parse
+	ParserStats *stats;
+	// optional, if specified the AST is loaded from the cache if the input was parsed before
+	// (the ANTLR4 parser does not run at all) and stored to it after the parse otherwise
+	ParseCache *parse_cache;
+
+	void initParser(antlr4::CharStream &input_stream) {
 		// create a lexer that feeds off of input CharStream
 		lexer = std::make_unique<antlrLexerT>(&input_stream);
 
@@ -53,28 +97,63 @@ public:
 			verilog_pp::MacroDB &_defineDB) :
 			syntaxErrLogger(), lexer(nullptr), tokens(nullptr), antlrParser(
 					nullptr), hdlParser(nullptr), lang(_lang), defineDB(
-					_defineDB), context(context) {
+					_defineDB), prediction(PredictionStrategy::PREDICTION_LL), stats(
+					nullptr), parse_cache(nullptr), context(context) {
 	}
 
 	virtual void parseFn() = 0;
 
 	void parse_file(const std::filesystem::path &file_name,
 			bool hierarchyOnly) {
-		antlr4::ANTLRFileStream input_stream(file_name.u8string());
+		MmapFileCharStream input_stream(file_name);
 		_parse(input_stream, hierarchyOnly);
 	}
 
 	void parse_str(const std::string &input_str, bool hierarchyOnly) {
-		antlr4::ANTLRInputStream input_stream(input_str);
-		input_stream.name = "<string>";
+		Utf8CharStream input_stream(input_str.data(), input_str.size());
+		input_stream.name = STRING_FILENAME;
 		_parse(input_stream, hierarchyOnly);
 	}
 
-	void _parse(antlr4::ANTLRInputStream &input_stream, bool hierarchyOnly) {
+	void _parse(Utf8CharStream &input_stream, bool hierarchyOnly) {
+		if (!parse_cache || !parse_cache->enabled()) {
+			_parse_input(input_stream, hierarchyOnly);
+			return;
+		}
+		// the input of the parser is already preprocessed and the source map is set
+		// by the caller, the result depends only on them
+		auto key = parse_cache->key(input_stream.get_utf8_data(),
+				SourceMap::current, lang, hierarchyOnly);
+		if (parse_cache->load(key, context))
+			return;
+		size_t first_obj = context.objs.size();
+		_parse_input(input_stream, hierarchyOnly);
+		parse_cache->store(key, context, first_obj);
+	}
+
+	void _parse_input(Utf8CharStream &input_stream, bool hierarchyOnly) {
 		initParser(input_stream);
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+		// the positions of the objects are resolved from the line table of this input
+		context.source_lines.emplace_back(new SourceLines());
+		auto &source_lines = *context.source_lines.back();
+		source_lines.build(input_stream.get_utf8_data(), input_stream.is_ascii());
+		if (SourceMap::current)
+			source_lines.source_map = *SourceMap::current;
+		SourceLinesScope source_lines_scope(&source_lines);
+#endif
 
 		hdlParser = std::make_unique<hdlParserT>(*antlrParser->getTokenStream(),
 				context, hierarchyOnly);
+		if (stats)
+			stats->parsed_cnt++;
+
+		if (prediction == PredictionStrategy::PREDICTION_SLL_LL
+				&& _parse_sll()) {
+			syntaxErrLogger.error_prefix = "";
+			syntaxErrLogger.check_errors(); // Throw exception if errors
+			return;
+		}
 		// begin parsing at init rule
 		try {
 			parseFn();
@@ -87,6 +166,38 @@ public:
 		syntaxErrLogger.check_errors(); // Throw exception if errors
 	}
 
+	/*
+	 * Try to parse the input with SLL prediction, if it fails
+	 * reset the parser and set it to full LL prediction mode
+	 *
+	 * @return true if the input was successfully parsed
+	 * @note the syntax errors are not reported in SLL stage, because the input is parsed again
+	 * 		in LL mode which reports them
+	 * */
+	bool _parse_sll() {
+		auto interpreter = antlrParser->template getInterpreter<
+				antlr4::atn::ParserATNSimulator>();
+		interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+		antlrParser->setErrorHandler(
+				std::make_shared<antlr4::BailErrorStrategy>());
+		antlrParser->removeErrorListeners();
+		try {
+			parseFn();
+			return true;
+		} catch (const antlr4::ParseCancellationException &e) {
+		}
+		if (stats)
+			stats->sll_fallback_cnt++;
+		// the tokens are already buffered in the token stream, only the parser is restarted
+		tokens->seek(0);
+		antlrParser->reset();
+		interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
+		antlrParser->setErrorHandler(
+				std::make_shared<antlr4::DefaultErrorStrategy>());
+		antlrParser->addErrorListener(&syntaxErrLogger);
+		return false;
+	}
+
 	virtual ~iParserContainer() {
 	}
 };
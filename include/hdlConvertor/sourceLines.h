@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <hdlConvertor/sourceMap.h>
+
+namespace hdlConvertor {
+
+/*
+ * The table of the starts of the lines of the parser input, used to resolve
+ * the lines and columns of the compact Position on demand
+ * (see HDLCONVERTOR_COMPACT_POSITION in Position)
+ *
+ * :ivar line_starts: the index of the first character of each line
+ * 		(in characters of the input, same as the indexes of ANTLR tokens),
+ * 		line_starts[0] == 0
+ * :ivar source_map: the source map of the parser input (empty if the input was not preprocessed)
+ * :note: the lines which start beyond 4G characters are not stored
+ * */
+class SourceLines {
+public:
+	std::vector<uint32_t> line_starts;
+	SourceMap source_map;
+
+	SourceLines();
+	SourceLines(const SourceLines &other) = delete;
+	SourceLines& operator=(const SourceLines &other) = delete;
+
+	/*
+	 * Build the table of the lines for the UTF-8 encoded input
+	 *
+	 * :param is_ascii: if true the input contains only ASCII characters (1 byte per character)
+	 * */
+	void build(std::string_view utf8_data, bool is_ascii);
+	// :return: the 1-based line of the character on index in the parser input
+	size_t get_line(size_t index) const;
+	// :return: the 1-based column of the character on index
+	size_t get_column(size_t index) const;
+	// :return: the line of the character on index in the original file (translated by the source_map)
+	size_t get_src_line(size_t index) const;
+	// :return: the original file of the character on index (nullptr if not known)
+	std::shared_ptr<const std::string> get_file(size_t index) const;
+
+	// the table used for the positions of the objects created by the parser in this thread
+	static thread_local const SourceLines *current;
+};
+
+/*
+ * Set SourceLines::current for the lifetime of this object
+ * */
+class SourceLinesScope {
+	const SourceLines *prev;
+public:
+	SourceLinesScope(const SourceLines *source_lines);
+	SourceLinesScope(const SourceLinesScope &other) = delete;
+	SourceLinesScope& operator=(const SourceLinesScope &other) = delete;
+	~SourceLinesScope();
+};
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace hdlConvertor {
+
+/*
+ * Mapping of the lines of the preprocessor output to the lines of the original files
+ *
+ * The map is range encoded, each range maps the consecutive output lines starting at out_line
+ * to the consecutive lines of the file starting at src_line (or all of them to src_line
+ * if the lines are the result of macro expansion). The range is valid until the start
+ * of the next range.
+ *
+ * :note: the lines are 1-based (same as the lines of ANTLR tokens)
+ * */
+class SourceMap {
+public:
+	class Range {
+	public:
+		size_t out_line;
+		size_t file_id;
+		size_t src_line;
+		bool is_expansion;
+	};
+	// file_id -> file name (the names are shared with the Position objects)
+	std::vector<std::shared_ptr<const std::string>> files;
+	// sorted by out_line
+	std::vector<Range> ranges;
+
+	size_t get_file_id(const std::string &file_name);
+	/*
+	 * Add the range which starts on out_line
+	 * (the range which starts on the same line is replaced, the range is merged
+	 * with the previous one if it is its continuation)
+	 * */
+	void add_range(size_t out_line, size_t file_id, size_t src_line,
+			bool is_expansion);
+	// :return: the range which contains out_line or nullptr if the line is not mapped
+	const Range* find(size_t out_line) const;
+	// :return: the line in the original file for the line of preprocessor output
+	static size_t translate(const Range &r, size_t out_line);
+	void clear();
+
+	// the source map used for the positions of the objects created by the parser in this thread
+	static thread_local const SourceMap *current;
+};
+
+/*
+ * Set SourceMap::current for the lifetime of this object
+ * */
+class SourceMapScope {
+	const SourceMap *prev;
+public:
+	SourceMapScope(const SourceMap *source_map);
+	SourceMapScope(const SourceMapScope &other) = delete;
+	SourceMapScope& operator=(const SourceMapScope &other) = delete;
+	~SourceMapScope();
+};
+
+/*
+ * The destination for the preprocessor output which receives the text
+ * in chunks as it is produced (instead of a single string at the end)
+ * */
+class PreprocOutputSink {
+public:
+	virtual void write(std::string_view data) = 0;
+	virtual ~PreprocOutputSink() {
+	}
+};
+
+class OstreamPreprocOutputSink: public PreprocOutputSink {
+public:
+	std::ostream &os;
+	OstreamPreprocOutputSink(std::ostream &os);
+	virtual void write(std::string_view data) override;
+};
+
+class CallbackPreprocOutputSink: public PreprocOutputSink {
+public:
+	std::function<void(std::string_view)> callback;
+	CallbackPreprocOutputSink(std::function<void(std::string_view)> callback);
+	virtual void write(std::string_view data) override;
+};
+
+/*
+ * The output of the preprocessor with its source map
+ *
+ * :ivar text: the output text (empty if the sink is used)
+ * :ivar sink: if specified the text is written to it instead of the text member
+ * :ivar line: the actual line at the end of the text
+ * :ivar at_line_start: true if the text is empty or ends with a new line
+ * :ivar _recorders: the outputs which receive a copy of everything appended to this output
+ * 		(file_ids is the translation of the file ids of this output to the ids of the recorder)
+ * */
+class PreprocOutput {
+	class Recorder {
+	public:
+		PreprocOutput *out;
+		std::vector<size_t> file_ids;
+	};
+	std::vector<Recorder> _recorders;
+	size_t _translate_file_id(Recorder &r, size_t file_id);
+	void _write(std::string_view str);
+
+public:
+	std::string text;
+	PreprocOutputSink *sink;
+	SourceMap source_map;
+	size_t line;
+	bool at_line_start;
+
+	PreprocOutput(PreprocOutputSink *sink = nullptr);
+	PreprocOutput(const PreprocOutput &other) = delete;
+	PreprocOutput& operator=(const PreprocOutput &other) = delete;
+
+	// append the text which comes from the line src_line of the file
+	void append(std::string_view str, size_t file_id, size_t src_line,
+			bool is_expansion);
+	// append the output of other preprocessor run (the other has to be without sink)
+	void append(const PreprocOutput &other);
+	/*
+	 * Start/stop to copy all appended output also to the recorder
+	 * (used to capture the output of the included file while it is streamed)
+	 * */
+	void add_recorder(PreprocOutput *recorder);
+	void remove_recorder(PreprocOutput *recorder);
+	void clear();
+};
+
+}
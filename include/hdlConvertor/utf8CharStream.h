@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include <antlr4-runtime.h>
+
+#include <hdlConvertor/universal_fs.h>
+
+namespace hdlConvertor {
+
+/*
+ * ANTLR4 CharStream which reads UTF-8 encoded input directly from a memory buffer
+ *
+ * The ANTLRInputStream/ANTLRFileStream always decodes whole input to UTF-32 buffer
+ * (and ANTLRFileStream also reads the file to std::string first).
+ * This stream uses the bytes of the input directly if the input contains only ASCII
+ * characters (which is the typical case for HDL code) and the input is decoded
+ * to UTF-32 buffer only if there is some non-ASCII character.
+ *
+ * :ivar name: the name of the source used in error messages and by `__FILE__
+ * */
+class Utf8CharStream: public antlr4::CharStream {
+protected:
+	// the input buffer (the buffer is not owned by this object if _owned_str is not used)
+	const char *_data;
+	size_t _data_size;
+	// size of the input buffer in bytes (_data_size is in characters)
+	size_t _utf8_size;
+	// decoded input, used only if input is not ASCII only
+	std::u32string _data_utf32;
+	bool _is_ascii;
+	// actual position in the input (in characters)
+	size_t p;
+	// storage for the input if the string was moved in to this object
+	std::string _owned_str;
+
+	Utf8CharStream();
+	void set_data(const char *data, size_t size);
+
+public:
+	std::string name;
+
+	/*
+	 * :param data: the input buffer, the buffer has to live longer than this object
+	 * */
+	Utf8CharStream(const char *data, size_t size);
+	// the string is moved to this object (no copy is performed)
+	Utf8CharStream(std::string &&str);
+	Utf8CharStream(const Utf8CharStream &other) = delete;
+	Utf8CharStream& operator=(const Utf8CharStream &other) = delete;
+
+	bool is_ascii() const;
+	// the UTF-8 encoded input (without BOM)
+	std::string_view get_utf8_data() const;
+
+	virtual void reset();
+	virtual void consume() override;
+	virtual size_t LA(ssize_t i) override;
+	virtual ssize_t mark() override;
+	virtual void release(ssize_t marker) override;
+	virtual size_t index() override;
+	virtual void seek(size_t index) override;
+	virtual size_t size() override;
+	virtual std::string getSourceName() const override;
+	virtual std::string getText(const antlr4::misc::Interval &interval)
+			override;
+	virtual std::string toString() const override;
+
+	virtual ~Utf8CharStream() override;
+};
+
+/*
+ * Utf8CharStream for the file, the file is memory mapped (if supported on the platform)
+ * instead of being read in to memory
+ * */
+class MmapFileCharStream: public Utf8CharStream {
+	void *_mapping;
+	size_t _mapping_size;
+
+public:
+	MmapFileCharStream(const std::filesystem::path &file_name);
+	virtual ~MmapFileCharStream() override;
+};
+
+}
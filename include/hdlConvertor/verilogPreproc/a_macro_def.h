@@ -3,6 +3,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <typeinfo>
 
 #include <antlr4-common.h>
 
@@ -41,6 +42,10 @@ public:
 	aMacroDef(const std::string &name);
 	virtual ~aMacroDef() = default;
 
+	// @return deep copy of this macro definition (used to create independent MacroDB instances)
+	virtual aMacroDef* clone() const = 0;
+	// @return true if the other definition has same type, name and behavior (location is ignored)
+	virtual bool equals(const aMacroDef &other) const;
 	virtual bool requires_args() = 0;
 	virtual std::string replace(std::vector<std::string> args,
 			bool args_specified, VerilogPreproc *pp,
@@ -7,6 +7,7 @@ namespace verilog_pp {
 class MacroDef__LINE__: public aMacroDef {
 public:
 	MacroDef__LINE__();
+	virtual aMacroDef* clone() const override;
 	virtual bool requires_args() override;
 	virtual std::string replace(std::vector<std::string> args,
 			bool args_specified, VerilogPreproc * pp,
@@ -16,6 +17,7 @@ public:
 class MacroDef__FILE__: public aMacroDef {
 public:
 	MacroDef__FILE__();
+	virtual aMacroDef* clone() const override;
 	virtual bool requires_args() override;
 	virtual std::string replace(std::vector<std::string> args,
 			bool args_specified, VerilogPreproc * pp,
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace hdlConvertor {
+namespace verilog_pp {
+
+class IfdefBlock;
+
+/*
+ * One branch of the `ifdef/`ifndef block (`ifdef, `elsif or `else part)
+ *
+ * :ivar cond_id: the name of the macro in the condition (empty for `else)
+ * :ivar text_start: the offset of the first character of the group of lines
+ * 		which is kept if this branch is selected
+ * :ivar text_end: the offset behind the last kept character of the group
+ * 		(the comments at the begin and at the end of the group are not kept,
+ * 		same as in the output of VerilogPreproc)
+ * :ivar nested: the `ifdef/`ifndef blocks inside of this group
+ * */
+class IfdefBranch {
+public:
+	std::string cond_id;
+	size_t text_start;
+	size_t text_end;
+	std::vector<IfdefBlock> nested;
+};
+
+/*
+ * The `ifdef/`ifndef ... `endif block found in the input
+ *
+ * :ivar start: the offset of the '`' of the `ifdef/`ifndef
+ * :ivar end: the offset behind the `endif (including the whitespace consumed by it)
+ * */
+class IfdefBlock {
+public:
+	bool is_negated;
+	size_t start;
+	size_t end;
+	std::vector<IfdefBranch> branches;
+};
+
+/*
+ * Character level scanner which finds the `ifdef/`ifndef blocks in the input
+ * of the preprocessor without the lexer and the parser of the preprocessor.
+ *
+ * The scanner emulates only the parts of the preprocessor lexer required to recognize
+ * where the directives are (comments, strings, escaped identifiers, `define bodies,
+ * macro arguments, `protected blocks). The inactive branches of the blocks can be then skipped
+ * without creating of any tokens or parse tree for them.
+ *
+ * :ivar blocks: the top level blocks in the order of appearance
+ * :ivar directives: the sorted ranges of the input which contain the directives
+ * 		and the macro calls (except `ifdef/`ifndef/`elsif/`else/`endif), each range
+ * 		ends on a token boundary (typically at the end of the line) and only these ranges
+ * 		have to be processed by the preprocessor, the text between them
+ * 		is the same in the output
+ * :ivar blank_outside: true if there are only whitespaces and comments
+ * 		outside of the top level blocks
+ * :note: the scanner is conservative, if the input contains something which the scanner
+ * 		can not interpret exactly as the lexer would (or an error), the scan fails
+ * 		and the input has to be processed by the normal preprocessor
+ * */
+class IfdefScanner {
+	class OpenBlock;
+
+	const char *data;
+	size_t size;
+	size_t p;
+	// the position of the '`' behind the CODE which ends with '/' (the lexer handles "/`" specially)
+	size_t code_slash_end;
+	// true if the last item of directives may be extended up to the end of line
+	bool directive_open;
+	std::vector<OpenBlock> open_blocks;
+
+	void mark_visible(size_t start, size_t end);
+	/*
+	 * Extend the open directive range by the token [start, p)
+	 * :param is_plain_code: true if the token is a CODE which can be split behind a new line
+	 * */
+	void extend_directive(size_t start, bool is_plain_code);
+	bool skip_str();
+	void skip_line_comment();
+	bool skip_comment();
+	bool skip_ws();
+	bool skip_id();
+	bool skip_expr(bool &ends_with_rp);
+	bool skip_define();
+	bool skip_define_params();
+	bool skip_define_body();
+	bool skip_macro_args();
+	bool skip_escaped_quote();
+	bool process_directive();
+	bool process_conditional(const std::string &name, size_t start);
+
+public:
+	std::vector<IfdefBlock> blocks;
+	std::vector<std::pair<size_t, size_t>> directives;
+	bool blank_outside;
+
+	IfdefScanner();
+	/*
+	 * :return: true if the input was scanned successfully, false if the input
+	 * 		has to be processed by the normal preprocessor
+	 * */
+	bool scan(const char *data, size_t size);
+	~IfdefScanner();
+};
+
+}
+}
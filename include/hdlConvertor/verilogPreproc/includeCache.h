@@ -0,0 +1,132 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <hdlConvertor/language.h>
+#include <hdlConvertor/sourceMap.h>
+#include <hdlConvertor/universal_fs.h>
+#include <hdlConvertor/verilogPreproc/a_macro_def.h>
+
+namespace hdlConvertor {
+namespace verilog_pp {
+
+/*
+ * The file which content is wrapped in `ifndef macro_name ... `endif
+ * (the file has no effect if macro_name is defined)
+ *
+ * :ivar text_outside: the output of the preprocessor if the macro_name is defined
+ * 		(whitespace and comments around the `ifndef)
+ * */
+class IncludeGuard {
+public:
+	std::string macro_name;
+	std::string text_outside;
+};
+
+/*
+ * The result of the preprocessing of the included file
+ * and the conditions under which this result is valid
+ *
+ * :ivar mtime: modification time of the file at the time of preprocessing
+ * :ivar file_size: size of the file at the time of preprocessing
+ * :ivar lang: language of the preprocessor
+ * :ivar incdirs: include directories at the time of the include
+ * :ivar nested_include_depth: maximal depth of includes in this file
+ * 		(0 if the file does not include anything)
+ * :ivar macro_deps: macros which were accessed by this file (including the nested includes)
+ * 		and their definition before the first access (nullptr if the macro was not defined)
+ * :ivar side_effects: the defines and undefs performed by the file in order of execution
+ * 		(MacroOp.def == nullptr for undef)
+ * :ivar output: the output of the preprocessor for this file (with its source map)
+ * :ivar include_guard: the include guard detected in this file
+ * :ivar cacheable: false if the result depends on something which is not tracked
+ * 		(e.g. `undefineall)
+ * */
+class IncludeCacheEntry {
+public:
+	class MacroOp {
+	public:
+		std::string name;
+		std::unique_ptr<aMacroDef> def;
+	};
+
+	std::filesystem::file_time_type mtime;
+	uintmax_t file_size;
+	Language lang;
+	std::vector<std::filesystem::path> incdirs;
+	size_t nested_include_depth;
+	std::map<std::string, std::unique_ptr<aMacroDef>> macro_deps;
+	std::vector<MacroOp> side_effects;
+	PreprocOutput output;
+	IncludeGuard include_guard;
+	bool cacheable;
+	// size of the include file stack before the include of this file
+	// (used only during the recording)
+	size_t _incfile_stack_size;
+
+	IncludeCacheEntry();
+
+	// record the definition of the macro if this is a first access of this macro
+	void add_macro_dep(const std::string &name, const aMacroDef *cur_def);
+};
+
+/*
+ * Cache of the preprocessed include files, shared between the files and
+ * the worker threads of the Convertor
+ *
+ * The entry is reused only if the file was not modified and all macros
+ * used by the file (and by the files included from it) have the same definition.
+ * */
+class IncludeCache {
+	std::mutex _lock;
+	std::map<std::filesystem::path,
+			std::vector<std::shared_ptr<const IncludeCacheEntry>>> _entries;
+	std::map<std::filesystem::path, IncludeGuard> _include_guards;
+	size_t _hit_cnt;
+	size_t _miss_cnt;
+	size_t _guard_skip_cnt;
+
+public:
+	// maximum number of variants stored for a single file
+	static constexpr size_t MAX_ENTRIES_PER_FILE = 16;
+	bool enabled;
+
+	IncludeCache();
+	IncludeCache(const IncludeCache &other) = delete;
+	IncludeCache& operator=(const IncludeCache &other) = delete;
+
+	/*
+	 * Get all cached variants of the file (the returned entries are immutable)
+	 * */
+	std::vector<std::shared_ptr<const IncludeCacheEntry>> get(
+			const std::filesystem::path &file_name);
+	void insert(const std::filesystem::path &file_name,
+			std::unique_ptr<IncludeCacheEntry> entry);
+	void register_lookup(bool hit);
+
+	/*
+	 * Include guards detected in the files, the file with the guard is not opened again
+	 * if the guard macro is defined (similar to the multiple include optimization of GCC)
+	 *
+	 * :note: the file modification is not checked, because of this the guards
+	 * 		are cleared on the beginning of each Convertor call
+	 * */
+	bool get_include_guard(const std::filesystem::path &file_name,
+			IncludeGuard &res);
+	void add_include_guard(const std::filesystem::path &file_name,
+			const IncludeGuard &guard);
+	void register_guard_skip();
+	void clear_include_guards();
+
+	size_t get_hit_cnt();
+	size_t get_miss_cnt();
+	size_t get_guard_skip_cnt();
+	void clear();
+};
+
+}
+}
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <deque>
 #include <string>
-#include <map>
+#include <string_view>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <hdlConvertor/language.h>
@@ -10,10 +15,122 @@
 namespace hdlConvertor {
 namespace verilog_pp {
 
+class MacroDBSnapshot;
+
 /**
  * Container to store all the defined macro.
+ *
+ * Hash table indexed by the macro names, the name is stored only once
+ * in the item and the index uses views of it. The API is a subset of the std::map
+ * (but the items are iterated in the order of insertion).
+ *
+ * :ivar _items: the items in the order of insertion (the nodes of std::list are stable,
+ * 		the views in _index remain valid)
+ * :ivar _non_persistent_names: the names of the macros which may be non persistent
+ * 		in the order of the definition, each name only once (checked in extract_non_persistent,
+ * 		so it does not have to scan whole DB, the is_persistent of the definitions
+ * 		in the DB has to be changed by set_persistent())
+ * :ivar _non_persistent_name_set: the views of the strings in _non_persistent_names
+ * 		(the elements of std::deque do not move on push_back)
+ * :ivar _base: optional immutable set of definitions which is visible through this DB
+ * 		if the name is not defined in this DB (copy-on-write layer, the definitions
+ * 		are not copied and the changes in this DB do not affect the base)
+ * :ivar _persistent_version: incremented on each change which may affect the persistent macros
+ * :note: the container does not own the definitions (same as std::map<std::string, aMacroDef*>)
+ * :note: begin(), end(), size(), find() and the erase methods work only with the items of this DB
+ * 		(not with the base), get() and contains() look in to the base as well
  */
-typedef std::map<std::string, aMacroDef*> MacroDB;
+class MacroDB {
+public:
+	typedef std::pair<const std::string, aMacroDef*> value_type;
+	typedef std::list<value_type>::iterator iterator;
+	typedef std::list<value_type>::const_iterator const_iterator;
+
+private:
+	std::list<value_type> _items;
+	std::unordered_map<std::string_view, iterator> _index;
+	std::deque<std::string> _non_persistent_names;
+	std::unordered_set<std::string_view> _non_persistent_name_set;
+	std::shared_ptr<MacroDBSnapshot> _base;
+	size_t _persistent_version;
+
+	// add the name to _non_persistent_names if it is not already there
+	void _track_non_persistent(const std::string &name);
+
+public:
+	MacroDB();
+	MacroDB(const MacroDB &other) = delete;
+	MacroDB& operator=(const MacroDB &other) = delete;
+
+	iterator begin();
+	iterator end();
+	const_iterator begin() const;
+	const_iterator end() const;
+	size_t size() const;
+	bool empty() const;
+
+	// :return: the item of this DB with this name or end() (the base is not searched)
+	iterator find(const std::string &name);
+	const_iterator find(const std::string &name) const;
+	// :return: the definition from this DB or from the base, nullptr if the name is not defined
+	aMacroDef* get(const std::string &name) const;
+	bool contains(const std::string &name) const;
+	/*
+	 * Add the item if the name is not defined in this DB or in the base
+	 *
+	 * :return: true if the item was inserted
+	 * */
+	bool insert(const value_type &item);
+	template<typename ITER_T>
+	void insert(ITER_T first, ITER_T last) {
+		for (; first != last; ++first)
+			insert(*first);
+	}
+	/*
+	 * Set the definition for the name (shadows the definition in the base)
+	 *
+	 * :return: pair<iterator on item with this name, true if the item was inserted>
+	 * */
+	std::pair<iterator, bool> insert_or_assign(const std::string &name,
+			aMacroDef *def);
+	// :throw std::invalid_argument: if the item is from the base
+	iterator erase(const_iterator it);
+	// :return: number of removed items
+	size_t erase(const std::string &name);
+	void clear();
+	/*
+	 * Remove all non persistent macros from this DB
+	 *
+	 * :return: the removed definitions (the caller decides about their lifetime)
+	 * */
+	std::vector<aMacroDef*> extract_non_persistent();
+	// set aMacroDef::is_persistent of the definition with this name in this DB (not in the base)
+	void set_persistent(const std::string &name, bool is_persistent);
+
+	/*
+	 * Create the snapshot of the persistent definitions of this DB (including the base)
+	 * which can be used as a base of other MacroDB instances
+	 * */
+	std::shared_ptr<MacroDBSnapshot> snapshot_persistent() const;
+	void set_base(std::shared_ptr<MacroDBSnapshot> base);
+	const std::shared_ptr<MacroDBSnapshot>& get_base() const;
+	// :return: the number which changes when the persistent macros may have changed
+	size_t get_persistent_version() const;
+};
+
+/*
+ * Immutable set of persistent macro definitions shared as a base of multiple MacroDB instances
+ * (possibly in multiple threads), the definitions are owned by the snapshot
+ * */
+class MacroDBSnapshot {
+public:
+	MacroDB db;
+
+	MacroDBSnapshot();
+	MacroDBSnapshot(const MacroDBSnapshot &other) = delete;
+	MacroDBSnapshot& operator=(const MacroDBSnapshot &other) = delete;
+	~MacroDBSnapshot();
+};
 
 }
 }
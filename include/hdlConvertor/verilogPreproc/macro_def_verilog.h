@@ -61,6 +61,8 @@ public:
 			std::vector<MacroDefVerilog::Fragment> & res);
 	std::pair<size_t, size_t> get_possible_arg_cnt() const;
 	std::string get_possible_arg_cnt_str() const;
+	virtual aMacroDef* clone() const override;
+	virtual bool equals(const aMacroDef &other) const override;
 	virtual bool requires_args() override;
 	// replace method without argument
 	virtual std::string replace(std::vector<std::string> args,
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <map>
+#include <memory>
 #include <sys/stat.h>
 #include <typeinfo>
 
@@ -11,6 +12,7 @@
 
 #include <hdlConvertor/verilogPreproc/verilogPreprocContainer.h>
 #include <hdlConvertor/conversion_exception.h>
+#include <hdlConvertor/sourceMap.h>
 
 namespace hdlConvertor {
 namespace verilog_pp {
@@ -27,6 +29,12 @@ namespace verilog_pp {
  * 			currently parsed (used for detection of cycle in includes)
  * :ivar did_added_incdir: the flag which tells if the directory of this folder
  * 			was added to include directories and thus should be removed after parser ends
+ * :ivar _edits: modifications of the input token stream, start token index -> edit
+ * 			(an edit overrides the edits inside of its range, the tokens without edit
+ * 			are copied to output)
+ * :ivar _flushed: index of the first token which was not yet written to the output
+ * :ivar out: the output where the result is written during the visit
+ * 			(the output of the included files is written there directly)
  **/
 class VerilogPreproc: public verilogPreproc_antlr::verilogPreprocParserBaseVisitor {
 
@@ -34,20 +42,49 @@ class VerilogPreproc: public verilogPreproc_antlr::verilogPreprocParserBaseVisit
 			std::string *str);
 	void replace_context_by_bank(antlr4::ParserRuleContext *ctx);
 
+	/*
+	 * Replacement of the tokens [start:stop+1] (nullptr replacement means deletion)
+	 * */
+	class Edit {
+	public:
+		size_t stop;
+		std::unique_ptr<PreprocOutput> replacement;
+	};
+	std::map<size_t, Edit> _edits;
+	size_t _flushed;
+	// id of the input file in out.source_map
+	size_t _file_id;
+
 public:
 	using verilogPreprocParser = verilogPreproc_antlr::verilogPreprocParser;
 	VerilogPreprocContainer &container;
 	antlr4::CommonTokenStream &_tokens;
 	bool added_incdir;
 	size_t include_depth_limit;
-	antlr4::TokenStreamRewriter _rewriter;
+	PreprocOutput &out;
 
 	VerilogPreproc(VerilogPreprocContainer &container,
-			antlr4::TokenStream &tokens, bool added_incdir,
+			antlr4::TokenStream &tokens, bool added_incdir, PreprocOutput &out,
 			size_t include_depth_limit = 100);
 
 	virtual ~VerilogPreproc();
 
+	/*
+	 * Replace the tokens [start:stop+1] in the output
+	 * (the previous edits in this range are discarded)
+	 * */
+	void replace_tokens(ssize_t start, ssize_t stop,
+			std::unique_ptr<PreprocOutput> replacement);
+	void delete_tokens(ssize_t start, ssize_t stop);
+	/*
+	 * Write the input tokens before the token index end (modified by the edits)
+	 * to the output
+	 * */
+	void flush_output(size_t end);
+
+	virtual antlrcpp::Any visitFile(verilogPreprocParser::FileContext *ctx)
+			override;
+
 	virtual antlrcpp::Any visitResetall(
 			verilogPreprocParser::ResetallContext *ctx) override;
 	virtual antlrcpp::Any visitCelldefine(
@@ -83,6 +120,20 @@ public:
 			std::vector<std::string> &args);
 	virtual antlrcpp::Any visitMacro_call(
 			verilogPreprocParser::Macro_callContext *ctx) override;
+	/*
+	 * Expand the macro calls in the replacement of other macro without running
+	 * the lexer and parser of the preprocessor on it
+	 * (the replacement usually contains just code and other macro calls)
+	 *
+	 * :param line: the line where the str starts (for nested full preprocessor runs)
+	 * :param res: the string where the output is appended
+	 * :return: false if the str contains something which is not supported by this method
+	 * 	(directives, comments, `__LINE__, `" and `` stringification/pasting, errors, ...)
+	 * 	and the full preprocessor has to be used
+	 * 	(the res is not valid in this case)
+	 * */
+	bool expand_macro_calls_fast(const std::string &str, size_t line,
+			std::string &res);
 
 	virtual antlrcpp::Any visitIfdef_directive(
 			verilogPreprocParser::Ifdef_directiveContext *ctx) override;
@@ -100,6 +151,13 @@ public:
 	virtual antlrcpp::Any visitPragma(verilogPreprocParser::PragmaContext *ctx)
 			override;
 
+	/*
+	 * Detect the `ifndef X ... `endif which wraps all the code in the file
+	 * (guard.macro_name is empty if the file does not have such a guard)
+	 * */
+	void detect_include_guard(verilogPreprocParser::FileContext *ctx,
+			IncludeGuard &guard);
+
 	// thorw an error with a file location prompt
 	void throw_input_caused_error(antlr4::ParserRuleContext *ctx,
 			const std::string &msg);
@@ -5,15 +5,70 @@
 #include <hdlConvertor/syntaxErrorLogger.h>
 #include <hdlConvertor/language.h>
 #include <hdlConvertor/universal_fs.h>
+#include <hdlConvertor/utf8CharStream.h>
 #include <hdlConvertor/verilogPreproc/macroDB.h>
+#include <hdlConvertor/verilogPreproc/includeCache.h>
+#include <hdlConvertor/verilogPreproc/ifdefScanner.h>
 
 namespace hdlConvertor {
 namespace verilog_pp {
 
 /*
  * Container for context of preprocessor
+ *
+ * :ivar include_cache: optional cache of the preprocessed include files
+ * :ivar include_cache_recording: cache entries which are currently being recorded
+ * 		(one for each cacheable file on incfile_stack)
+ * :ivar fast_ifdef_skip: if true the `ifdef blocks in the files are resolved by IfdefScanner
+ * 		and the inactive branches are skipped without lexing and parsing
+ * 		(the syntax errors in the inactive branches are not reported in this mode)
+ * :ivar fast_copy: if true only the lines with the directives and macros are processed
+ * 		by the preprocessor lexer and parser, the rest of the file is copied to output
+ * 		as it is (the lines are found by IfdefScanner)
+ * :ivar fast_macro_expansion: if true the macro calls in the replacement of other macro
+ * 		are expanded without the preprocessor lexer and parser if possible
+ * 		(see VerilogPreproc::expand_macro_calls_fast)
  * */
 class VerilogPreprocContainer {
+	bool include_cache_entry_usable(const IncludeCacheEntry &e,
+			std::filesystem::file_time_type mtime, uintmax_t file_size,
+			size_t include_depth_limit);
+	void replay_include_cache_entry(const IncludeCacheEntry &e);
+	// run_preproc_file and store the detected include guard in include_cache
+	void run_preproc_include_file(const std::filesystem::path &file_name,
+			IncludeGuard &guard, PreprocOutput &out);
+
+	/*
+	 * The input of run_preproc_fast and the line of the position
+	 * up to which it was processed
+	 * */
+	class FastPreprocInput {
+	public:
+		const Utf8CharStream &input;
+		std::string_view data;
+		const IfdefScanner &scanner;
+		bool added_incdir;
+		PreprocOutput &out;
+		size_t file_id;
+		size_t pos;
+		size_t line_offset;
+	};
+	/*
+	 * Preprocess the input with the help of IfdefScanner (fast_ifdef_skip, fast_copy),
+	 * only the parts of the input which have to be preprocessed are passed to run_preproc
+	 * (falls back to run_preproc if the input is not supported by the scanner)
+	 * */
+	void run_preproc_fast(Utf8CharStream &input, bool added_incdir,
+			PreprocOutput &out, IncludeGuard *include_guard);
+	void run_preproc_ifdef_blocks(FastPreprocInput &in,
+			const std::vector<IfdefBlock> &blocks, size_t start, size_t end);
+	// preprocess the part of the input without `ifdef blocks
+	void run_preproc_segment(FastPreprocInput &in, size_t start, size_t end);
+	// run_preproc on the part of the input
+	void run_preproc_range(FastPreprocInput &in, size_t start, size_t end);
+	// copy the part of the input to the output without any change
+	void copy_range(FastPreprocInput &in, size_t start, size_t end);
+
 public:
 	verilog_pp::MacroDB &defineDB;
 	// <path, line_no>
@@ -26,22 +81,64 @@ public:
 	size_t max_macro_call_stack_size;
 	std::vector<std::string> macro_call_stack;
 	bool debug_dump_tokens;
+	IncludeCache *include_cache;
+	std::vector<IncludeCacheEntry*> include_cache_recording;
+	bool fast_ifdef_skip;
+	bool fast_copy;
+	bool fast_macro_expansion;
+	// the text between the directives shorter than this is processed together with them
+	// (to avoid too many small runs of the preprocessor)
+	static constexpr size_t FAST_COPY_MIN_SIZE = 256;
 
 	VerilogPreprocContainer(Language _lang, SyntaxErrorLogger &_syntaxErrLogger,
 			verilog_pp::MacroDB &defineDB);
 
 	void init(const std::vector<std::string> &_incdirs);
-	std::string run_preproc(antlr4::ANTLRInputStream &input, bool added_incdir);
+	/*
+	 * @param out the output where the preprocessed text and its source map is appended
+	 * @param line_offset the number of lines before the input (the first line of input
+	 *        has number line_offset + 1)
+	 * @param include_guard if specified the include guard of the input is detected
+	 *        and stored in this object (macro_name is empty if there is no guard)
+	 * */
+	void run_preproc(antlr4::CharStream &input, bool added_incdir,
+			PreprocOutput &out, size_t line_offset = 0,
+			IncludeGuard *include_guard = nullptr);
 	bool add_parent_dir_to_incldirs(const std::filesystem::path &file_name);
+	void run_preproc_file(const std::filesystem::path &file_name,
+			PreprocOutput &out, IncludeGuard *include_guard = nullptr);
 	std::string run_preproc_file(const std::filesystem::path &file_name);
+	/*
+	 * Preprocess the included file, use include_cache if possible
+	 * (the file is skipped if it has an include guard which is already defined)
+	 *
+	 * @param include_depth_limit the limit of nested includes used to check if the cached
+	 *        result can be used
+	 * */
+	void run_preproc_include(const std::filesystem::path &file_name,
+			size_t include_depth_limit, PreprocOutput &out);
 	/*
 	 * @param input_str input for preprocessor
 	 * @note file_name for the error messages and for `__FILE__ directive is taken from incfile_stack or default is is used
 	 * @param line_offset the line offset for debug and `__LINE__
 	 * */
+	void run_preproc_str(const std::string &input_str, size_t line_offset,
+			PreprocOutput &out);
 	std::string run_preproc_str(const std::string &input_str,
 			size_t line_offset);
 
+	/*
+	 * Access to defineDB, all accesses during the preprocessing
+	 * have to use these methods because of the include_cache
+	 * */
+	// @return the macro definition or nullptr if the macro is not defined
+	aMacroDef* get_macro(const std::string &name);
+	// @return true if the macro was added, if it was already defined the def is deleted
+	bool define_macro(aMacroDef *def);
+	// remove the macro if it is defined and it is not persistent
+	void undef_macro(const std::string &name);
+	void undefineall();
+
 	void delete_non_persystent_macro_defs();
 	virtual ~VerilogPreprocContainer();
 };
@@ -1,5 +1,11 @@
 #include <hdlConvertor/convertor.h>
 
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <iterator>
+
+#include <hdlConvertor/hdlAstBinary.h>
 #include <hdlConvertor/notImplementedLogger.h>
 
 #include <hdlConvertor/vhdlConvertor/vhdlParser/vhdlLexer.h>
@@ -21,7 +27,7 @@ using namespace antlr4;
 using namespace antlr4::tree;
 using namespace hdlConvertor::hdlObjects;
 
-bool Convertor::debug = false;
+atomic<bool> Convertor::debug(false);
 
 class VHDLParserContainer: public iParserContainer<vhdl_antlr::vhdlLexer,
 		vhdl_antlr::vhdlParser, vhdl::VhdlDesignFileParser> {
@@ -43,26 +49,33 @@ public:
 	void parse_file(const filesystem::path &file_name, bool hierarchyOnly) = delete;
 
 	SVParserContainer(hdlObjects::HdlContext &context, Language _lang,
-			verilog_pp::MacroDB &_defineDB) :
+			verilog_pp::MacroDB &_defineDB,
+			verilog_pp::IncludeCache *include_cache = nullptr) :
 			iParserContainer(context, _lang, _defineDB), preproc(_lang,
 					this->syntaxErrLogger, _defineDB) {
+		preproc.include_cache = include_cache;
 	}
 
 	void parse_file(const filesystem::path &file_name, bool hierarchyOnly,
 			std::vector<std::string> &_incdirs) {
 		preproc.init(_incdirs);
-		string preprocessed_code = preproc.run_preproc_file(file_name);
-		ANTLRInputStream input_for_parser(preprocessed_code);
+		PreprocOutput pp_out;
+		preproc.run_preproc_file(file_name, pp_out);
+		Utf8CharStream input_for_parser(move(pp_out.text));
 		input_for_parser.name = file_name.u8string();
+		// translate the positions of the objects to the original files
+		SourceMapScope source_map_scope(&pp_out.source_map);
 		this->_parse(input_for_parser, hierarchyOnly);
 	}
 
 	void parse_str(const std::string &input_str, bool hierarchyOnly,
 			const std::vector<string> &_incdirs) {
 		preproc.init(_incdirs);
-		string preprocessed_code = preproc.run_preproc_str(input_str, 0);
-		ANTLRInputStream input_for_parser(preprocessed_code);
+		PreprocOutput pp_out;
+		preproc.run_preproc_str(input_str, 0, pp_out);
+		Utf8CharStream input_for_parser(move(pp_out.text));
 		input_for_parser.name = STRING_FILENAME;
+		SourceMapScope source_map_scope(&pp_out.source_map);
 		this->_parse(input_for_parser, hierarchyOnly);
 	}
 	virtual void parseFn() override {
@@ -75,31 +88,157 @@ public:
 };
 
 Convertor::Convertor(hdlObjects::HdlContext &_c) :
-		hierarchyOnly(false), c(_c) {
+		hierarchyOnly(false), c(_c), prediction(
+				PredictionStrategy::PREDICTION_LL), preproc_fast_ifdef_skip(
+				false), preproc_fast_copy(false), preproc_fast_macro_expansion(true), ast_arena(
+				false), persistent_macro_defs_version(0) {
+}
+
+template<class PARSER_CONTAINER_T>
+void set_prediction(PARSER_CONTAINER_T &pc, PredictionStrategy prediction,
+		ParserStats &stats, ParseCache *parse_cache) {
+	pc.prediction = prediction;
+	pc.stats = &stats;
+	pc.parse_cache = parse_cache;
+}
+
+void Convertor::parse_file(const string &fileName, Language lang,
+		vector<string> &incdir, HdlContext &ctx, verilog_pp::MacroDB &_defineDB,
+		bool use_parse_cache) {
+	struct stat buffer;
+
+	if (stat(fileName.c_str(), &buffer) != 0) {
+		throw ParseException(fileName + " does not exist.");
+	}
+	ObjectArenaScope arena_scope(ast_arena ? &ctx.get_arena() : nullptr);
+	SymbolTableScope symbol_scope(&ctx.get_symbol_table());
+	ParseCache *_parse_cache = use_parse_cache ? &parse_cache : nullptr;
+
+	if (lang == Language::VHDL) {
+		VHDLParserContainer pc(ctx, lang, _defineDB);
+		set_prediction(pc, prediction, stats, _parse_cache);
+		pc.parse_file(fileName, hierarchyOnly);
+	} else if (lang >= Language::VERILOG1995 && lang <= Language::SV2017) {
+		SVParserContainer pc(ctx, lang, _defineDB, &include_cache);
+		pc.preproc.fast_ifdef_skip = preproc_fast_ifdef_skip;
+		pc.preproc.fast_copy = preproc_fast_copy;
+		pc.preproc.fast_macro_expansion = preproc_fast_macro_expansion;
+		set_prediction(pc, prediction, stats, _parse_cache);
+		pc.parse_file(fileName, hierarchyOnly, incdir);
+	} else {
+		throw runtime_error("Unsupported language.");
+	}
+}
+
+shared_ptr<verilog_pp::MacroDBSnapshot> Convertor::get_persistent_macro_defs() {
+	auto v = defineDB.get_persistent_version();
+	if (!persistent_macro_defs || persistent_macro_defs_version != v) {
+		persistent_macro_defs = defineDB.snapshot_persistent();
+		persistent_macro_defs_version = v;
+	}
+	return persistent_macro_defs;
+}
+
+static void delete_macro_defs(verilog_pp::MacroDB &db) {
+	for (auto &m : db) {
+		delete m.second;
+	}
+	db.clear();
+}
+
+void Convertor::parse_parallel(const vector<string> &_fileNames,
+		Language lang, vector<string> &incdir, size_t jobs) {
+	size_t file_cnt = _fileNames.size();
+	vector<unique_ptr<HdlContext>> results(file_cnt);
+	vector<exception_ptr> errors(file_cnt);
+	// index of the first file which failed to parse, files behind it are not parsed
+	atomic<size_t> first_err(file_cnt);
+	atomic<size_t> next_file(0);
+	// the defines which remain after the last file (same as in sequential mode)
+	verilog_pp::MacroDB last_file_defs;
+
+	// the macros which are preserved between the files are shared by the workers
+	// (the non persistent ones are removed before parsing of each file anyway)
+	auto base_defs = get_persistent_macro_defs();
+	auto worker = [&]() {
+		verilog_pp::MacroDB worker_defineDB;
+		worker_defineDB.set_base(base_defs);
+		for (;;) {
+			size_t i = next_file++;
+			if (i >= file_cnt || i > first_err)
+				break;
+			auto ctx = make_unique<HdlContext>();
+			try {
+				parse_file(_fileNames[i], lang, incdir, *ctx, worker_defineDB);
+			} catch (...) {
+				errors[i] = current_exception();
+				size_t e = first_err;
+				while (i < e && !first_err.compare_exchange_weak(e, i)) {
+				}
+				continue;
+			}
+			results[i] = move(ctx);
+			if (i == file_cnt - 1) {
+				for (auto d : worker_defineDB.extract_non_persistent())
+					last_file_defs.insert( { d->name, d });
+			}
+		}
+		delete_macro_defs(worker_defineDB);
+	};
+
+	vector<thread> workers;
+	workers.reserve(jobs);
+	for (size_t i = 0; i < jobs; i++)
+		workers.emplace_back(worker);
+	for (auto &w : workers)
+		w.join();
+
+	// merge in the order of the input files, stop on the first error
+	for (size_t i = 0; i < file_cnt; i++) {
+		if (errors[i]) {
+			delete_macro_defs(last_file_defs);
+			rethrow_exception(errors[i]);
+		}
+		auto &objs = results[i]->objs;
+		c.objs.insert(c.objs.end(), make_move_iterator(objs.begin()),
+				make_move_iterator(objs.end()));
+		// the memory and the symbols of the objects have to live as long as the objects
+		auto &arenas = results[i]->arenas;
+		c.arenas.insert(c.arenas.end(), make_move_iterator(arenas.begin()),
+				make_move_iterator(arenas.end()));
+		auto &symbol_tables = results[i]->symbol_tables;
+		c.symbol_tables.insert(c.symbol_tables.end(),
+				make_move_iterator(symbol_tables.begin()),
+				make_move_iterator(symbol_tables.end()));
+		auto &source_lines = results[i]->source_lines;
+		c.source_lines.insert(c.source_lines.end(),
+				make_move_iterator(source_lines.begin()),
+				make_move_iterator(source_lines.end()));
+	}
+
+	for (auto d : defineDB.extract_non_persistent())
+		delete d;
+	defineDB.insert(last_file_defs.begin(), last_file_defs.end());
 }
 
 void Convertor::parse(const vector<string> &_fileNames, Language lang,
-		vector<string> incdir, bool _hierarchyOnly, bool _debug) {
+		vector<string> incdir, bool _hierarchyOnly, bool _debug, size_t jobs) {
 
 	hierarchyOnly = _hierarchyOnly;
 	debug = _debug;
 	NotImplementedLogger::ENABLE = _debug;
+	// the files may have been modified since the last call
+	include_cache.clear_include_guards();
 
-	for (const auto &fileName : _fileNames) {
-		struct stat buffer;
+	if (jobs == 0)
+		jobs = max(thread::hardware_concurrency(), 1u);
+	jobs = min(jobs, _fileNames.size());
 
-		if (stat(fileName.c_str(), &buffer) != 0) {
-			throw ParseException(fileName + " does not exist.");
-		}
-
-		if (lang == Language::VHDL) {
-			VHDLParserContainer pc(c, lang, defineDB);
-			pc.parse_file(fileName, hierarchyOnly);
-		} else if (lang >= Language::VERILOG1995 && lang <= Language::SV2017) {
-			SVParserContainer pc(c, lang, defineDB);
-			pc.parse_file(fileName, hierarchyOnly, incdir);
-		} else {
-			throw runtime_error("Unsupported language.");
+	if (jobs > 1) {
+		parse_parallel(_fileNames, lang, incdir, jobs);
+	} else {
+		for (const auto &fileName : _fileNames) {
+			parse_file(fileName, lang, incdir, c, defineDB);
 		}
 	}
 }
@@ -109,30 +248,121 @@ void Convertor::parse_str(const string &hdl_str, Language lang,
 	hierarchyOnly = _hierarchyOnly;
 	debug = _debug;
 	NotImplementedLogger::ENABLE = _debug;
+	// the files may have been modified since the last call
+	include_cache.clear_include_guards();
+	ObjectArenaScope arena_scope(ast_arena ? &c.get_arena() : nullptr);
+	SymbolTableScope symbol_scope(&c.get_symbol_table());
 
 	if (lang == VHDL) {
 		VHDLParserContainer pc(c, lang, defineDB);
+		set_prediction(pc, prediction, stats, &parse_cache);
 		pc.parse_str(hdl_str, hierarchyOnly);
 	} else if (lang >= Language::VERILOG1995 && lang <= Language::SV2017) {
-		SVParserContainer pc(c, lang, defineDB);
+		SVParserContainer pc(c, lang, defineDB, &include_cache);
+		pc.preproc.fast_ifdef_skip = preproc_fast_ifdef_skip;
+		pc.preproc.fast_copy = preproc_fast_copy;
+		pc.preproc.fast_macro_expansion = preproc_fast_macro_expansion;
+		set_prediction(pc, prediction, stats, &parse_cache);
 		pc.parse_str(hdl_str, hierarchyOnly, incdir);
 	} else {
 		throw runtime_error("Unsupported language.");
 	}
 }
 
+void Convertor::load_ast(const filesystem::path &file_name) {
+	ObjectArenaScope arena_scope(ast_arena ? &c.get_arena() : nullptr);
+	HdlAstBinaryFile f(file_name);
+	HdlAstBinaryLoader(f, c).load();
+}
+
+void Convertor::warmup_dfa(const vector<string> &fileNames, Language lang,
+		vector<string> incdir) {
+	HdlContext ctx; // dummy context
+	include_cache.clear_include_guards();
+	verilog_pp::MacroDB warmup_defineDB;
+	warmup_defineDB.set_base(get_persistent_macro_defs());
+	bool orig_hierarchyOnly = hierarchyOnly;
+	// the full AST is not required, the prediction is the same
+	hierarchyOnly = true;
+	for (const auto &fileName : fileNames) {
+		try {
+			// the cached files would not be parsed
+			parse_file(fileName, lang, incdir, ctx, warmup_defineDB, false);
+		} catch (const ParseException &e) {
+			// the file was processed until the error, which is enough to learn the prediction
+		}
+		ctx.objs.clear();
+		ctx.arenas.clear();
+		ctx.symbol_tables.clear();
+		ctx.source_lines.clear();
+	}
+	hierarchyOnly = orig_hierarchyOnly;
+	delete_macro_defs(warmup_defineDB);
+}
+
+template<class antlrLexerT, class antlrParserT>
+size_t get_parser_dfa_state_cnt() {
+	// the DFA is a static member of the parser,
+	// an empty parser instance is used just to access it
+	ANTLRInputStream input;
+	antlrLexerT lexer(&input);
+	CommonTokenStream tokens(&lexer);
+	antlrParserT parser(&tokens);
+	size_t cnt = 0;
+	// the vector of the DFAs is never resized, only the size of the state set of each DFA
+	// is read, the parsers running in other threads are not blocked
+	// (the value may not include the states they are adding right now)
+	for (auto &dfa : parser.template getInterpreter<atn::ParserATNSimulator>()->decisionToDFA) {
+		cnt += dfa.states.size();
+	}
+	return cnt;
+}
+
+size_t Convertor::get_dfa_state_cnt(Language lang) {
+	if (lang == Language::VHDL) {
+		return get_parser_dfa_state_cnt<vhdl_antlr::vhdlLexer,
+				vhdl_antlr::vhdlParser>();
+	} else if (lang >= Language::VERILOG1995 && lang <= Language::SV2017) {
+		return get_parser_dfa_state_cnt<sv2017_antlr::sv2017Lexer,
+				sv2017_antlr::sv2017Parser>();
+	} else {
+		throw runtime_error("Unsupported language.");
+	}
+}
+
 string Convertor::verilog_pp(const string &fileName,
 		const vector<string> _incdirs, Language lang) {
 	HdlContext c; // dummy context
-	SVParserContainer pc(c, lang, defineDB);
+	include_cache.clear_include_guards();
+	SVParserContainer pc(c, lang, defineDB, &include_cache);
+	pc.preproc.fast_ifdef_skip = preproc_fast_ifdef_skip;
+	pc.preproc.fast_copy = preproc_fast_copy;
+	pc.preproc.fast_macro_expansion = preproc_fast_macro_expansion;
 	pc.preproc.init(_incdirs);
 	return pc.preproc.run_preproc_file(fileName);
 }
 
+void Convertor::verilog_pp(const string &fileName,
+		const vector<string> _incdirs, Language lang, PreprocOutputSink &sink) {
+	HdlContext c; // dummy context
+	include_cache.clear_include_guards();
+	SVParserContainer pc(c, lang, defineDB, &include_cache);
+	pc.preproc.fast_ifdef_skip = preproc_fast_ifdef_skip;
+	pc.preproc.fast_copy = preproc_fast_copy;
+	pc.preproc.fast_macro_expansion = preproc_fast_macro_expansion;
+	pc.preproc.init(_incdirs);
+	PreprocOutput out(&sink);
+	pc.preproc.run_preproc_file(fileName, out);
+}
+
 string Convertor::verilog_pp_str(const string &verilog_str,
 		const vector<string> _incdirs, Language lang) {
 	HdlContext c; // dummy context
-	SVParserContainer pc(c, lang, defineDB);
+	include_cache.clear_include_guards();
+	SVParserContainer pc(c, lang, defineDB, &include_cache);
+	pc.preproc.fast_ifdef_skip = preproc_fast_ifdef_skip;
+	pc.preproc.fast_copy = preproc_fast_copy;
+	pc.preproc.fast_macro_expansion = preproc_fast_macro_expansion;
 	pc.preproc.init(_incdirs);
 	return pc.preproc.run_preproc_str(verilog_str, 0);
 }
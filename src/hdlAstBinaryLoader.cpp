@@ -0,0 +1,470 @@
+#include <hdlConvertor/hdlAstBinary.h>
+
+#include <limits>
+#include <stdexcept>
+
+#include <hdlConvertor/hdlObjects/hdlOperatorType.h>
+
+namespace hdlConvertor {
+
+using namespace std;
+using namespace hdlObjects;
+
+static HdlOperatorType op_from_str(string_view s) {
+	static const unordered_map<string_view, HdlOperatorType> ops = [] {
+		unordered_map<string_view, HdlOperatorType> m;
+		for (int i = 0; i <= HdlOperatorType::ARITH_SHIFT_RIGHT_ASSIGN; i++) {
+			auto op = static_cast<HdlOperatorType>(i);
+			m[HdlOperatorType_toString(op)] = op;
+		}
+		return m;
+	}();
+	auto op = ops.find(s);
+	if (op == ops.end())
+		throw runtime_error(
+				"the binary AST file has invalid operator " + string(s));
+	return op->second;
+}
+
+static runtime_error invalid_kind(const char *what, HdlAstBinaryNodeKind k) {
+	return runtime_error(
+			string("the binary AST file has invalid ") + what + " node "
+					+ HdlAstBinaryNodeKind_toString(k));
+}
+
+HdlAstBinaryLoader::HdlAstBinaryLoader(const HdlAstBinaryFile &file,
+		HdlContext &ctx) :
+		_file(file), _ctx(ctx) {
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+	_lines_end = 0;
+#endif
+}
+
+HdlSymbol HdlAstBinaryLoader::symbol(const HdlAstBinaryNode &n,
+		size_t field_i) {
+	uint32_t i = n.u32(field_i);
+	auto s = _symbols.find(i);
+	if (s == _symbols.end())
+		s = _symbols.emplace(i, HdlSymbol(string(_file.str(i)))).first;
+	return s->second;
+}
+
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+
+Position HdlAstBinaryLoader::position(const HdlAstBinaryNode &n) {
+	if (!n.has_position())
+		return Position();
+	auto p = n.position();
+	const uint32_t NONE = HdlAstBinary::NONE;
+	if (p.start_line == NONE || p.stop_line == NONE || p.start_column == 0
+			|| p.start_column == NONE || p.stop_column == 0
+			|| p.stop_column == NONE)
+		return Position();
+	// the start is on its own line which is mapped to the start_line by the source map,
+	// the stop is on the next line which is mapped to the stop_line
+	size_t start = _lines_end + p.start_column - 1;
+	size_t stop_line_start = start + 1;
+	size_t stop = stop_line_start + p.stop_column - 1;
+	if (stop >= Position::INVALID_INDEX)
+		return Position();
+	if (!_lines)
+		_lines = make_unique<SourceLines>();
+	auto &sm = _lines->source_map;
+	auto f = _file_ids.find(p.file);
+	if (f == _file_ids.end()) {
+		sm.files.push_back(
+				p.file.empty() ? nullptr : make_shared<const string>(p.file));
+		f = _file_ids.emplace(p.file, sm.files.size() - 1).first;
+	}
+	auto &line_starts = _lines->line_starts;
+	line_starts.push_back(_lines_end);
+	sm.add_range(line_starts.size(), f->second, p.start_line, true);
+	line_starts.push_back(stop_line_start);
+	sm.add_range(line_starts.size(), f->second, p.stop_line, true);
+	_lines_end = stop + 1;
+	return Position(start, stop - start + 1, _lines.get());
+}
+
+#else
+
+Position HdlAstBinaryLoader::position(const HdlAstBinaryNode &n) {
+	if (!n.has_position())
+		return Position();
+	auto p = n.position();
+	auto to_size = [](uint32_t v) {
+		return v == HdlAstBinary::NONE ? Position::INVALID : size_t(v);
+	};
+	shared_ptr<const string> file;
+	if (!p.file.empty()) {
+		auto &f = _files[p.file];
+		if (!f)
+			f = make_shared<const string>(p.file);
+		file = f;
+	}
+	return Position(to_size(p.start_line), to_size(p.stop_line),
+			to_size(p.start_column), to_size(p.stop_column), file);
+}
+
+#endif
+
+HdlAstBinaryNode HdlAstBinaryLoader::child(const HdlAstBinaryNode &parent,
+		size_t field_i) {
+	auto n = parent.node(field_i);
+	if (n.offset() >= parent.offset())
+		throw runtime_error("the binary AST file has invalid reference");
+	return n;
+}
+
+HdlAstBinaryList HdlAstBinaryLoader::child_list(
+		const HdlAstBinaryNode &parent, size_t field_i) {
+	auto l = parent.list(field_i);
+	// the items of the list are stored behind its size
+	if (l.offset() >= parent.offset()
+			|| l.offset() + (l.size() + 1) * sizeof(uint32_t) > parent.offset())
+		throw runtime_error("the binary AST file has invalid reference");
+	return l;
+}
+
+vector<string> HdlAstBinaryLoader::load_str_list(
+		const HdlAstBinaryNode &parent, size_t field_i) {
+	auto l = child_list(parent, field_i);
+	vector<string> res;
+	res.reserve(l.size());
+	for (size_t i = 0; i < l.size(); i++)
+		res.emplace_back(l.str(i));
+	return res;
+}
+
+unique_ptr<iHdlObj> HdlAstBinaryLoader::load_obj(const HdlAstBinaryNode &n) {
+	if (n.is_null())
+		return nullptr;
+	auto load_obj_item = [this](const HdlAstBinaryNode &i) {
+		return load_obj(i);
+	};
+	auto load_expr_item = [this](const HdlAstBinaryNode &i) {
+		return load_expr(i);
+	};
+	auto load_var_item = [this](const HdlAstBinaryNode &i) {
+		return load_var(i);
+	};
+	auto k = n.kind();
+	switch (k) {
+	case HDLB_LIBRARY: {
+		auto o = make_unique<HdlLibrary>(symbol(n, 0));
+		o->__doc__ = n.str(1);
+		o->position = position(n);
+		return o;
+	}
+	case HDLB_NAMESPACE: {
+		auto o = make_unique<HdlNamespace>();
+		o->name = symbol(n, 0);
+		o->__doc__ = n.str(1);
+		o->defs_only = n.u32(2) & HDLB_FLAG_DEFS_ONLY;
+		load_list(n, 3, o->objs, load_obj_item);
+		o->position = position(n);
+		return o;
+	}
+	case HDLB_MODULE_DEC: {
+		auto o = make_unique<HdlModuleDec>();
+		o->name = symbol(n, 0);
+		o->__doc__ = n.str(1);
+		load_list(n, 2, o->generics, load_var_item);
+		load_list(n, 3, o->ports, load_var_item);
+		o->position = position(n);
+		return o;
+	}
+	case HDLB_MODULE_DEF: {
+		auto o = make_unique<HdlModuleDef>();
+		o->name = symbol(n, 0);
+		o->__doc__ = n.str(1);
+		o->entityName = load_expr(child(n, 2));
+		load_list(n, 3, o->objs, load_obj_item);
+		o->position = position(n);
+		return o;
+	}
+	case HDLB_COMP_INSTANCE: {
+		auto o = make_unique<HdlCompInstance>(load_expr(child(n, 1)),
+				load_expr(child(n, 2)));
+		o->__doc__ = n.str(0);
+		load_list(n, 3, o->genericMap, load_expr_item);
+		load_list(n, 4, o->portMap, load_expr_item);
+		o->position = position(n);
+		return o;
+	}
+	case HDLB_VARIABLE_DEF:
+		return load_var(n);
+	case HDLB_FUNCTION_DEF:
+		return load_function(n);
+	default:
+		if (k >= HDLB_STM_EXPR && k <= HDLB_STM_IMPORT)
+			return load_stm(n);
+		if (k >= HDLB_CALL && k <= HDLB_EXPR_NONE)
+			return load_expr(n);
+		throw invalid_kind("object", k);
+	}
+}
+
+unique_ptr<iHdlExpr> HdlAstBinaryLoader::load_expr(const HdlAstBinaryNode &n) {
+	if (n.is_null())
+		return nullptr;
+	unique_ptr<iHdlExpr> e;
+	switch (n.kind()) {
+	case HDLB_EXPR_NONE:
+		e = make_unique<iHdlExpr>();
+		break;
+	case HDLB_CALL: {
+		auto op = op_from_str(n.str(0));
+		vector<unique_ptr<iHdlExpr>> operands;
+		load_list(n, 1, operands, [this](const HdlAstBinaryNode &i) {
+			return load_expr(i);
+		});
+		e = make_unique<iHdlExpr>();
+		e->data = new HdlCall(op, move(operands));
+		break;
+	}
+	case HDLB_ID: {
+		auto s = symbol(n, 0);
+		auto v = new HdlValue(HdlValueType::symb_ID);
+		v->_str = move(s);
+		e = make_unique<iHdlExpr>(v);
+		break;
+	}
+	case HDLB_STRING: {
+		string s(n.str(0));
+		auto v = new HdlValue(HdlValueType::symb_STRING);
+		*v->_string = move(s);
+		e = make_unique<iHdlExpr>(v);
+		break;
+	}
+	case HDLB_INT:
+		e = make_unique<iHdlExpr>(BigInteger(n.int_value()), n.i32(2));
+		break;
+	case HDLB_BITSTRING: {
+		int32_t base = n.i32(1);
+		// BigInteger stores the base in int16_t, INVALID_BASE marks the non-bitstring value
+		if (base <= 0 || base > numeric_limits<int16_t>::max())
+			throw runtime_error("the binary AST file has invalid base of the bitstring");
+		e = make_unique<iHdlExpr>(BigInteger(n.str(0), base), n.i32(2));
+		break;
+	}
+	case HDLB_FLOAT:
+		e = make_unique<iHdlExpr>(new HdlValue(n.float_value()));
+		break;
+	case HDLB_ARRAY:
+		e = make_unique<iHdlExpr>(new HdlValue(load_expr_list(n, 0)));
+		break;
+	case HDLB_NULL:
+		e = iHdlExpr::null();
+		break;
+	case HDLB_OPEN:
+		e = iHdlExpr::OPEN();
+		break;
+	case HDLB_ALL:
+		e = iHdlExpr::all();
+		break;
+	case HDLB_OTHERS:
+		e = iHdlExpr::others();
+		break;
+	case HDLB_TYPE_T:
+		e = iHdlExpr::TYPE_T();
+		break;
+	case HDLB_AUTO_T:
+		e = iHdlExpr::AUTO_T();
+		break;
+	default:
+		throw invalid_kind("expression", n.kind());
+	}
+	e->position = position(n);
+	return e;
+}
+
+unique_ptr<vector<unique_ptr<iHdlExpr>>> HdlAstBinaryLoader::load_expr_list(
+		const HdlAstBinaryNode &parent, size_t field_i) {
+	if (parent.list(field_i).is_null())
+		return nullptr;
+	auto res = make_unique<vector<unique_ptr<iHdlExpr>>>();
+	load_list(parent, field_i, *res, [this](const HdlAstBinaryNode &i) {
+		return load_expr(i);
+	});
+	return res;
+}
+
+HdlExprAndStm HdlAstBinaryLoader::load_expr_and_stm(
+		const HdlAstBinaryNode &n) {
+	if (n.kind() != HDLB_EXPR_AND_STM)
+		throw invalid_kind("if/case item", n.kind());
+	return HdlExprAndStm(load_expr(child(n, 0)), load_stm(child(n, 1)));
+}
+
+unique_ptr<iHdlStatement> HdlAstBinaryLoader::load_stm(
+		const HdlAstBinaryNode &n) {
+	if (n.is_null())
+		return nullptr;
+	// the fields behind the common fields of the statement
+	const size_t F = HdlAstBinary::STM_FIELD_CNT;
+	auto load_obj_item = [this](const HdlAstBinaryNode &i) {
+		return load_obj(i);
+	};
+	auto load_expr_item = [this](const HdlAstBinaryNode &i) {
+		return load_expr(i);
+	};
+	auto load_expr_and_stm_item = [this](const HdlAstBinaryNode &i) {
+		return load_expr_and_stm(i);
+	};
+	unique_ptr<iHdlStatement> s;
+	switch (n.kind()) {
+	case HDLB_STM_EXPR:
+		s = make_unique<HdlStmExpr>(load_expr(child(n, F)));
+		break;
+	case HDLB_STM_NOP:
+		s = make_unique<HdlStmNop>();
+		break;
+	case HDLB_STM_BREAK:
+		s = make_unique<HdlStmBreak>();
+		break;
+	case HDLB_STM_CONTINUE:
+		s = make_unique<HdlStmContinue>();
+		break;
+	case HDLB_STM_BLOCK: {
+		auto b = make_unique<HdlStmBlock>();
+		load_list(n, F, b->statements, load_obj_item);
+		s = move(b);
+		break;
+	}
+	case HDLB_STM_IF: {
+		vector<HdlExprAndStm> elifs;
+		load_list(n, F + 2, elifs, load_expr_and_stm_item);
+		s = make_unique<HdlStmIf>(load_expr(child(n, F)),
+				load_stm(child(n, F + 1)), elifs, load_stm(child(n, F + 3)));
+		break;
+	}
+	case HDLB_STM_CASE: {
+		vector<HdlExprAndStm> cases;
+		load_list(n, F + 1, cases, load_expr_and_stm_item);
+		s = make_unique<HdlStmCase>(load_expr(child(n, F)), cases,
+				load_stm(child(n, F + 2)));
+		break;
+	}
+	case HDLB_STM_FOR:
+		s = make_unique<HdlStmFor>(load_stm(child(n, F)),
+				load_expr(child(n, F + 1)), load_stm(child(n, F + 2)),
+				load_stm(child(n, F + 3)));
+		break;
+	case HDLB_STM_FOR_IN: {
+		vector<unique_ptr<iHdlObj>> var_defs;
+		load_list(n, F, var_defs, load_obj_item);
+		s = make_unique<HdlStmForIn>(var_defs, load_expr(child(n, F + 1)),
+				load_stm(child(n, F + 2)));
+		break;
+	}
+	case HDLB_STM_RETURN:
+		s = make_unique<HdlStmReturn>(load_expr(child(n, F)));
+		break;
+	case HDLB_STM_ASSIGN:
+		s = make_unique<HdlStmAssign>(load_expr(child(n, F)),
+				load_expr(child(n, F + 1)), load_expr(child(n, F + 2)),
+				load_expr_list(n, F + 3),
+				n.u32(F + 4) & HDLB_FLAG_IS_BLOCKING);
+		break;
+	case HDLB_STM_WHILE:
+		s = make_unique<HdlStmWhile>(load_expr(child(n, F)),
+				load_stm(child(n, F + 1)));
+		break;
+	case HDLB_STM_DO_WHILE:
+		s = make_unique<HdlStmDoWhile>(load_stm(child(n, F)),
+				load_expr(child(n, F + 1)));
+		break;
+	case HDLB_STM_PROCESS:
+		s = make_unique<HdlStmProcess>(load_expr_list(n, F),
+				load_stm(child(n, F + 1)));
+		break;
+	case HDLB_STM_WAIT: {
+		vector<unique_ptr<iHdlExpr>> val;
+		load_list(n, F, val, load_expr_item);
+		s = make_unique<HdlStmWait>(val);
+		break;
+	}
+	case HDLB_STM_IMPORT: {
+		vector<unique_ptr<iHdlExpr>> path;
+		load_list(n, F, path, load_expr_item);
+		s = make_unique<HdlStmImport>(path);
+		break;
+	}
+	default:
+		throw invalid_kind("statement", n.kind());
+	}
+	s->__doc__ = n.str(0);
+	s->labels = load_str_list(n, 1);
+	s->in_preproc = n.u32(2) & HDLB_FLAG_IN_PREPROC;
+	s->position = position(n);
+	return s;
+}
+
+unique_ptr<HdlVariableDef> HdlAstBinaryLoader::load_var(
+		const HdlAstBinaryNode &n) {
+	if (n.kind() != HDLB_VARIABLE_DEF)
+		throw invalid_kind("variable", n.kind());
+	uint32_t direction = n.u32(4);
+	if (direction > HdlDirection::DIR_UNKNOWN)
+		throw runtime_error("the binary AST file has invalid direction");
+	uint32_t flags = n.u32(5);
+	auto o = make_unique<HdlVariableDef>(symbol(n, 0), load_expr(child(n, 2)),
+			load_expr(child(n, 3)), static_cast<HdlDirection>(direction),
+			flags & HDLB_FLAG_IS_LATCHED);
+	o->is_const = flags & HDLB_FLAG_IS_CONST;
+	o->is_static = flags & HDLB_FLAG_IS_STATIC;
+	o->__doc__ = n.str(1);
+	o->position = position(n);
+	return o;
+}
+
+unique_ptr<HdlFunctionDef> HdlAstBinaryLoader::load_function(
+		const HdlAstBinaryNode &n) {
+	unique_ptr<vector<unique_ptr<HdlVariableDef>>> params;
+	if (!n.list(3).is_null()) {
+		params = make_unique<vector<unique_ptr<HdlVariableDef>>>();
+		load_list(n, 3, *params, [this](const HdlAstBinaryNode &i) {
+			return load_var(i);
+		});
+	}
+	uint32_t flags = n.u32(5);
+	auto o = make_unique<HdlFunctionDef>(symbol(n, 0),
+			flags & HDLB_FLAG_IS_OPERATOR, load_expr(child(n, 2)),
+			move(params));
+	o->is_static = flags & HDLB_FLAG_IS_STATIC;
+	o->is_virtual = flags & HDLB_FLAG_IS_VIRTUAL;
+	o->is_task = flags & HDLB_FLAG_IS_TASK;
+	o->is_declaration_only = flags & HDLB_FLAG_IS_DECLARATION_ONLY;
+	load_list(n, 4, o->body, [this](const HdlAstBinaryNode &i) {
+		return load_obj(i);
+	});
+	o->__doc__ = n.str(1);
+	o->position = position(n);
+	return o;
+}
+
+void HdlAstBinaryLoader::load() {
+	SymbolTableScope symbol_scope(&_ctx.get_symbol_table());
+	vector<unique_ptr<iHdlObj>> objs;
+	try {
+		auto root = _file.root();
+		if (root.is_null() || root.kind() != HDLB_CONTEXT)
+			throw runtime_error("the binary AST file has invalid root node");
+		load_list(root, 0, objs, [this](const HdlAstBinaryNode &n) {
+			return load_obj(n);
+		});
+	} catch (const logic_error &e) {
+		// std::out_of_range from the accessors of the nodes
+		throw runtime_error(
+				string("the binary AST file is corrupted (") + e.what() + ")");
+	}
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+	if (_lines)
+		_ctx.source_lines.push_back(move(_lines));
+#endif
+	_ctx.objs.reserve(_ctx.objs.size() + objs.size());
+	for (auto &o : objs)
+		_ctx.objs.push_back(move(o));
+}
+
+}
@@ -0,0 +1,271 @@
+#include <hdlConvertor/hdlAstBinary.h>
+
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define HDLCONVERTOR_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace hdlConvertor {
+
+using namespace std;
+
+static const array<const char*, HDLB_EXPR_NONE + 1> HdlAstBinaryNodeKind_str =
+		{ "<invalid>", "HDLB_CONTEXT", "HDLB_LIBRARY", "HDLB_NAMESPACE",
+				"HDLB_MODULE_DEC", "HDLB_MODULE_DEF", "HDLB_COMP_INSTANCE",
+				"HDLB_VARIABLE_DEF", "HDLB_FUNCTION_DEF", "HDLB_STM_EXPR",
+				"HDLB_STM_NOP", "HDLB_STM_BREAK", "HDLB_STM_CONTINUE",
+				"HDLB_STM_BLOCK", "HDLB_STM_IF", "HDLB_STM_CASE",
+				"HDLB_STM_FOR", "HDLB_STM_FOR_IN", "HDLB_STM_RETURN",
+				"HDLB_STM_ASSIGN", "HDLB_STM_WHILE", "HDLB_STM_DO_WHILE",
+				"HDLB_STM_PROCESS", "HDLB_STM_WAIT", "HDLB_STM_IMPORT",
+				"HDLB_EXPR_AND_STM", "HDLB_CALL", "HDLB_ID", "HDLB_STRING",
+				"HDLB_INT", "HDLB_BITSTRING", "HDLB_FLOAT", "HDLB_ARRAY",
+				"HDLB_NULL", "HDLB_OPEN", "HDLB_ALL", "HDLB_OTHERS",
+				"HDLB_TYPE_T", "HDLB_AUTO_T", "HDLB_EXPR_NONE", };
+
+const char* HdlAstBinaryNodeKind_toString(HdlAstBinaryNodeKind k) {
+	if (k <= 0 || static_cast<size_t>(k) >= HdlAstBinaryNodeKind_str.size())
+		return "<invalid>";
+	return HdlAstBinaryNodeKind_str[k];
+}
+
+HdlAstBinaryNode::HdlAstBinaryNode(const HdlAstBinaryFile *file,
+		uint32_t offset) :
+		_file(file), _offset(offset) {
+}
+
+HdlAstBinaryNodeKind HdlAstBinaryNode::kind() const {
+	if (is_null())
+		throw out_of_range("HdlAstBinaryNode: null node");
+	return static_cast<HdlAstBinaryNodeKind>(_file->u32_at(_offset) & 0xffff);
+}
+
+size_t HdlAstBinaryNode::field_cnt() const {
+	if (is_null())
+		throw out_of_range("HdlAstBinaryNode: null node");
+	return _file->u32_at(_offset) >> 16;
+}
+
+bool HdlAstBinaryNode::has_position() const {
+	return !is_null()
+			&& _file->u32_at(_offset + sizeof(uint32_t)) != HdlAstBinary::NONE;
+}
+
+HdlAstBinaryPosition HdlAstBinaryNode::position() const {
+	if (is_null())
+		throw out_of_range("HdlAstBinaryNode: null node");
+	return _file->position(_file->u32_at(_offset + sizeof(uint32_t)));
+}
+
+uint32_t HdlAstBinaryNode::u32(size_t field_i) const {
+	if (field_i >= field_cnt())
+		throw out_of_range(
+				string("HdlAstBinaryNode: invalid field index for ")
+						+ HdlAstBinaryNodeKind_toString(kind()));
+	return _file->u32_at(
+			_offset + HdlAstBinary::NODE_HEADER_SIZE
+					+ field_i * sizeof(uint32_t));
+}
+
+int32_t HdlAstBinaryNode::i32(size_t field_i) const {
+	return static_cast<int32_t>(u32(field_i));
+}
+
+string_view HdlAstBinaryNode::str(size_t field_i) const {
+	return _file->str(u32(field_i));
+}
+
+HdlAstBinaryNode HdlAstBinaryNode::node(size_t field_i) const {
+	return HdlAstBinaryNode(_file, u32(field_i));
+}
+
+HdlAstBinaryList HdlAstBinaryNode::list(size_t field_i) const {
+	return HdlAstBinaryList(_file, u32(field_i));
+}
+
+int64_t HdlAstBinaryNode::int_value() const {
+	if (kind() != HDLB_INT)
+		throw logic_error("HdlAstBinaryNode: not a HDLB_INT");
+	return static_cast<int64_t>((static_cast<uint64_t>(u32(1)) << 32) | u32(0));
+}
+
+double HdlAstBinaryNode::float_value() const {
+	if (kind() != HDLB_FLOAT)
+		throw logic_error("HdlAstBinaryNode: not a HDLB_FLOAT");
+	uint64_t bits = (static_cast<uint64_t>(u32(1)) << 32) | u32(0);
+	double v;
+	memcpy(&v, &bits, sizeof(v));
+	return v;
+}
+
+HdlAstBinaryList::HdlAstBinaryList(const HdlAstBinaryFile *file,
+		uint32_t offset) :
+		_file(file), _offset(offset) {
+}
+
+size_t HdlAstBinaryList::size() const {
+	if (is_null())
+		return 0;
+	return _file->u32_at(_offset);
+}
+
+HdlAstBinaryNode HdlAstBinaryList::operator[](size_t i) const {
+	if (i >= size())
+		throw out_of_range("HdlAstBinaryList: index out of range");
+	return HdlAstBinaryNode(_file,
+			_file->u32_at(_offset + (i + 1) * sizeof(uint32_t)));
+}
+
+string_view HdlAstBinaryList::str(size_t i) const {
+	if (i >= size())
+		throw out_of_range("HdlAstBinaryList: index out of range");
+	return _file->str(_file->u32_at(_offset + (i + 1) * sizeof(uint32_t)));
+}
+
+HdlAstBinaryFile::HdlAstBinaryFile(const filesystem::path &file_name) :
+		_data(nullptr), _size(0), _mapping(nullptr), _mapping_size(0) {
+	auto name = file_name.u8string();
+#ifdef HDLCONVERTOR_NO_MMAP
+	ifstream f(file_name, ios::binary);
+	if (!f) {
+		throw runtime_error(name + " can not be opened");
+	}
+	stringstream buff;
+	buff << f.rdbuf();
+	_owned_data = buff.str();
+	load(reinterpret_cast<const uint8_t*>(_owned_data.data()),
+			_owned_data.size());
+#else
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw runtime_error(name + " can not be opened");
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw runtime_error(name + " can not be opened");
+	}
+	size_t size = static_cast<size_t>(st.st_size);
+	if (size) {
+		void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (m == MAP_FAILED) {
+			close(fd);
+			throw runtime_error(name + " can not be memory mapped");
+		}
+		_mapping = m;
+		_mapping_size = size;
+	}
+	// the mapping remains valid after the file is closed
+	close(fd);
+	try {
+		load(static_cast<const uint8_t*>(_mapping), _mapping_size);
+	} catch (const exception &e) {
+		if (_mapping)
+			munmap(_mapping, _mapping_size);
+		throw runtime_error(name + ": " + e.what());
+	}
+#endif
+}
+
+HdlAstBinaryFile::HdlAstBinaryFile(const uint8_t *data, size_t size) :
+		_data(nullptr), _size(0), _mapping(nullptr), _mapping_size(0) {
+	load(data, size);
+}
+
+void HdlAstBinaryFile::load(const uint8_t *data, size_t size) {
+	_data = data;
+	_size = size;
+	if (size < HdlAstBinary::HEADER_SIZE
+			|| memcmp(data, HdlAstBinary::MAGIC, sizeof(HdlAstBinary::MAGIC)))
+		throw runtime_error("not a binary AST file");
+	if (version() != HdlAstBinary::VERSION)
+		throw runtime_error(
+				"unsupported version of the binary AST file "
+						+ to_string(version()) + " (expected "
+						+ to_string(HdlAstBinary::VERSION) + ")");
+	size_t file_size = u32_at(5 * sizeof(uint32_t));
+	if (file_size > size)
+		throw runtime_error("the binary AST file is truncated");
+	_size = file_size;
+
+	uint32_t strings = u32_at(3 * sizeof(uint32_t));
+	_strings_cnt = u32_at(strings);
+	size_t string_data = strings
+			+ (static_cast<size_t>(_strings_cnt) + 2) * sizeof(uint32_t);
+	if (_strings_cnt == 0 || string_data > _size)
+		throw runtime_error("the binary AST file has invalid string table");
+	_string_offsets = _data + strings + sizeof(uint32_t);
+	_string_data = reinterpret_cast<const char*>(_data + string_data);
+
+	_positions = u32_at(4 * sizeof(uint32_t));
+	_positions_cnt = u32_at(_positions);
+	if (_positions
+			+ (static_cast<size_t>(_positions_cnt)
+					* HdlAstBinary::POSITION_SIZE + 1) * sizeof(uint32_t)
+			> _size)
+		throw runtime_error("the binary AST file has invalid position table");
+}
+
+uint32_t HdlAstBinaryFile::version() const {
+	return u32_at(sizeof(uint32_t));
+}
+
+HdlAstBinaryNode HdlAstBinaryFile::root() const {
+	return HdlAstBinaryNode(this, u32_at(2 * sizeof(uint32_t)));
+}
+
+uint32_t HdlAstBinaryFile::u32_at(size_t offset) const {
+	if (offset % sizeof(uint32_t) || offset + sizeof(uint32_t) > _size)
+		throw out_of_range("HdlAstBinaryFile: invalid offset");
+	// the data does not have to be aligned if it is not memory mapped
+	uint32_t v;
+	memcpy(&v, _data + offset, sizeof(v));
+	return HdlAstBinary::to_le32(v);
+}
+
+string_view HdlAstBinaryFile::str(uint32_t i) const {
+	if (i >= _strings_cnt)
+		throw out_of_range("HdlAstBinaryFile: invalid string index");
+	uint32_t begin, end;
+	memcpy(&begin, _string_offsets + i * sizeof(uint32_t), sizeof(begin));
+	memcpy(&end, _string_offsets + (i + 1) * sizeof(uint32_t), sizeof(end));
+	begin = HdlAstBinary::to_le32(begin);
+	end = HdlAstBinary::to_le32(end);
+	if (begin > end
+			|| static_cast<size_t>(_string_data
+					- reinterpret_cast<const char*>(_data)) + end > _size)
+		throw out_of_range("HdlAstBinaryFile: invalid string");
+	return string_view(_string_data + begin, end - begin);
+}
+
+HdlAstBinaryPosition HdlAstBinaryFile::position(uint32_t i) const {
+	if (i >= _positions_cnt)
+		throw out_of_range("HdlAstBinaryFile: invalid position index");
+	size_t o = _positions + sizeof(uint32_t)
+			+ static_cast<size_t>(i) * HdlAstBinary::POSITION_SIZE
+					* sizeof(uint32_t);
+	return {u32_at(o),
+		u32_at(o + sizeof(uint32_t)),
+		u32_at(o + 2 * sizeof(uint32_t)),
+		u32_at(o + 3 * sizeof(uint32_t)),
+		str(u32_at(o + 4 * sizeof(uint32_t)))};
+}
+
+HdlAstBinaryFile::~HdlAstBinaryFile() {
+#ifndef HDLCONVERTOR_NO_MMAP
+	if (_mapping)
+		munmap(_mapping, _mapping_size);
+#endif
+}
+
+}
@@ -0,0 +1,350 @@
+#include <hdlConvertor/hdlAstBinary.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
+#include <hdlConvertor/hdlObjects/hdlOperatorType.h>
+
+namespace hdlConvertor {
+
+using namespace std;
+using namespace hdlObjects;
+
+// the lines/columns which do not fit are stored as unknown
+static uint32_t to_u32(size_t v) {
+	return v >= HdlAstBinary::NONE ? HdlAstBinary::NONE : v;
+}
+
+uint32_t HdlAstBinaryWriter::offset() const {
+	size_t o = HdlAstBinary::HEADER_SIZE + _nodes.size() * sizeof(uint32_t);
+	if (o >= HdlAstBinary::NONE)
+		throw length_error("HdlAstBinaryWriter: the AST is too large");
+	return o;
+}
+
+uint32_t HdlAstBinaryWriter::str(const string &s) {
+	auto r = _string_ids.insert( { s, _strings.size() });
+	if (r.second)
+		_strings.push_back(&r.first->first);
+	return r.first->second;
+}
+
+uint32_t HdlAstBinaryWriter::str(const HdlSymbol &s) {
+	auto r = _symbol_ids.insert( { s.id(), 0 });
+	if (r.second)
+		r.first->second = str(s.str());
+	return r.first->second;
+}
+
+uint32_t HdlAstBinaryWriter::position(const Position &pos) {
+	if (!pos.isKnown())
+		return HdlAstBinary::NONE;
+	uint32_t i = _positions.size() / HdlAstBinary::POSITION_SIZE;
+	auto f = pos.get_file();
+	_positions.insert(_positions.end(), { to_u32(pos.get_start_line()), to_u32(
+			pos.get_stop_line()), to_u32(pos.get_start_column()), to_u32(
+			pos.get_stop_column()), f ? str(*f) : 0 });
+	return i;
+}
+
+uint32_t HdlAstBinaryWriter::node(HdlAstBinaryNodeKind kind,
+		const Position *pos, initializer_list<uint32_t> fields) {
+	// the fields are evaluated before this call, the children are already written
+	uint32_t p = pos ? position(*pos) : HdlAstBinary::NONE;
+	auto o = offset();
+	_nodes.push_back(static_cast<uint32_t>(kind) | (fields.size() << 16));
+	_nodes.push_back(p);
+	_nodes.insert(_nodes.end(), fields);
+	return o;
+}
+
+uint32_t HdlAstBinaryWriter::stm_node(HdlAstBinaryNodeKind kind,
+		const iHdlStatement *o, initializer_list<uint32_t> fields) {
+	uint32_t labels = list(o->labels);
+	uint32_t p = position(o->position);
+	auto off = offset();
+	_nodes.push_back(
+			static_cast<uint32_t>(kind)
+					| ((HdlAstBinary::STM_FIELD_CNT + fields.size()) << 16));
+	_nodes.push_back(p);
+	_nodes.push_back(str(o->__doc__));
+	_nodes.push_back(labels);
+	_nodes.push_back(o->in_preproc ? HDLB_FLAG_IN_PREPROC : 0);
+	_nodes.insert(_nodes.end(), fields);
+	return off;
+}
+
+uint32_t HdlAstBinaryWriter::list(const vector<uint32_t> &items) {
+	auto o = offset();
+	_nodes.push_back(items.size());
+	_nodes.insert(_nodes.end(), items.begin(), items.end());
+	return o;
+}
+
+uint32_t HdlAstBinaryWriter::write(const string &o) {
+	return str(o);
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlExprAndStm &o) {
+	return node(HDLB_EXPR_AND_STM, nullptr, { write(o.expr), write(o.stm) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const iHdlObj *o) {
+	if (!o)
+		return 0;
+	return visit_iHdlObj(*o, [this](auto *obj) {
+		return write(obj);
+	});
+}
+
+uint32_t HdlAstBinaryWriter::write(const iHdlExpr *o) {
+	if (!o)
+		return 0;
+	auto pos = &o->position;
+	if (!o->data)
+		return node(HDLB_EXPR_NONE, pos, { });
+	if (auto c = hdl_expr_item_cast<HdlCall>(o->data))
+		return node(HDLB_CALL, pos,
+				{ str(string(HdlOperatorType_toString(c->op))), list(c->operands) });
+
+	auto v = hdl_expr_item_cast<HdlValue>(o->data);
+	switch (v->type) {
+	case HdlValueType::symb_ID:
+		return node(HDLB_ID, pos, { str(v->_str) });
+	case HdlValueType::symb_STRING:
+		return node(HDLB_STRING, pos, { str(*v->_string) });
+	case HdlValueType::symb_INT:
+		if (v->_int.is_bitstring()) {
+			auto bs = v->_int.get_bitstring();
+			return node(HDLB_BITSTRING, pos,
+					{ str(string(bs)), static_cast<uint32_t>(v->_int.get_bitstring_base()),
+							static_cast<uint32_t>(v->bits) });
+		} else {
+			uint64_t val = v->_int.get_val();
+			return node(HDLB_INT, pos, { static_cast<uint32_t>(val),
+					static_cast<uint32_t>(val >> 32), static_cast<uint32_t>(v->bits) });
+		}
+	case HdlValueType::symb_FLOAT: {
+		uint64_t val;
+		memcpy(&val, &v->_float, sizeof(val));
+		return node(HDLB_FLOAT, pos, { static_cast<uint32_t>(val),
+				static_cast<uint32_t>(val >> 32) });
+	}
+	case HdlValueType::symb_ARRAY:
+		return node(HDLB_ARRAY, pos, { v->_arr ? list(*v->_arr) : 0 });
+	case HdlValueType::symb_NULL:
+		return node(HDLB_NULL, pos, { });
+	case HdlValueType::symb_OPEN:
+		return node(HDLB_OPEN, pos, { });
+	case HdlValueType::symb_ALL:
+		return node(HDLB_ALL, pos, { });
+	case HdlValueType::symb_OTHERS:
+		return node(HDLB_OTHERS, pos, { });
+	case HdlValueType::symb_T:
+		return node(HDLB_TYPE_T, pos, { });
+	case HdlValueType::symb_AUTO:
+		return node(HDLB_AUTO_T, pos, { });
+	default:
+		throw runtime_error("HdlAstBinaryWriter: invalid type of the HdlValue");
+	}
+}
+
+uint32_t HdlAstBinaryWriter::write(const iHdlStatement *o) {
+	if (!o)
+		return 0;
+	return visit_iHdlStatement(*o, [this](auto *stm) {
+		return write(stm);
+	});
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlLibrary *o) {
+	return node(HDLB_LIBRARY, &o->position,
+			{ str(o->name), str(o->__doc__) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlNamespace *o) {
+	uint32_t flags = o->defs_only ? HDLB_FLAG_DEFS_ONLY : 0;
+	return node(HDLB_NAMESPACE, &o->position, { str(o->name), str(o->__doc__),
+			flags, list(o->objs) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlModuleDec *o) {
+	return node(HDLB_MODULE_DEC, &o->position, { str(o->name), str(o->__doc__),
+			list(o->generics), list(o->ports) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlModuleDef *o) {
+	return node(HDLB_MODULE_DEF, &o->position, { str(o->name), str(o->__doc__),
+			write(o->entityName), list(o->objs) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlCompInstance *o) {
+	return node(HDLB_COMP_INSTANCE, &o->position, { str(o->__doc__), write(
+			o->name), write(o->entityName), list(o->genericMap), list(
+			o->portMap) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlVariableDef *o) {
+	uint32_t flags = (o->is_latched ? HDLB_FLAG_IS_LATCHED : 0)
+			| (o->is_const ? HDLB_FLAG_IS_CONST : 0)
+			| (o->is_static ? HDLB_FLAG_IS_STATIC : 0);
+	return node(HDLB_VARIABLE_DEF, &o->position, { str(o->name), str(
+			o->__doc__), write(o->type), write(o->value),
+			static_cast<uint32_t>(o->direction), flags });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlFunctionDef *o) {
+	uint32_t flags = (o->is_operator ? HDLB_FLAG_IS_OPERATOR : 0)
+			| (o->is_static ? HDLB_FLAG_IS_STATIC : 0)
+			| (o->is_virtual ? HDLB_FLAG_IS_VIRTUAL : 0)
+			| (o->is_task ? HDLB_FLAG_IS_TASK : 0)
+			| (o->is_declaration_only ? HDLB_FLAG_IS_DECLARATION_ONLY : 0);
+	return node(HDLB_FUNCTION_DEF, &o->position, { str(o->name), str(
+			o->__doc__), write(o->returnT), list(o->params), list(o->body),
+			flags });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmExpr *o) {
+	return stm_node(HDLB_STM_EXPR, o, { write(o->expr) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmNop *o) {
+	return stm_node(HDLB_STM_NOP, o, { });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmBreak *o) {
+	return stm_node(HDLB_STM_BREAK, o, { });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmContinue *o) {
+	return stm_node(HDLB_STM_CONTINUE, o, { });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmBlock *o) {
+	return stm_node(HDLB_STM_BLOCK, o, { list(o->statements) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmIf *o) {
+	return stm_node(HDLB_STM_IF, o, { write(o->cond), write(o->ifTrue), list(
+			o->elseIfs), write(o->ifFalse) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmCase *o) {
+	return stm_node(HDLB_STM_CASE, o, { write(o->select_on), list(o->cases),
+			write(o->default_) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmFor *o) {
+	return stm_node(HDLB_STM_FOR, o, { write(o->init), write(o->cond), write(
+			o->step), write(o->body) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmForIn *o) {
+	return stm_node(HDLB_STM_FOR_IN, o, { list(o->var_defs), write(
+			o->collection), write(o->body) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmReturn *o) {
+	return stm_node(HDLB_STM_RETURN, o, { write(o->val) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmAssign *o) {
+	uint32_t flags = o->is_blocking ? HDLB_FLAG_IS_BLOCKING : 0;
+	return stm_node(HDLB_STM_ASSIGN, o, { write(o->dst), write(o->src), write(
+			o->time_delay), list(o->event_delay), flags });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmWhile *o) {
+	return stm_node(HDLB_STM_WHILE, o, { write(o->cond), write(o->body) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmDoWhile *o) {
+	return stm_node(HDLB_STM_DO_WHILE, o, { write(o->body), write(o->cond) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmProcess *o) {
+	return stm_node(HDLB_STM_PROCESS, o, { list(o->sensitivity_list), write(
+			o->body) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmWait *o) {
+	return stm_node(HDLB_STM_WAIT, o, { list(o->val) });
+}
+
+uint32_t HdlAstBinaryWriter::write(const HdlStmImport *o) {
+	return stm_node(HDLB_STM_IMPORT, o, { list(o->path) });
+}
+
+static void write_words(ostream &out, vector<uint32_t> &words) {
+	for (auto &w : words)
+		w = HdlAstBinary::to_le32(w);
+	out.write(reinterpret_cast<const char*>(words.data()),
+			words.size() * sizeof(uint32_t));
+}
+
+void HdlAstBinaryWriter::write(const HdlContext &ctx, ostream &out,
+		size_t first_obj) {
+	_nodes.clear();
+	_positions.clear();
+	_string_ids.clear();
+	_strings.clear();
+	_symbol_ids.clear();
+	str(string()); // the string 0 is always ""
+
+	vector<uint32_t> objs;
+	for (size_t i = first_obj; i < ctx.objs.size(); i++)
+		objs.push_back(write(ctx.objs[i]));
+	uint32_t root = node(HDLB_CONTEXT, nullptr, { list(objs) });
+
+	// the tables are stored after the nodes
+	uint32_t positions = offset();
+	_nodes.push_back(_positions.size() / HdlAstBinary::POSITION_SIZE);
+	_nodes.insert(_nodes.end(), _positions.begin(), _positions.end());
+	uint32_t strings = offset();
+	_nodes.push_back(_strings.size());
+	size_t str_offset = 0;
+	_nodes.push_back(str_offset);
+	for (auto s : _strings) {
+		str_offset += s->size();
+		_nodes.push_back(str_offset);
+	}
+	size_t size = offset() + str_offset;
+	size_t padding = (sizeof(uint32_t) - size % sizeof(uint32_t))
+			% sizeof(uint32_t);
+	size += padding;
+	if (size >= HdlAstBinary::NONE)
+		throw length_error("HdlAstBinaryWriter: the AST is too large");
+
+	uint32_t magic;
+	memcpy(&magic, HdlAstBinary::MAGIC, sizeof(magic));
+	vector<uint32_t> header = { magic, HdlAstBinary::VERSION, root, strings,
+			positions, static_cast<uint32_t>(size), 0, 0 };
+	// the magic is a sequence of bytes not a number
+	header[0] = HdlAstBinary::to_le32(header[0]);
+	write_words(out, header);
+	write_words(out, _nodes);
+	for (auto s : _strings)
+		out.write(s->data(), s->size());
+	const char zeros[sizeof(uint32_t)] = { 0 };
+	out.write(zeros, padding);
+
+	_nodes.clear();
+	_positions.clear();
+	_string_ids.clear();
+	_strings.clear();
+	_symbol_ids.clear();
+	if (!out)
+		throw runtime_error("HdlAstBinaryWriter: can not write the output");
+}
+
+void HdlAstBinaryWriter::write(const HdlContext &ctx,
+		const filesystem::path &file_name, size_t first_obj) {
+	ofstream f(file_name, ios::binary);
+	if (!f)
+		throw runtime_error(file_name.u8string() + " can not be opened");
+	write(ctx, f, first_obj);
+}
+
+}
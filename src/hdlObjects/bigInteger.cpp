@@ -1,18 +1,106 @@
 #include <hdlConvertor/hdlObjects/bigInteger.h>
 
+#include <limits>
+#include <stdexcept>
+#include <string.h>
+
 namespace hdlConvertor {
 namespace hdlObjects {
 
 BigInteger::BigInteger(int64_t v) :
-		val(v), bitstring(), bitstring_base(INVALID_BASE) {
+		_val(v), _bitstring_size(0), _bitstring_base(INVALID_BASE) {
+}
+
+BigInteger::BigInteger(std::string_view _bit_string, int base) :
+		_val(0), _bitstring_size(0), _bitstring_base(base) {
+	_set_bitstring(_bit_string);
+}
+
+BigInteger::BigInteger(const BigInteger &other) :
+		_val(other._val), _bitstring_size(0), _bitstring_base(
+				other._bitstring_base) {
+	if (other.is_bitstring())
+		_set_bitstring(other.get_bitstring());
+}
+
+BigInteger::BigInteger(BigInteger &&other) :
+		_bitstring_size(other._bitstring_size), _bitstring_base(
+				other._bitstring_base) {
+	// the union is copied as raw memory, the heap buffer changes the owner
+	memcpy(_bitstring_inline, other._bitstring_inline, INLINE_BITSTRING_SIZE);
+	other._val = 0;
+	other._bitstring_size = 0;
+	other._bitstring_base = INVALID_BASE;
+}
+
+BigInteger& BigInteger::operator=(const BigInteger &other) {
+	if (this == &other)
+		return *this;
+	_release();
+	_bitstring_base = other._bitstring_base;
+	if (other.is_bitstring())
+		_set_bitstring(other.get_bitstring());
+	else
+		_val = other._val;
+	return *this;
+}
+
+BigInteger& BigInteger::operator=(BigInteger &&other) {
+	if (this == &other)
+		return *this;
+	_release();
+	_bitstring_size = other._bitstring_size;
+	_bitstring_base = other._bitstring_base;
+	memcpy(_bitstring_inline, other._bitstring_inline, INLINE_BITSTRING_SIZE);
+	other._val = 0;
+	other._bitstring_size = 0;
+	other._bitstring_base = INVALID_BASE;
+	return *this;
 }
 
-BigInteger::BigInteger(const std::string & _bit_string, int base) :
-		val(0), bitstring(_bit_string), bitstring_base(base) {
+void BigInteger::_set_bitstring(std::string_view bit_string) {
+	if (bit_string.size() > std::numeric_limits<uint32_t>::max())
+		throw std::length_error("BigInteger: bitstring too long");
+	_bitstring_size = bit_string.size();
+	if (_bitstring_size <= INLINE_BITSTRING_SIZE) {
+		memcpy(_bitstring_inline, bit_string.data(), _bitstring_size);
+	} else {
+		_bitstring_heap = new char[_bitstring_size];
+		memcpy(_bitstring_heap, bit_string.data(), _bitstring_size);
+	}
+}
+
+void BigInteger::_release() {
+	if (is_bitstring() && _bitstring_size > INLINE_BITSTRING_SIZE)
+		delete[] _bitstring_heap;
+	_val = 0;
+	_bitstring_size = 0;
 }
 
 bool BigInteger::is_bitstring() const {
-	return bitstring_base != BigInteger::INVALID_BASE;
+	return _bitstring_base != BigInteger::INVALID_BASE;
+}
+
+int64_t BigInteger::get_val() const {
+	if (is_bitstring())
+		return 0;
+	return _val;
+}
+
+std::string_view BigInteger::get_bitstring() const {
+	if (!is_bitstring())
+		return std::string_view();
+	if (_bitstring_size <= INLINE_BITSTRING_SIZE)
+		return std::string_view(_bitstring_inline, _bitstring_size);
+	return std::string_view(_bitstring_heap, _bitstring_size);
+}
+
+int BigInteger::get_bitstring_base() const {
+	return _bitstring_base;
+}
+
+BigInteger::~BigInteger() {
+	_release();
 }
 
 }
@@ -5,12 +5,14 @@ using namespace std;
 namespace hdlConvertor {
 namespace hdlObjects {
 
-HdlCall::HdlCall() {
+HdlCall::HdlCall() :
+		iHdlExprItem(EXPR_ITEM_CALL) {
 	op = HdlOperatorType::ARROW;
 	operands.reserve(2);
 }
 
-HdlCall::HdlCall(const HdlCall &o) {
+HdlCall::HdlCall(const HdlCall &o) :
+		iHdlExprItem(EXPR_ITEM_CALL) {
 	operands.reserve(o.operands.size());
 	for (auto &op : o.operands) {
 		operands.push_back(make_unique<iHdlExpr>(*op));
@@ -18,14 +20,16 @@ HdlCall::HdlCall(const HdlCall &o) {
 	op = o.op;
 }
 
-HdlCall::HdlCall(HdlOperatorType operatorType, unique_ptr<iHdlExpr> op0) {
+HdlCall::HdlCall(HdlOperatorType operatorType, unique_ptr<iHdlExpr> op0) :
+		iHdlExprItem(EXPR_ITEM_CALL) {
 	operands.push_back(move(op0));
 	this->op = operatorType;
 
 }
 
 HdlCall::HdlCall(unique_ptr<iHdlExpr> op0, HdlOperatorType operatorType,
-		unique_ptr<iHdlExpr> op1) {
+		unique_ptr<iHdlExpr> op1) :
+		iHdlExprItem(EXPR_ITEM_CALL) {
 	if (op0) {
 		operands.push_back(move(op0));
 		//assert(!op1);
@@ -35,6 +39,11 @@ HdlCall::HdlCall(unique_ptr<iHdlExpr> op0, HdlOperatorType operatorType,
 	this->op = operatorType;
 }
 
+HdlCall::HdlCall(HdlOperatorType operatorType,
+		vector<unique_ptr<iHdlExpr>> &&operands) :
+		iHdlExprItem(EXPR_ITEM_CALL), op(operatorType), operands(move(operands)) {
+}
+
 HdlCall* HdlCall::call(unique_ptr<iHdlExpr> fn,
 		std::vector<unique_ptr<iHdlExpr>> &operands) {
 	auto o = new HdlCall();
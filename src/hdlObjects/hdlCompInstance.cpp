@@ -6,7 +6,8 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlCompInstance::HdlCompInstance(std::unique_ptr<iHdlExpr> _name,
-		std::unique_ptr<iHdlExpr> _entityName) {
+		std::unique_ptr<iHdlExpr> _entityName) :
+		iHdlObj(OBJ_COMP_INSTANCE) {
 	entityName = move(_entityName);
 	name = move(_name);
 }
@@ -3,7 +3,21 @@
 namespace hdlConvertor {
 namespace hdlObjects {
 
+ObjectArena& HdlContext::get_arena() {
+	if (arenas.empty())
+		arenas.emplace_back(new ObjectArena());
+	return *arenas.back();
+}
+
+SymbolTable& HdlContext::get_symbol_table() {
+	if (symbol_tables.empty())
+		symbol_tables.emplace_back(new SymbolTable());
+	return *symbol_tables.back();
+}
+
 HdlContext::~HdlContext() {
+	// the objects have to be destroyed before the memory of the arenas is released
+	objs.clear();
 }
 
 }
@@ -0,0 +1,288 @@
+#include <hdlConvertor/hdlObjects/hdlExprTree.h>
+
+#include <limits>
+#include <stdexcept>
+
+#include <hdlConvertor/hdlObjects/hdlCall.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
+#include <hdlConvertor/hdlObjects/iHdlExpr.h>
+
+using namespace std;
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+HdlExprTree::HdlExprTree(bool with_positions) :
+		with_positions(with_positions) {
+}
+
+HdlExprTree::node_id HdlExprTree::_add_node(HdlExprNodeKind kind) {
+	if (nodes.size() >= numeric_limits<node_id>::max())
+		throw length_error("HdlExprTree: too many nodes");
+	nodes.push_back( { kind, HdlOperatorType::ARROW, HdlValueType::symb_NULL,
+			-1, 0, 0, 0 });
+	if (with_positions)
+		positions.emplace_back();
+	return nodes.size() - 1;
+}
+
+void HdlExprTree::_check_operands(const node_id *begin,
+		const node_id *end) const {
+	// the operands have to be added before the node which is not added yet
+	for (auto o = begin; o != end; ++o) {
+		if (*o >= nodes.size())
+			throw out_of_range(
+					"HdlExprTree: the operand has to be added before the node");
+	}
+}
+
+void HdlExprTree::_set_operands(HdlExprNode &n, const node_id *begin,
+		const node_id *end) {
+	n.operands_begin = operands.size();
+	n.operands_cnt = end - begin;
+	operands.insert(operands.end(), begin, end);
+}
+
+HdlExprTree::node_id HdlExprTree::add_none() {
+	return _add_node(EXPR_NODE_NONE);
+}
+
+HdlExprTree::node_id HdlExprTree::add_value(HdlValueType value_type) {
+	auto n = _add_node(EXPR_NODE_VALUE);
+	nodes[n].value_type = value_type;
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_id(const HdlSymbol &name) {
+	auto n = add_value(HdlValueType::symb_ID);
+	nodes[n].value = symbols.size();
+	symbols.push_back(name);
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_str(const string &str) {
+	auto n = add_value(HdlValueType::symb_STRING);
+	nodes[n].value = strings.size();
+	strings.push_back(str);
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_int(const BigInteger &val, int bits) {
+	auto n = add_value(HdlValueType::symb_INT);
+	nodes[n].value = ints.size();
+	nodes[n].bits = bits;
+	ints.push_back(val);
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_float(double val) {
+	auto n = add_value(HdlValueType::symb_FLOAT);
+	nodes[n].value = floats.size();
+	floats.push_back(val);
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_array(const vector<node_id> &items) {
+	_check_operands(items.data(), items.data() + items.size());
+	auto n = add_value(HdlValueType::symb_ARRAY);
+	_set_operands(nodes[n], items.data(), items.data() + items.size());
+	return n;
+}
+
+HdlExprTree::node_id HdlExprTree::add_call(HdlOperatorType op,
+		const vector<node_id> &args) {
+	_check_operands(args.data(), args.data() + args.size());
+	auto n = _add_node(EXPR_NODE_CALL);
+	nodes[n].op = op;
+	_set_operands(nodes[n], args.data(), args.data() + args.size());
+	return n;
+}
+
+void HdlExprTree::clear() {
+	nodes.clear();
+	positions.clear();
+	operands.clear();
+	ints.clear();
+	floats.clear();
+	symbols.clear();
+	strings.clear();
+}
+
+// :return: the operands of the call/items of the array or nullptr if the expression has no children
+static const vector<unique_ptr<iHdlExpr>>* get_expr_children(
+		const iHdlExpr *e) {
+	if (e == nullptr || e->data == nullptr)
+		return nullptr;
+	if (auto c = hdl_expr_item_cast<HdlCall>(e->data))
+		return &c->operands;
+	auto v = hdl_expr_item_cast<HdlValue>(e->data);
+	if (v->type == HdlValueType::symb_ARRAY && v->_arr)
+		return v->_arr.get();
+	return nullptr;
+}
+
+HdlExprTree::node_id HdlExprTree::append(const iHdlExpr *expr) {
+	// post-order traversal with explicit stack (the generated expressions can be very deep)
+	class Frame {
+	public:
+		const iHdlExpr *expr;
+		const vector<unique_ptr<iHdlExpr>> *children;
+		size_t next_child;
+		// the index in "done" where the ids of the children of this expression start
+		size_t done_begin;
+	};
+	vector<Frame> stack;
+	vector<node_id> done;
+	stack.push_back( { expr, get_expr_children(expr), 0, 0 });
+	while (!stack.empty()) {
+		auto &f = stack.back();
+		if (f.children && f.next_child < f.children->size()) {
+			auto ch = (*f.children)[f.next_child++].get();
+			stack.push_back( { ch, get_expr_children(ch), 0, done.size() });
+			continue;
+		}
+		node_id n;
+		auto e = f.expr;
+		if (e == nullptr || e->data == nullptr) {
+			n = add_none();
+		} else if (auto c = hdl_expr_item_cast<HdlCall>(e->data)) {
+			n = _add_node(EXPR_NODE_CALL);
+			nodes[n].op = c->op;
+		} else {
+			auto v = hdl_expr_item_cast<HdlValue>(e->data);
+			switch (v->type) {
+			case HdlValueType::symb_ID:
+				n = add_id(v->_str);
+				break;
+			case HdlValueType::symb_STRING:
+				n = add_str(*v->_string);
+				break;
+			case HdlValueType::symb_INT:
+				n = add_int(v->_int, v->bits);
+				break;
+			case HdlValueType::symb_FLOAT:
+				n = add_float(v->_float);
+				break;
+			default:
+				n = add_value(v->type);
+				break;
+			}
+		}
+		if (f.children) {
+			auto b = done.data() + f.done_begin;
+			_set_operands(nodes[n], b, b + f.children->size());
+			done.resize(f.done_begin);
+		}
+		if (e && with_positions)
+			positions[n] = e->position;
+		done.push_back(n);
+		stack.pop_back();
+	}
+	return done.back();
+}
+
+HdlExprTree HdlExprTree::from_expr(const iHdlExpr &expr,
+		bool with_positions) {
+	HdlExprTree t(with_positions);
+	t.append(&expr);
+	return t;
+}
+
+unique_ptr<iHdlExpr> HdlExprTree::to_expr(node_id root_n) const {
+	if (root_n >= nodes.size())
+		throw out_of_range("HdlExprTree::to_expr: invalid node");
+	// resolve which nodes are used by the expression and how many times
+	// (the operands have smaller index than the node)
+	vector<uint32_t> use_cnt(root_n + 1, 0);
+	use_cnt[root_n] = 1;
+	for (size_t i = root_n + 1; i-- > 0;) {
+		if (!use_cnt[i])
+			continue;
+		auto &n = nodes[i];
+		for (auto o = operands_begin(n); o != operands_end(n); ++o)
+			use_cnt[*o]++;
+	}
+
+	// build the expressions from the leaves to the root
+	vector<unique_ptr<iHdlExpr>> built(root_n + 1);
+	auto take_operand = [&](node_id o) -> unique_ptr<iHdlExpr> {
+		if (nodes[o].kind == EXPR_NODE_NONE)
+			return nullptr;
+		auto &e = built[o];
+		if (--use_cnt[o] == 0)
+			return move(e);
+		// the node is shared, the last user gets the original
+		auto c = make_unique<iHdlExpr>(*e);
+		c->position = e->position;
+		return c;
+	};
+	auto take_operands = [&](const HdlExprNode &n) {
+		vector<unique_ptr<iHdlExpr>> ops;
+		ops.reserve(n.operands_cnt);
+		for (auto o = operands_begin(n); o != operands_end(n); ++o)
+			ops.push_back(take_operand(*o));
+		return ops;
+	};
+
+	for (node_id i = 0; i <= root_n; i++) {
+		if (!use_cnt[i])
+			continue;
+		auto &n = nodes[i];
+		unique_ptr<iHdlExpr> e;
+		switch (n.kind) {
+		case EXPR_NODE_NONE:
+			e = make_unique<iHdlExpr>();
+			break;
+		case EXPR_NODE_CALL:
+			e = make_unique<iHdlExpr>();
+			e->data = new HdlCall(n.op, take_operands(n));
+			break;
+		case EXPR_NODE_VALUE:
+			switch (n.value_type) {
+			case HdlValueType::symb_ID: {
+				auto v = new HdlValue(n.value_type);
+				v->_str = symbols[n.value];
+				e = make_unique<iHdlExpr>(v);
+				break;
+			}
+			case HdlValueType::symb_STRING: {
+				auto v = new HdlValue(n.value_type);
+				*v->_string = strings[n.value];
+				e = make_unique<iHdlExpr>(v);
+				break;
+			}
+			case HdlValueType::symb_INT:
+				e = make_unique<iHdlExpr>(ints[n.value], n.bits);
+				break;
+			case HdlValueType::symb_FLOAT:
+				e = make_unique<iHdlExpr>(new HdlValue(floats[n.value]));
+				break;
+			case HdlValueType::symb_ARRAY:
+				e = make_unique<iHdlExpr>(
+						new HdlValue(
+								make_unique<vector<unique_ptr<iHdlExpr>>>(
+										take_operands(n))));
+				break;
+			case HdlValueType::symb_T:
+				e = iHdlExpr::TYPE_T();
+				break;
+			case HdlValueType::symb_AUTO:
+				e = iHdlExpr::AUTO_T();
+				break;
+			default:
+				e = make_unique<iHdlExpr>(new HdlValue(n.value_type));
+				break;
+			}
+			break;
+		default:
+			throw runtime_error("HdlExprTree::to_expr: invalid node kind");
+		}
+		if (with_positions)
+			e->position = positions[i];
+		built[i] = move(e);
+	}
+	return move(built[root_n]);
+}
+
+}
+}
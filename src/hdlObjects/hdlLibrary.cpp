@@ -4,7 +4,7 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlLibrary::HdlLibrary(const std::string& name) :
-		WithNameAndDoc(name), iHdlObj() {
+		WithNameAndDoc(name), iHdlObj(OBJ_LIBRARY) {
 }
     
 HdlLibrary::~HdlLibrary() {
@@ -5,7 +5,7 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlModuleDec::HdlModuleDec() :
-		WithNameAndDoc() {
+		WithNameAndDoc(), iHdlObj(OBJ_MODULE_DEC) {
 }
 HdlVariableDef* HdlModuleDec::getPortByName(const std::string &name) {
 	for (auto & p : ports) {
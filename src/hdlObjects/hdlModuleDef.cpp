@@ -3,6 +3,10 @@
 namespace hdlConvertor {
 namespace hdlObjects {
 
+HdlModuleDef::HdlModuleDef() :
+		WithNameAndDoc(), iHdlObj(OBJ_MODULE_DEF) {
+}
+
 HdlModuleDef::~HdlModuleDef() {
 }
 
@@ -6,7 +6,7 @@ namespace hdlObjects {
 using namespace std;
 
 HdlNamespace::HdlNamespace() :
-		WithNameAndDoc(), defs_only(false) {
+		WithNameAndDoc(), iHdlObj(OBJ_NAMESPACE), defs_only(false) {
 }
 
 HdlNamespace::~HdlNamespace() {
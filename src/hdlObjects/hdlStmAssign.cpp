@@ -15,7 +15,7 @@ HdlStmAssign::HdlStmAssign(std::unique_ptr<iHdlExpr> _dst,
 		std::unique_ptr<iHdlExpr> _src, std::unique_ptr<iHdlExpr> _time_delay,
 		std::unique_ptr<vector<std::unique_ptr<iHdlExpr>>> _event_delay,
 		bool _is_blocking) :
-		iHdlStatement(), dst(move(_dst)), src(move(_src)), time_delay(
+		iHdlStatement(OBJ_STM_ASSIGN), dst(move(_dst)), src(move(_src)), time_delay(
 				move(_time_delay)), event_delay(move(_event_delay)), is_blocking(
 				_is_blocking) {
 	if (dst == nullptr || src == nullptr) {
@@ -4,15 +4,15 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlStmBlock::HdlStmBlock() :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_BLOCK) {
 }
 
 HdlStmBlock::HdlStmBlock(std::vector<std::unique_ptr<iHdlObj>> &_statements) :
-		iHdlStatement(), statements(move(_statements)) {
+		iHdlStatement(OBJ_STM_BLOCK), statements(move(_statements)) {
 }
 
 HdlStmBlock::HdlStmBlock(std::unique_ptr<iHdlObj> obj) :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_BLOCK) {
 	statements.push_back(move(obj));
 }
 
@@ -4,7 +4,7 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlStmExpr::HdlStmExpr(std::unique_ptr<iHdlExpr> _expr) :
-		iHdlStatement(), expr(move(_expr)) {
+		iHdlStatement(OBJ_STM_EXPR), expr(move(_expr)) {
 }
 
 
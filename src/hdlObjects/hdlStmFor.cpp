@@ -7,7 +7,7 @@ namespace hdlObjects {
 HdlStmFor::HdlStmFor(std::unique_ptr<iHdlStatement> _init,
 		std::unique_ptr<iHdlExpr> _cond, std::unique_ptr<iHdlStatement> _step,
 		std::unique_ptr<iHdlStatement> _body) :
-		iHdlStatement(), init(move(_init)), cond(move(_cond)), step(
+		iHdlStatement(OBJ_STM_FOR), init(move(_init)), cond(move(_cond)), step(
 				move(_step)), body(move(_body)) {
 
 }
@@ -18,7 +18,7 @@ HdlStmFor::~HdlStmFor() {
 HdlStmForIn::HdlStmForIn(std::unique_ptr<HdlVariableDef> _var,
 		std::unique_ptr<iHdlExpr> _collection,
 		std::unique_ptr<iHdlStatement> _body) :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_FOR_IN) {
 	var_defs.push_back(move(_var));
 	collection = move(_collection);
 	body = move(_body);
@@ -26,7 +26,8 @@ HdlStmForIn::HdlStmForIn(std::unique_ptr<HdlVariableDef> _var,
 
 HdlStmForIn::HdlStmForIn(std::vector<std::unique_ptr<iHdlObj>> &_vars,
 		std::unique_ptr<iHdlExpr> _collection,
-		std::unique_ptr<iHdlStatement> _body) {
+		std::unique_ptr<iHdlStatement> _body) :
+		iHdlStatement(OBJ_STM_FOR_IN) {
 	var_defs = move(_vars);
 	collection = move(_collection);
 	body = move(_body);
@@ -35,7 +36,7 @@ HdlStmForIn::HdlStmForIn(std::vector<std::unique_ptr<iHdlObj>> &_vars,
 HdlStmForIn::HdlStmForIn(std::vector<std::unique_ptr<iHdlExpr>> &vars,
 		std::unique_ptr<iHdlExpr> _collection,
 		std::unique_ptr<iHdlStatement> _body) :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_FOR_IN) {
 	for (auto &v : vars) {
 		var_defs.push_back(std::make_unique<HdlStmExpr>(move(v)));
 	}
@@ -45,7 +46,8 @@ HdlStmForIn::HdlStmForIn(std::vector<std::unique_ptr<iHdlExpr>> &vars,
 
 HdlStmForIn::HdlStmForIn(std::unique_ptr<iHdlExpr> _var,
 		std::unique_ptr<iHdlExpr> _collection,
-		std::unique_ptr<iHdlStatement> _body) {
+		std::unique_ptr<iHdlStatement> _body) :
+		iHdlStatement(OBJ_STM_FOR_IN) {
 	var_defs.push_back(std::make_unique<HdlStmExpr>(move(_var)));
 	collection = move(_collection);
 	body = move(_body);
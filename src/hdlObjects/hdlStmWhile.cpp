@@ -5,7 +5,7 @@ namespace hdlObjects {
 
 HdlStmWhile::HdlStmWhile(std::unique_ptr<iHdlExpr> _cond,
 		std::unique_ptr<iHdlStatement> _body) :
-		iHdlStatement(), cond(move(_cond)), body(move(_body)) {
+		iHdlStatement(OBJ_STM_WHILE), cond(move(_cond)), body(move(_body)) {
 }
 
 HdlStmWhile::~HdlStmWhile() {
@@ -13,7 +13,7 @@ HdlStmWhile::~HdlStmWhile() {
 
 HdlStmDoWhile::HdlStmDoWhile(std::unique_ptr<iHdlStatement> _body,
 		std::unique_ptr<iHdlExpr> _cond) :
-		iHdlStatement(), body(move(_body)), cond(move(_cond)) {
+		iHdlStatement(OBJ_STM_DO_WHILE), body(move(_body)), cond(move(_cond)) {
 }
 
 HdlStmDoWhile::~HdlStmDoWhile() {
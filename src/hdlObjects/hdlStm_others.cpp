@@ -4,30 +4,30 @@ namespace hdlConvertor {
 namespace hdlObjects {
 
 HdlStmImport::HdlStmImport(std::vector<std::unique_ptr<iHdlExpr>> &_path) :
-		iHdlStatement(), path(move(_path)) {
+		iHdlStatement(OBJ_STM_IMPORT), path(move(_path)) {
 }
 
 HdlStmImport::~HdlStmImport() {
 }
 
 HdlStmReturn::HdlStmReturn() :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_RETURN) {
 }
 
 HdlStmReturn::HdlStmReturn(std::unique_ptr<iHdlExpr> _val) :
-		iHdlStatement(), val(move(_val)) {
+		iHdlStatement(OBJ_STM_RETURN), val(move(_val)) {
 }
 
 HdlStmReturn::~HdlStmReturn() {
 }
 
 HdlStmWait::HdlStmWait(std::unique_ptr<iHdlExpr> _val) :
-		iHdlStatement() {
+		iHdlStatement(OBJ_STM_WAIT) {
 	val.push_back(move(_val));
 }
 
 HdlStmWait::HdlStmWait(std::vector<std::unique_ptr<iHdlExpr>> &_val) :
-		iHdlStatement(), val(move(_val)) {
+		iHdlStatement(OBJ_STM_WAIT), val(move(_val)) {
 }
 
 HdlStmWait::~HdlStmWait() {
@@ -0,0 +1,55 @@
+#include <hdlConvertor/hdlObjects/hdlSymbol.h>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+using namespace std;
+
+thread_local SymbolTable *SymbolTable::current = nullptr;
+
+HdlSymbolItem::HdlSymbolItem(const SymbolTable *table, const string &str) :
+		table(table), ref_cnt(1), str(str) {
+}
+
+SymbolTable::SymbolTable() {
+}
+
+const HdlSymbolItem* SymbolTable::intern(const string &str) {
+	auto i = _items.find(str);
+	if (i != _items.end())
+		return i->second.get();
+	auto item = new HdlSymbolItem(this, str);
+	_items.emplace(item->str, unique_ptr<HdlSymbolItem>(item));
+	return item;
+}
+
+size_t SymbolTable::size() const {
+	return _items.size();
+}
+
+SymbolTableScope::SymbolTableScope(SymbolTable *table) :
+		prev(SymbolTable::current) {
+	SymbolTable::current = table;
+}
+
+SymbolTableScope::~SymbolTableScope() {
+	SymbolTable::current = prev;
+}
+
+// the table of the empty symbol (contains only HdlSymbol::EMPTY)
+static const SymbolTable empty_symbol_table;
+const HdlSymbolItem HdlSymbol::EMPTY(&empty_symbol_table, "");
+
+HdlSymbol::HdlSymbol(const string &str) {
+	if (str.empty()) {
+		_item = &EMPTY;
+	} else if (auto t = SymbolTable::current) {
+		_item = t->intern(str);
+	} else {
+		// the symbol owns its string (ref_cnt = 1)
+		_item = new HdlSymbolItem(nullptr, str);
+	}
+}
+
+}
+}
@@ -2,50 +2,91 @@
 #include <hdlConvertor/hdlObjects/iHdlExpr.h>
 
 #include <array>
+#include <new>
 
 using namespace std;
 
 namespace hdlConvertor {
 namespace hdlObjects {
 
+// construct the member of the union used by the type
+static void HdlValue_init_value(HdlValue &v) {
+	switch (v.type) {
+	case HdlValueType::symb_INT:
+		new (&v._int) BigInteger(0);
+		break;
+	case HdlValueType::symb_FLOAT:
+		v._float = 0.0;
+		break;
+	case HdlValueType::symb_ID:
+		new (&v._str) HdlSymbol();
+		break;
+	case HdlValueType::symb_STRING:
+		new (&v._string) unique_ptr<string>(make_unique<string>());
+		break;
+	case HdlValueType::symb_ARRAY:
+		new (&v._arr) unique_ptr<vector<unique_ptr<iHdlExpr>>>();
+		break;
+	default:
+		break;
+	}
+}
+
 HdlValue::HdlValue(const HdlValue &other) :
-		type(other.type), bits(other.bits), _int(other._int), _float(
-				other._float), _str(other._str) {
-	if (other._arr) {
-		_arr = make_unique<vector<unique_ptr<iHdlExpr>>>();
-		clone_unique_ptr_vector(*other._arr, *_arr);
-	} else {
-		_arr = nullptr;
+		iHdlExprItem(EXPR_ITEM_VALUE), type(other.type), bits(other.bits) {
+	switch (type) {
+	case HdlValueType::symb_INT:
+		new (&_int) BigInteger(other._int);
+		break;
+	case HdlValueType::symb_FLOAT:
+		_float = other._float;
+		break;
+	case HdlValueType::symb_ID:
+		new (&_str) HdlSymbol(other._str);
+		break;
+	case HdlValueType::symb_STRING:
+		new (&_string) unique_ptr<string>(make_unique<string>(*other._string));
+		break;
+	case HdlValueType::symb_ARRAY:
+		new (&_arr) unique_ptr<vector<unique_ptr<iHdlExpr>>>();
+		if (other._arr) {
+			_arr = make_unique<vector<unique_ptr<iHdlExpr>>>();
+			clone_unique_ptr_vector(*other._arr, *_arr);
+		}
+		break;
+	default:
+		break;
 	}
 }
 
 HdlValue::HdlValue(BigInteger __int) :
-		type(HdlValueType::symb_INT), bits(-1), _int(__int), _float(0.0), _str(
-				""), _arr(nullptr) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(HdlValueType::symb_INT), bits(-1), _int(
+				move(__int)) {
 }
 
 HdlValue::HdlValue(const BigInteger &__int, int _bits) :
-		type(HdlValueType::symb_INT), bits(_bits), _int(__int), _float(0.0), _str(
-				""), _arr(nullptr) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(HdlValueType::symb_INT), bits(_bits), _int(
+				__int) {
 }
 
 HdlValue::HdlValue(double __float) :
-		type(HdlValueType::symb_FLOAT), bits(-1), _int(0), _float(__float), _str(
-				""), _arr(nullptr) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(HdlValueType::symb_FLOAT), bits(-1), _float(
+				__float) {
 }
 
 HdlValue::HdlValue(string __str) :
-		type(HdlValueType::symb_ID), bits(-1), _int(0), _float(0.0), _str(
-				__str), _arr(nullptr) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(HdlValueType::symb_ID), bits(-1), _str(
+				__str) {
 }
 
 HdlValue::HdlValue(HdlValueType _type) :
-		type(_type), bits(-1), _int(0), _float(0.0), _str(""), _arr(nullptr) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(_type), bits(-1) {
+	HdlValue_init_value(*this);
 }
 
 HdlValue::HdlValue(unique_ptr<vector<unique_ptr<iHdlExpr>>> arr) :
-		type(HdlValueType::symb_ARRAY), bits(-1), _int(0), _float(0.0), _str(
-				""), _arr(move(arr)) {
+		iHdlExprItem(EXPR_ITEM_VALUE), type(HdlValueType::symb_ARRAY), bits(-1), _arr(
+				move(arr)) {
 }
 
 iHdlExprItem* HdlValue::clone() const {
@@ -53,6 +94,22 @@ iHdlExprItem* HdlValue::clone() const {
 }
 
 HdlValue::~HdlValue() {
+	switch (type) {
+	case HdlValueType::symb_INT:
+		_int.~BigInteger();
+		break;
+	case HdlValueType::symb_ID:
+		_str.~HdlSymbol();
+		break;
+	case HdlValueType::symb_STRING:
+		_string.~unique_ptr();
+		break;
+	case HdlValueType::symb_ARRAY:
+		_arr.~unique_ptr();
+		break;
+	default:
+		break;
+	}
 }
 
 const array<const string, HdlValueType::symb_AUTO + 1> HdlValueType_str = {
@@ -7,7 +7,7 @@ namespace hdlObjects {
 
 HdlVariableDef::HdlVariableDef(const string &id, unique_ptr<iHdlExpr> _type,
 		unique_ptr<iHdlExpr> val) :
-		iHdlObj(), WithNameAndDoc(id), type(move(_type)), value(move(val)), is_latched(
+		iHdlObj(OBJ_VARIABLE_DEF), WithNameAndDoc(id), type(move(_type)), value(move(val)), is_latched(
 				false), is_const(false), is_static(false), direction(
 				HdlDirection::DIR_INTERNAL) {
 }
@@ -15,11 +15,13 @@ HdlValue __v = { BigInteger(0) };
 static HdlValue AutoType_t(HdlValueType::symb_AUTO);
 static HdlValue Type_t(HdlValueType::symb_T); // symbol representing that expr is type of type;
 
-iHdlExpr::iHdlExpr() {
+iHdlExpr::iHdlExpr() :
+		iHdlObj(OBJ_EXPR) {
 	data = nullptr;
 }
 
-iHdlExpr::iHdlExpr(const iHdlExpr &expr) {
+iHdlExpr::iHdlExpr(const iHdlExpr &expr) :
+		iHdlObj(OBJ_EXPR) {
 	if (expr.data == nullptr || expr.data == &Type_t
 			|| expr.data == &AutoType_t) {
 		data = expr.data;
@@ -28,27 +30,30 @@ iHdlExpr::iHdlExpr(const iHdlExpr &expr) {
 	}
 }
 iHdlExpr::iHdlExpr(HdlOperatorType operatorType,
-		std::unique_ptr<iHdlExpr> op0) {
+		std::unique_ptr<iHdlExpr> op0) :
+		iHdlObj(OBJ_EXPR) {
 	assert(op0);
 	data = new HdlCall(operatorType, move(op0));
 }
 iHdlExpr::iHdlExpr(std::unique_ptr<iHdlExpr> op0, HdlOperatorType operatorType,
-		std::unique_ptr<iHdlExpr> op1) {
+		std::unique_ptr<iHdlExpr> op1) :
+		iHdlObj(OBJ_EXPR) {
 	assert(op0);
 	data = new HdlCall(move(op0), operatorType, move(op1));
 }
 iHdlExpr::iHdlExpr(const HdlValue &value) :
-		data(new HdlValue(value)) {
+		iHdlObj(OBJ_EXPR), data(new HdlValue(value)) {
 }
 iHdlExpr::iHdlExpr(HdlValue *value) :
-		data(value) {
+		iHdlObj(OBJ_EXPR), data(value) {
 }
 
-iHdlExpr::iHdlExpr(const BigInteger &value, int bits) {
+iHdlExpr::iHdlExpr(const BigInteger &value, int bits) :
+		iHdlObj(OBJ_EXPR) {
 	data = new HdlValue(value, bits);
 }
 iHdlExpr::iHdlExpr(const BigInteger &value) :
-		data(new HdlValue(value, -1)) {
+		iHdlObj(OBJ_EXPR), data(new HdlValue(value, -1)) {
 }
 std::unique_ptr<iHdlExpr> iHdlExpr::INT(
 		TerminalNode *node, const std::string &strVal, int base) {
@@ -66,8 +71,8 @@ std::unique_ptr<iHdlExpr> iHdlExpr::FLOAT(TerminalNode *node, double val) {
 }
 
 std::unique_ptr<iHdlExpr> iHdlExpr::STR(TerminalNode *node, std::string strVal) {
-	auto l = new HdlValue(strVal);
-	l->type = HdlValueType::symb_STRING;
+	auto l = new HdlValue(HdlValueType::symb_STRING);
+	*l->_string = move(strVal);
 	return create_object<iHdlExpr>(node, l);
 }
 
@@ -0,0 +1,21 @@
+#include <hdlConvertor/hdlObjects/iHdlObj.h>
+#include <array>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+const std::array<const char*, OBJ_STM_WHILE + 1> HdlObjKind_str = { "EXPR",
+		"LIBRARY", "NAMESPACE", "MODULE_DEC", "MODULE_DEF", "COMP_INSTANCE",
+		"VARIABLE_DEF", "FUNCTION_DEF", "STM_ASSIGN", "STM_BLOCK", "STM_BREAK",
+		"STM_CASE", "STM_CONTINUE", "STM_DO_WHILE", "STM_EXPR", "STM_FOR",
+		"STM_FOR_IN", "STM_IF", "STM_IMPORT", "STM_NOP", "STM_PROCESS",
+		"STM_RETURN", "STM_WAIT", "STM_WHILE" };
+
+const char* HdlObjKind_toString(HdlObjKind k) {
+	if (k < 0 || k >= HdlObjKind_str.size())
+		return "<invalid>";
+	return HdlObjKind_str[k];
+}
+
+}
+}
@@ -13,8 +13,8 @@ HdlExprAndStm::HdlExprAndStm(std::unique_ptr<iHdlExpr> _expr,
 		expr(move(_expr)), stm(move(_stm)) {
 }
 
-iHdlStatement::iHdlStatement() :
-		iHdlObj() {
+iHdlStatement::iHdlStatement(HdlObjKind _obj_kind) :
+		iHdlObj(_obj_kind) {
 	in_preproc = false;
 }
 
@@ -0,0 +1,69 @@
+#include <hdlConvertor/hdlObjects/objectArena.h>
+
+#include <new>
+
+namespace hdlConvertor {
+namespace hdlObjects {
+
+using namespace std;
+
+thread_local ObjectArena *ObjectArena::current = nullptr;
+
+static char* new_arena_block(size_t size) {
+	return static_cast<char*>(::operator new(size,
+			align_val_t(ObjectArena::HEAP_OBJ_ALIGN)));
+}
+
+void ObjectArena::BlockDeleter::operator()(char *b) const {
+	::operator delete(b, align_val_t(HEAP_OBJ_ALIGN));
+}
+
+ObjectArena::ObjectArena() :
+		_free_ptr(nullptr), _free_size(0), _allocated_size(0) {
+}
+
+void* ObjectArena::allocate(size_t size) {
+	// the objects start at HEAP_OBJ_ALIGN * n + ARENA_OBJ_TAG (see deallocate_object)
+	size = (size + HEAP_OBJ_ALIGN - 1) & ~(HEAP_OBJ_ALIGN - 1);
+	if (size > _free_size) {
+		if (size > BLOCK_SIZE / 4) {
+			// the large object has its own block
+			// (so the rest of actual block is not wasted)
+			_blocks.emplace_back(new_arena_block(size + ARENA_OBJ_TAG));
+			_allocated_size += size + ARENA_OBJ_TAG;
+			return _blocks.back().get() + ARENA_OBJ_TAG;
+		}
+		_blocks.emplace_back(new_arena_block(BLOCK_SIZE));
+		_allocated_size += BLOCK_SIZE;
+		_free_ptr = _blocks.back().get() + ARENA_OBJ_TAG;
+		// the rest of the block is smaller than HEAP_OBJ_ALIGN and it is not used
+		_free_size = BLOCK_SIZE - HEAP_OBJ_ALIGN;
+	}
+	void *res = _free_ptr;
+	_free_ptr += size;
+	_free_size -= size;
+	return res;
+}
+
+size_t ObjectArena::get_allocated_size() const {
+	return _allocated_size;
+}
+
+void* ObjectArena::allocate_object(size_t size) {
+	auto arena = current;
+	if (arena)
+		return arena->allocate(size);
+	return ::operator new(size, align_val_t(HEAP_OBJ_ALIGN));
+}
+
+ObjectArenaScope::ObjectArenaScope(ObjectArena *arena) :
+		prev(ObjectArena::current) {
+	ObjectArena::current = arena;
+}
+
+ObjectArenaScope::~ObjectArenaScope() {
+	ObjectArena::current = prev;
+}
+
+}
+}
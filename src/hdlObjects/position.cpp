@@ -1,8 +1,55 @@
 #include <hdlConvertor/hdlObjects/position.h>
+#include <hdlConvertor/sourceMap.h>
 
 namespace hdlConvertor {
 namespace hdlObjects {
 
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+
+Position::Position() :
+		Position(INVALID_INDEX, 0, nullptr) {
+}
+
+Position::Position(uint32_t start, uint32_t length, const SourceLines *lines) :
+		start(start), length(length), lines(lines) {
+}
+
+size_t Position::get_start_line() const {
+	if (!isKnown())
+		return INVALID;
+	return lines->get_src_line(start);
+}
+
+size_t Position::get_stop_line() const {
+	if (!isKnown())
+		return INVALID;
+	return lines->get_src_line(length ? start + length - 1 : start);
+}
+
+size_t Position::get_start_column() const {
+	if (!isKnown())
+		return INVALID;
+	return lines->get_column(start);
+}
+
+size_t Position::get_stop_column() const {
+	if (!isKnown())
+		return INVALID;
+	return lines->get_column(length ? start + length - 1 : start);
+}
+
+std::shared_ptr<const std::string> Position::get_file() const {
+	if (!isKnown())
+		return nullptr;
+	return lines->get_file(start);
+}
+
+bool Position::isKnown() const {
+	return lines != nullptr;
+}
+
+#else
+
 Position::Position() :
 		Position(INVALID, INVALID, INVALID, INVALID) {
 }
@@ -15,10 +62,32 @@ Position::Position(size_t startLine, size_t stopLine, size_t startColumn,
 	this->stopColumn = stopColumn;
 }
 
+Position::Position(size_t startLine, size_t stopLine, size_t startColumn,
+		size_t stopColumn, std::shared_ptr<const std::string> file) :
+		Position(startLine, stopLine, startColumn, stopColumn) {
+	this->file = std::move(file);
+}
+
+void Position::apply_source_map() {
+	auto sm = SourceMap::current;
+	if (sm == nullptr)
+		return;
+	auto start = sm->find(startLine);
+	if (start) {
+		file = sm->files[start->file_id];
+		startLine = SourceMap::translate(*start, startLine);
+	}
+	auto stop = sm->find(stopLine);
+	if (stop)
+		stopLine = SourceMap::translate(*stop, stopLine);
+}
+
 bool Position::isKnown() const {
 	return startLine != INVALID || stopLine != INVALID || startColumn != INVALID
 			|| stopColumn != INVALID;
 }
 
+#endif
+
 }
 }
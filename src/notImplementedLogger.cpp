@@ -3,7 +3,7 @@
 
 namespace hdlConvertor {
 
-bool NotImplementedLogger::ENABLE = true;
+std::atomic<bool> NotImplementedLogger::ENABLE(true);
 
 void NotImplementedLogger::print(const char *msg,
 		antlr4::ParserRuleContext *ctx) {
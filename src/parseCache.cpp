@@ -0,0 +1,169 @@
+#include <hdlConvertor/parseCache.h>
+
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+
+#include <hdlConvertor/hdlAstBinary.h>
+#include <hdlConvertor/universal_fs.h>
+
+namespace hdlConvertor {
+
+using namespace std;
+using namespace hdlConvertor::hdlObjects;
+
+// change if the meaning of the cached data changes without the change of HdlAstBinary::VERSION
+static const char PARSE_CACHE_KEY_SALT[] = "hdlConvertor.ParseCache.1";
+
+/*
+ * 128b hash (FNV-1a and a multiplicative hash of 64b words) which does not depend
+ * on the platform or the process, the length of each value is hashed as well
+ * so the sequence of the values is unambiguous
+ * */
+class ParseCacheHasher {
+	uint64_t _fnv;
+	uint64_t _mix;
+
+	void _update_bytes(const unsigned char *d, size_t size) {
+		for (size_t i = 0; i < size; i++) {
+			_fnv ^= d[i];
+			_fnv *= 0x100000001b3ULL;
+		}
+		size_t i = 0;
+		for (; i + 8 <= size; i += 8) {
+			uint64_t w = 0;
+			for (size_t b = 0; b < 8; b++)
+				w |= uint64_t(d[i + b]) << (8 * b);
+			_mix_word(w);
+		}
+		uint64_t tail = 0;
+		for (size_t b = 0; i + b < size; b++)
+			tail |= uint64_t(d[i + b]) << (8 * b);
+		_mix_word(tail);
+	}
+	void _mix_word(uint64_t w) {
+		_mix = (_mix ^ w) * 0x9E3779B97F4A7C15ULL;
+		_mix ^= _mix >> 32;
+	}
+
+public:
+	ParseCacheHasher() :
+			_fnv(0xcbf29ce484222325ULL), _mix(0) {
+	}
+	void update(uint64_t v) {
+		unsigned char d[8];
+		for (size_t b = 0; b < 8; b++)
+			d[b] = (v >> (8 * b)) & 0xff;
+		_update_bytes(d, sizeof(d));
+	}
+	void update(string_view s) {
+		update(uint64_t(s.size()));
+		_update_bytes(reinterpret_cast<const unsigned char*>(s.data()),
+				s.size());
+	}
+	string hex() const {
+		char buff[33];
+		snprintf(buff, sizeof(buff), "%016llx%016llx",
+				(unsigned long long) _fnv, (unsigned long long) _mix);
+		return buff;
+	}
+};
+
+ParseCache::ParseCache() :
+		_hit_cnt(0), _miss_cnt(0) {
+}
+
+string ParseCache::key(string_view input, const SourceMap *source_map,
+		Language lang, bool hierarchyOnly) const {
+	ParseCacheHasher h;
+	h.update(PARSE_CACHE_KEY_SALT);
+	h.update(HdlAstBinary::VERSION);
+#ifdef HDLCONVERTOR_COMPACT_POSITION
+	h.update(1);
+#else
+	h.update(0);
+#endif
+	h.update(uint64_t(lang));
+	h.update(hierarchyOnly);
+	h.update(input);
+	h.update(source_map != nullptr);
+	if (source_map) {
+		h.update(source_map->files.size());
+		for (auto &f : source_map->files) {
+			h.update(f != nullptr);
+			if (f)
+				h.update(*f);
+		}
+		h.update(source_map->ranges.size());
+		for (auto &r : source_map->ranges) {
+			h.update(r.out_line);
+			h.update(r.file_id);
+			h.update(r.src_line);
+			h.update(r.is_expansion);
+		}
+	}
+	return h.hex();
+}
+
+static filesystem::path entry_path(const string &dir, const string &key) {
+	return filesystem::u8path(dir) / (key + ".hdlb");
+}
+
+bool ParseCache::load(const string &key, HdlContext &ctx) {
+	auto p = entry_path(dir, key);
+	error_code ec;
+	if (filesystem::exists(p, ec)) {
+		try {
+			HdlAstBinaryFile f(p);
+			HdlAstBinaryLoader(f, ctx).load();
+			_hit_cnt++;
+			return true;
+		} catch (const runtime_error &e) {
+			// corrupted or unreadable entry, it is replaced once the input is parsed
+		}
+	}
+	_miss_cnt++;
+	return false;
+}
+
+void ParseCache::store(const string &key, const HdlContext &ctx,
+		size_t first_obj) {
+	// the name of the temporary file has to be unique between the threads and the processes
+	static const uint64_t tmp_id = (uint64_t(random_device()()) << 32)
+			| random_device()();
+	static atomic<uint64_t> tmp_cnt(0);
+	auto d = filesystem::u8path(dir);
+	auto p = entry_path(dir, key);
+	char tmp_suffix[64];
+	snprintf(tmp_suffix, sizeof(tmp_suffix), ".%016llx.%llu.tmp",
+			(unsigned long long) tmp_id, (unsigned long long) tmp_cnt++);
+	auto tmp = d / (key + tmp_suffix);
+
+	error_code ec;
+	filesystem::create_directories(d, ec);
+	try {
+		HdlAstBinaryWriter w;
+		w.write(ctx, tmp, first_obj);
+	} catch (const exception &e) {
+		filesystem::remove(tmp, ec);
+		return;
+	}
+	filesystem::rename(tmp, p, ec);
+	if (ec)
+		filesystem::remove(tmp, ec);
+}
+
+size_t ParseCache::get_hit_cnt() const {
+	return _hit_cnt;
+}
+
+size_t ParseCache::get_miss_cnt() const {
+	return _miss_cnt;
+}
+
+void ParseCache::reset_stats() {
+	_hit_cnt = 0;
+	_miss_cnt = 0;
+}
+
+}
@@ -0,0 +1,86 @@
+#include <hdlConvertor/sourceLines.h>
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+using namespace std;
+
+namespace hdlConvertor {
+
+thread_local const SourceLines *SourceLines::current = nullptr;
+
+SourceLines::SourceLines() :
+		line_starts( { 0 }) {
+}
+
+void SourceLines::build(string_view utf8_data, bool is_ascii) {
+	constexpr size_t MAX_INDEX = numeric_limits<uint32_t>::max();
+	line_starts.clear();
+	line_starts.push_back(0);
+	const char *begin = utf8_data.data();
+	const char *end = begin + utf8_data.size();
+	if (is_ascii) {
+		// byte offset == character index
+		const char *p = begin;
+		while (p < end) {
+			auto nl = static_cast<const char*>(memchr(p, '\n', end - p));
+			if (nl == nullptr)
+				break;
+			size_t i = nl - begin + 1;
+			if (i >= MAX_INDEX)
+				break;
+			line_starts.push_back(i);
+			p = nl + 1;
+		}
+	} else {
+		// count the characters (the bytes which are not UTF-8 continuation bytes)
+		size_t i = 0;
+		for (const char *p = begin; p < end; p++) {
+			unsigned char c = *p;
+			if ((c & 0xC0) == 0x80)
+				continue;
+			i++;
+			if (c == '\n') {
+				if (i >= MAX_INDEX)
+					break;
+				line_starts.push_back(i);
+			}
+		}
+	}
+}
+
+size_t SourceLines::get_line(size_t index) const {
+	auto l = upper_bound(line_starts.begin(), line_starts.end(), index);
+	return l - line_starts.begin();
+}
+
+size_t SourceLines::get_column(size_t index) const {
+	return index - line_starts[get_line(index) - 1] + 1;
+}
+
+size_t SourceLines::get_src_line(size_t index) const {
+	size_t line = get_line(index);
+	auto r = source_map.find(line);
+	if (r)
+		return SourceMap::translate(*r, line);
+	return line;
+}
+
+shared_ptr<const string> SourceLines::get_file(size_t index) const {
+	auto r = source_map.find(get_line(index));
+	if (r)
+		return source_map.files[r->file_id];
+	return nullptr;
+}
+
+SourceLinesScope::SourceLinesScope(const SourceLines *source_lines) :
+		prev(SourceLines::current) {
+	SourceLines::current = source_lines;
+}
+
+SourceLinesScope::~SourceLinesScope() {
+	SourceLines::current = prev;
+}
+
+}
@@ -0,0 +1,176 @@
+#include <hdlConvertor/sourceMap.h>
+
+#include <algorithm>
+#include <assert.h>
+
+namespace hdlConvertor {
+
+using namespace std;
+
+thread_local const SourceMap *SourceMap::current = nullptr;
+
+size_t SourceMap::get_file_id(const string &file_name) {
+	for (size_t i = 0; i < files.size(); i++) {
+		if (*files[i] == file_name)
+			return i;
+	}
+	files.push_back(make_shared<const string>(file_name));
+	return files.size() - 1;
+}
+
+void SourceMap::add_range(size_t out_line, size_t file_id, size_t src_line,
+		bool is_expansion) {
+	if (!ranges.empty() && ranges.back().out_line == out_line) {
+		// the previous range would be empty
+		ranges.pop_back();
+	}
+	if (!ranges.empty()) {
+		auto &last = ranges.back();
+		assert(last.out_line < out_line);
+		if (last.file_id == file_id && last.is_expansion == is_expansion
+				&& translate(last, out_line) == src_line)
+			return;
+	}
+	ranges.push_back( { out_line, file_id, src_line, is_expansion });
+}
+
+const SourceMap::Range* SourceMap::find(size_t out_line) const {
+	auto r = upper_bound(ranges.begin(), ranges.end(), out_line,
+			[](size_t l, const Range &r) {
+				return l < r.out_line;
+			});
+	if (r == ranges.begin())
+		return nullptr;
+	return &*(r - 1);
+}
+
+size_t SourceMap::translate(const Range &r, size_t out_line) {
+	if (r.is_expansion)
+		return r.src_line;
+	return r.src_line + (out_line - r.out_line);
+}
+
+void SourceMap::clear() {
+	files.clear();
+	ranges.clear();
+}
+
+SourceMapScope::SourceMapScope(const SourceMap *source_map) :
+		prev(SourceMap::current) {
+	SourceMap::current = source_map;
+}
+
+SourceMapScope::~SourceMapScope() {
+	SourceMap::current = prev;
+}
+
+OstreamPreprocOutputSink::OstreamPreprocOutputSink(ostream &_os) :
+		os(_os) {
+}
+
+void OstreamPreprocOutputSink::write(string_view data) {
+	os << data;
+}
+
+CallbackPreprocOutputSink::CallbackPreprocOutputSink(
+		function<void(string_view)> _callback) :
+		callback(_callback) {
+}
+
+void CallbackPreprocOutputSink::write(string_view data) {
+	callback(data);
+}
+
+PreprocOutput::PreprocOutput(PreprocOutputSink *_sink) :
+		sink(_sink), line(1), at_line_start(true) {
+}
+
+void PreprocOutput::_write(string_view str) {
+	if (sink)
+		sink->write(str);
+	else
+		text += str;
+}
+
+size_t PreprocOutput::_translate_file_id(Recorder &r, size_t file_id) {
+	if (r.file_ids.size() <= file_id)
+		r.file_ids.resize(file_id + 1, string::npos);
+	auto &id = r.file_ids[file_id];
+	if (id == string::npos)
+		id = r.out->source_map.get_file_id(*source_map.files[file_id]);
+	return id;
+}
+
+void PreprocOutput::append(string_view str, size_t file_id,
+		size_t src_line, bool is_expansion) {
+	if (str.empty())
+		return;
+	for (auto &r : _recorders)
+		r.out->append(str, _translate_file_id(r, file_id), src_line,
+				is_expansion);
+	if (at_line_start)
+		source_map.add_range(line, file_id, src_line, is_expansion);
+	auto first_nl = str.find('\n');
+	if (first_nl != string_view::npos) {
+		// the lines behind the first new line start in this str
+		source_map.add_range(line + 1, file_id,
+				is_expansion ? src_line : src_line + 1, is_expansion);
+		line += count(str.begin() + first_nl, str.end(), '\n');
+	}
+	_write(str);
+	at_line_start = str.back() == '\n';
+}
+
+void PreprocOutput::append(const PreprocOutput &other) {
+	if (other.text.empty())
+		return;
+	for (auto &r : _recorders)
+		r.out->append(other);
+	vector<size_t> file_ids;
+	file_ids.reserve(other.source_map.files.size());
+	for (auto &f : other.source_map.files)
+		file_ids.push_back(source_map.get_file_id(*f));
+
+	size_t first_line = line;
+	size_t last_line = line + other.line - 1;
+	for (auto &r : other.source_map.ranges) {
+		size_t out_line = first_line + r.out_line - 1;
+		size_t src_line = r.src_line;
+		if (out_line == first_line && !at_line_start) {
+			// the first line belongs to the text before
+			out_line++;
+			if (!r.is_expansion)
+				src_line++;
+		}
+		if (out_line > last_line)
+			continue;
+		source_map.add_range(out_line, file_ids[r.file_id], src_line,
+				r.is_expansion);
+	}
+	_write(other.text);
+	line = last_line;
+	at_line_start = other.at_line_start;
+}
+
+void PreprocOutput::add_recorder(PreprocOutput *recorder) {
+	_recorders.push_back( { recorder, { } });
+}
+
+void PreprocOutput::remove_recorder(PreprocOutput *recorder) {
+	for (auto r = _recorders.begin(); r != _recorders.end(); ++r) {
+		if (r->out == recorder) {
+			_recorders.erase(r);
+			return;
+		}
+	}
+}
+
+void PreprocOutput::clear() {
+	text.clear();
+	_recorders.clear();
+	source_map.clear();
+	line = 1;
+	at_line_start = true;
+}
+
+}
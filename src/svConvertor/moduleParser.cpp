@@ -17,6 +17,7 @@
 #include <hdlConvertor/svConvertor/typeParser.h>
 #include <hdlConvertor/svConvertor/declrParser.h>
 #include <hdlConvertor/svConvertor/programParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 namespace sv {
@@ -116,7 +117,7 @@ void VerModuleParser::visitModule_declaration(
 		pp.convert_non_ansi_ports_to_ansi(ctx, m_ctx.ent.ports, m_ctx.arch->objs);
 	}
 	auto consume_nonansi_ports_vars = [this, &m_ctx](unique_ptr<iHdlObj> &o) {
-		auto v = dynamic_cast<HdlVariableDef*>(o.get());
+		auto v = hdl_obj_cast<HdlVariableDef>(o.get());
 		if (!v)
 			return false;
 
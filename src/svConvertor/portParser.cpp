@@ -12,6 +12,7 @@
 #include <hdlConvertor/svConvertor/utils.h>
 #include <hdlConvertor/svConvertor/moduleParser.h>
 #include <hdlConvertor/hdlObjects/hdlCall.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 namespace sv {
@@ -30,14 +31,22 @@ std::pair<std::string, std::unique_ptr<iHdlExpr>> split_type_base_name_and_array
 		std::unique_ptr<iHdlExpr> e, const char * typename_to_use) {
 	auto top = e.get();
 	while (true) {
-		auto c = dynamic_cast<HdlCall*>(top->data);
+		auto c = hdl_expr_item_cast<HdlCall>(top->data);
 		if (c) {
 			top = c->operands.at(0).get();
 		} else {
-			auto literal = dynamic_cast<HdlValue*>(top->data);
-			if (!literal)
+			auto literal = hdl_expr_item_cast<HdlValue>(top->data);
+			if (!literal || (literal->type != HdlValueType::symb_ID
+					&& literal->type != HdlValueType::symb_STRING))
 				throw std::runtime_error(
 						"Expr::extractStr called on expression which is not string or id");
+			if (literal->type == HdlValueType::symb_STRING) {
+				if (top == e.get())
+					return {*literal->_string, nullptr};
+				auto tmp = move(*literal->_string);
+				*literal->_string = typename_to_use;
+				return {tmp, move(e)};
+			}
 			if (top == e.get()) {
 				return {literal->_str, nullptr};
 			} else {
@@ -18,6 +18,7 @@
 #include <hdlConvertor/svConvertor/declrParser.h>
 #include <hdlConvertor/svConvertor/paramDefParser.h>
 #include <hdlConvertor/svConvertor/literalParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 using namespace std;
 using sv2017Parser = sv2017_antlr::sv2017Parser;
@@ -28,7 +29,7 @@ namespace sv {
 
 void HdlStmIf_collapse_elifs(HdlStmIf &ifStm) {
 	if (ifStm.ifFalse) {
-		auto as_if = dynamic_cast<HdlStmIf*>(ifStm.ifFalse.get());
+		auto as_if = hdl_obj_cast<HdlStmIf>(ifStm.ifFalse.get());
 		if (as_if) {
 			assert(ifStm.in_preproc == as_if->in_preproc);
 			auto tmp = move(ifStm.ifFalse);
@@ -678,11 +679,11 @@ unique_ptr<HdlStmProcess> VerStatementParser::visitProcedural_timing_control_sta
 	} else if (sens_list.first) {
 		auto wait = create_object<HdlStmWait>(ctx, move(sens_list.first));
 		// if not in the block, wrap it in the block stm
-		auto stms_block = dynamic_cast<HdlStmBlock*>(stms.get());
+		auto stms_block = hdl_obj_cast<HdlStmBlock>(stms.get());
 		if (!stms_block) {
 			auto b = create_object<HdlStmBlock>(ctx, move(stms));
 			stms = move(b);
-			stms_block = dynamic_cast<HdlStmBlock*>(stms.get());
+			stms_block = hdl_obj_cast<HdlStmBlock>(stms.get());
 		}
 		// push_front
 		stms_block->statements.push_back(move(wait));
@@ -1,5 +1,7 @@
 #include <hdlConvertor/toString.h>
 #include <limits>
+#include <assert.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 
@@ -28,12 +30,12 @@ void ToString::dump(const HdlModuleDec * e, int indent) {
 	mkIndent(indent - INDENT_INCR) << "}";
 }
 void ToString::dump(const iHdlExpr * e, int indent) {
-	HdlCall * op = dynamic_cast<HdlCall*>(e->data);
 	std::cout << "{\n";
+	auto op = hdl_expr_item_cast<HdlCall>(e->data);
 	if (op) {
 		dumpItemP("binOperator", indent + INDENT_INCR, op) << "\n";
 	} else {
-		auto literal = dynamic_cast<HdlValue*>(e->data);
+		auto literal = hdl_expr_item_cast<HdlValue>(e->data);
 		if (literal) {
 			dumpItemP("literal", indent + INDENT_INCR, literal) << "\n";
 		} else
@@ -42,23 +44,22 @@ void ToString::dump(const iHdlExpr * e, int indent) {
 	mkIndent(indent) << "}";
 }
 void ToString::dump(const hdlObjects::iHdlObj * o, int indent) {
-	auto c = dynamic_cast<const HdlContext*>(o);
-	if (c)
-		dump(c, indent);
-	auto md = dynamic_cast<const HdlModuleDec*>(o);
-	if (md)
-		dump(md, indent);
-	auto ex = dynamic_cast<const iHdlExpr*>(o);
-	if (ex)
-		dump(ex, indent);
-	auto v = dynamic_cast<const HdlVariableDef*>(o);
-	if (v)
-		dump(v, indent);
-	auto s = dynamic_cast<const iHdlStatement*>(o);
-	if (s)
-		dump(s, indent);
-
-	assert(false);
+	switch (o->obj_kind) {
+	case OBJ_MODULE_DEC:
+		dump(static_cast<const HdlModuleDec*>(o), indent);
+		break;
+	case OBJ_EXPR:
+		dump(static_cast<const iHdlExpr*>(o), indent);
+		break;
+	case OBJ_VARIABLE_DEF:
+		dump(static_cast<const HdlVariableDef*>(o), indent);
+		break;
+	default:
+		if (is_statement(o->obj_kind))
+			dump(static_cast<const iHdlStatement*>(o), indent);
+		else
+			assert(false);
+	}
 }
 void ToString::dump(const hdlObjects::iHdlStatement * o, int indent) {
 	std::cout
@@ -87,13 +88,15 @@ void ToString::dump(const HdlValue * s, int indent) {
 	std::cout << "{\n";
 	indent += INDENT_INCR;
 	dumpVal("type", indent, HdlValueType_toString(s->type)) << ",\n";
-	const char * _v;
+	std::string _v;
 
 	switch (s->type) {
 	case HdlValueType::symb_ID:
-	case HdlValueType::symb_STRING:
 		dumpVal("value", indent, s->_str) << "\n";
 		break;
+	case HdlValueType::symb_STRING:
+		dumpVal("value", indent, *s->_string) << "\n";
+		break;
 	case HdlValueType::symb_FLOAT:
 		dumpVal("value", indent, s->_float) << "\n";
 		break;
@@ -105,10 +108,10 @@ void ToString::dump(const HdlValue * s, int indent) {
 			dumpVal("bits", indent, s->bits) << ",\n";
 		auto & i = s->_int;
 		if (i.is_bitstring()) {
-			dumpVal("base", indent, i.bitstring_base) << ",\n";
-			_v = i.bitstring.c_str();
+			dumpVal("base", indent, i.get_bitstring_base()) << ",\n";
+			_v = std::string(i.get_bitstring());
 		} else {
-			_v = std::to_string(i.val).c_str();
+			_v = std::to_string(i.get_val());
 		}
 		dumpVal("value", indent, _v) << "\n";
 		break;
@@ -168,10 +171,10 @@ void ToString::dump(const Position * o, int indent) {
 		std::cout << ",\n";
 	};
 
-	dump_size_t("startLine", o->startLine);
-	dump_size_t("stopLine", o->stopLine);
-	dump_size_t("startColumn", o->startColumn);
-	dump_size_t("stopColumn", o->stopColumn);
+	dump_size_t("startLine", o->get_start_line());
+	dump_size_t("stopLine", o->get_stop_line());
+	dump_size_t("startColumn", o->get_start_column());
+	dump_size_t("stopColumn", o->get_stop_column());
 	indent -= INDENT_INCR;
 	mkIndent(indent) << "}";
 }
@@ -0,0 +1,301 @@
+#include <hdlConvertor/utf8CharStream.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32) || defined(_WIN64)
+#define HDLCONVERTOR_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <hdlConvertor/conversion_exception.h>
+
+namespace hdlConvertor {
+
+using namespace std;
+using namespace antlr4;
+
+static bool is_ascii_only(const char *data, size_t size) {
+	const uint64_t HIGH_BITS = 0x8080808080808080ULL;
+	size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+		uint64_t w;
+		memcpy(&w, data + i, sizeof(w));
+		if (w & HIGH_BITS)
+			return false;
+	}
+	for (; i < size; i++) {
+		if (data[i] & 0x80)
+			return false;
+	}
+	return true;
+}
+
+/*
+ * Decode UTF-8 to UTF-32, invalid sequences are replaced by U+FFFD
+ * (same as antlr4::Utf8::lenientDecode used by ANTLRInputStream: the overlong encodings,
+ * surrogates and code points above U+10FFFF are invalid, each byte of an invalid sequence
+ * which is not a start of a valid sequence is replaced by U+FFFD)
+ * */
+static void utf8_to_utf32(const char *data, size_t size, u32string &res) {
+	const char32_t REPLACEMENT_CHAR = 0xFFFD;
+	auto d = reinterpret_cast<const unsigned char*>(data);
+	res.clear();
+	res.reserve(size);
+	size_t i = 0;
+	while (i < size) {
+		unsigned char c = d[i];
+		char32_t ch;
+		// the smallest code point which requires this length of the sequence
+		char32_t min_ch;
+		size_t len;
+		if (c < 0x80) {
+			res.push_back(c);
+			i++;
+			continue;
+		} else if ((c & 0xE0) == 0xC0) {
+			ch = c & 0x1F;
+			min_ch = 0x80;
+			len = 2;
+		} else if ((c & 0xF0) == 0xE0) {
+			ch = c & 0x0F;
+			min_ch = 0x800;
+			len = 3;
+		} else if ((c & 0xF8) == 0xF0) {
+			ch = c & 0x07;
+			min_ch = 0x10000;
+			len = 4;
+		} else {
+			res.push_back(REPLACEMENT_CHAR);
+			i++;
+			continue;
+		}
+		bool valid = i + len <= size;
+		for (size_t j = 1; valid && j < len; j++) {
+			unsigned char cc = d[i + j];
+			if ((cc & 0xC0) != 0x80) {
+				valid = false;
+				break;
+			}
+			ch = (ch << 6) | (cc & 0x3F);
+		}
+		if (valid && ch >= min_ch && ch <= 0x10FFFF
+				&& (ch < 0xD800 || ch > 0xDFFF)) {
+			res.push_back(ch);
+			i += len;
+		} else {
+			res.push_back(REPLACEMENT_CHAR);
+			i++;
+		}
+	}
+}
+
+static void utf32_to_utf8(const char32_t *data, size_t size, string &res) {
+	res.reserve(res.size() + size);
+	for (size_t i = 0; i < size; i++) {
+		char32_t c = data[i];
+		if (c < 0x80) {
+			res.push_back(static_cast<char>(c));
+		} else if (c < 0x800) {
+			res.push_back(static_cast<char>(0xC0 | (c >> 6)));
+			res.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+		} else if (c < 0x10000) {
+			res.push_back(static_cast<char>(0xE0 | (c >> 12)));
+			res.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+			res.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+		} else {
+			res.push_back(static_cast<char>(0xF0 | (c >> 18)));
+			res.push_back(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+			res.push_back(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+			res.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+		}
+	}
+}
+
+Utf8CharStream::Utf8CharStream() :
+		_data(nullptr), _data_size(0), _utf8_size(0), _is_ascii(true), p(
+				0) {
+}
+
+Utf8CharStream::Utf8CharStream(const char *data, size_t size) :
+		Utf8CharStream() {
+	set_data(data, size);
+}
+
+Utf8CharStream::Utf8CharStream(string &&str) :
+		Utf8CharStream() {
+	_owned_str = move(str);
+	set_data(_owned_str.data(), _owned_str.size());
+}
+
+void Utf8CharStream::set_data(const char *data, size_t size) {
+	// skip the UTF-8 BOM (same as ANTLRInputStream)
+	if (size >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0) {
+		data += 3;
+		size -= 3;
+	}
+	_data = data;
+	_data_size = size;
+	_utf8_size = size;
+	_is_ascii = is_ascii_only(data, size);
+	if (!_is_ascii) {
+		utf8_to_utf32(data, size, _data_utf32);
+		_data_size = _data_utf32.size();
+	}
+	p = 0;
+}
+
+bool Utf8CharStream::is_ascii() const {
+	return _is_ascii;
+}
+
+string_view Utf8CharStream::get_utf8_data() const {
+	return string_view(_data, _utf8_size);
+}
+
+void Utf8CharStream::reset() {
+	p = 0;
+}
+
+void Utf8CharStream::consume() {
+	if (p >= _data_size) {
+		throw IllegalStateException("cannot consume EOF");
+	}
+	p++;
+}
+
+size_t Utf8CharStream::LA(ssize_t i) {
+	if (i == 0) {
+		return 0; // undefined
+	}
+	ssize_t position = static_cast<ssize_t>(p);
+	if (i < 0) {
+		i++; // e.g., translate LA(-1) to use offset i=0; then data[p+0-1]
+		if ((position + i - 1) < 0) {
+			return IntStream::EOF; // invalid; no char before first char
+		}
+	}
+	if ((position + i - 1) >= static_cast<ssize_t>(_data_size)) {
+		return IntStream::EOF;
+	}
+	size_t pos = static_cast<size_t>(position + i - 1);
+	if (_is_ascii)
+		return static_cast<unsigned char>(_data[pos]);
+	else
+		return _data_utf32[pos];
+}
+
+ssize_t Utf8CharStream::mark() {
+	return -1;
+}
+
+void Utf8CharStream::release(ssize_t) {
+}
+
+size_t Utf8CharStream::index() {
+	return p;
+}
+
+void Utf8CharStream::seek(size_t index) {
+	// the whole input is in memory, there is no need to consume char by char
+	p = min(index, _data_size);
+}
+
+size_t Utf8CharStream::size() {
+	return _data_size;
+}
+
+string Utf8CharStream::getSourceName() const {
+	if (name.empty()) {
+		return IntStream::UNKNOWN_SOURCE_NAME;
+	}
+	return name;
+}
+
+string Utf8CharStream::getText(const misc::Interval &interval) {
+	if (interval.a < 0 || interval.b < 0) {
+		return "";
+	}
+	size_t start = interval.a;
+	size_t stop = interval.b;
+	if (start >= _data_size) {
+		return "";
+	}
+	if (stop >= _data_size) {
+		stop = _data_size - 1;
+	}
+	if (stop < start)
+		return "";
+	size_t count = stop - start + 1;
+	if (_is_ascii)
+		return string(_data + start, count);
+
+	string res;
+	utf32_to_utf8(_data_utf32.data() + start, count, res);
+	return res;
+}
+
+string Utf8CharStream::toString() const {
+	if (_is_ascii)
+		return string(_data, _data_size);
+	string res;
+	utf32_to_utf8(_data_utf32.data(), _data_utf32.size(), res);
+	return res;
+}
+
+Utf8CharStream::~Utf8CharStream() {
+}
+
+MmapFileCharStream::MmapFileCharStream(const filesystem::path &file_name) :
+		Utf8CharStream(), _mapping(nullptr), _mapping_size(0) {
+	name = file_name.u8string();
+#ifdef HDLCONVERTOR_NO_MMAP
+	ifstream f(file_name, ios::binary);
+	if (!f) {
+		throw ParseException(name + " can not be opened");
+	}
+	stringstream buff;
+	buff << f.rdbuf();
+	_owned_str = buff.str();
+	set_data(_owned_str.data(), _owned_str.size());
+#else
+	int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw ParseException(name + " can not be opened");
+	}
+	struct stat st;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		throw ParseException(name + " can not be opened");
+	}
+	size_t size = static_cast<size_t>(st.st_size);
+	if (size) {
+		void *m = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (m == MAP_FAILED) {
+			close(fd);
+			throw ParseException(name + " can not be memory mapped");
+		}
+		// the input is read sequentially by the lexer
+		madvise(m, size, MADV_SEQUENTIAL);
+		_mapping = m;
+		_mapping_size = size;
+	}
+	// the mapping remains valid after the file is closed
+	close(fd);
+	set_data(static_cast<const char*>(_mapping), _mapping_size);
+#endif
+}
+
+MmapFileCharStream::~MmapFileCharStream() {
+#ifndef HDLCONVERTOR_NO_MMAP
+	if (_mapping)
+		munmap(_mapping, _mapping_size);
+#endif
+}
+
+}
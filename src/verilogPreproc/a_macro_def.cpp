@@ -8,6 +8,11 @@ aMacroDef::aMacroDef(const std::string &_name) :
 				-1) {
 }
 
+bool aMacroDef::equals(const aMacroDef &other) const {
+	return typeid(*this) == typeid(other) && is_persistent == other.is_persistent
+			&& name == other.name;
+}
+
 void aMacroDef::throw_doest_not_support_args() {
 	std::string msg = "Macro " + name
 			+ " does not expect any arguments or braces.";
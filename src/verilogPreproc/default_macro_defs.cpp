@@ -20,6 +20,9 @@ std::string MacroDef__LINE__::replace(std::vector<std::string> unused(args),
 	string replacement = to_string(ctx->getStart()->getLine());
 	return replacement;
 }
+aMacroDef* MacroDef__LINE__::clone() const {
+	return new MacroDef__LINE__(*this);
+}
 bool MacroDef__LINE__::requires_args() {
 	return false;
 }
@@ -47,6 +50,9 @@ std::string MacroDef__FILE__::replace(std::vector<std::string> unused(args),
 #endif
 	return replacement;
 }
+aMacroDef* MacroDef__FILE__::clone() const {
+	return new MacroDef__FILE__(*this);
+}
 bool MacroDef__FILE__::requires_args() {
 	return false;
 }
@@ -0,0 +1,662 @@
+#include <hdlConvertor/verilogPreproc/ifdefScanner.h>
+
+#include <cstring>
+#include <string_view>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace hdlConvertor {
+namespace verilog_pp {
+
+using namespace std;
+
+/*
+ * The block which `endif was not found yet
+ *
+ * :ivar has_else: true if the `else was already found
+ * :ivar group_start: the offset of the start of actual group of lines
+ * :ivar visible_start: the offset of the first non comment character in actual group (npos if none)
+ * :ivar visible_end: the offset behind the last non comment character in actual group
+ * :ivar nested: the blocks in actual group
+ * */
+class IfdefScanner::OpenBlock {
+public:
+	IfdefBlock block;
+	std::string cond_id;
+	bool has_else;
+	size_t group_start;
+	size_t visible_start;
+	size_t visible_end;
+	std::vector<IfdefBlock> nested;
+
+	void start_group(const string &_cond_id, size_t start) {
+		cond_id = _cond_id;
+		group_start = start;
+		visible_start = string::npos;
+		visible_end = start;
+		nested.clear();
+	}
+	void end_group() {
+		IfdefBranch b;
+		b.cond_id = move(cond_id);
+		if (visible_start == string::npos) {
+			b.text_start = b.text_end = group_start;
+		} else {
+			b.text_start = visible_start;
+			b.text_end = visible_end;
+		}
+		b.nested = move(nested);
+		block.branches.push_back(move(b));
+	}
+};
+
+static inline bool is_id_first(char c) {
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static inline bool is_id_char(char c) {
+	return is_id_first(c) || (c >= '0' && c <= '9');
+}
+
+static inline bool is_ws(char c) {
+	return c == ' ' || c == '\t';
+}
+
+// the directives which are recognized by the lexer (and not handled as a macro call)
+static const char *const DIRECTIVE_KEYWORDS[] = { "include", "define",
+		"ifndef", "ifdef", "elsif", "else", "endif", "undef", "begin_keywords",
+		"end_keywords", "pragma", "undefineall", "resetall", "celldefine",
+		"endcelldefine", "timescale", "default_nettype", "line",
+		"unconnected_drive", "nounconnected_drive", "protected", };
+
+static bool is_directive_keyword(const string &name) {
+	for (auto k : DIRECTIVE_KEYWORDS) {
+		if (name == k)
+			return true;
+	}
+	return false;
+}
+
+#if defined(__AVX2__) || defined(__SSE2__)
+static inline int code_special_char_mask(__m128i v) {
+	__m128i m = _mm_or_si128(
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('/')),
+					_mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+			_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\\')),
+					_mm_cmpeq_epi8(v, _mm_set1_epi8('`'))));
+	return _mm_movemask_epi8(m);
+}
+#endif
+
+/*
+ * :return: pointer on the first character which ends the plain CODE ('/', '"', '\\', '`')
+ * 		or end if there is no such character
+ * */
+static const char* find_code_end(const char *s, const char *end) {
+#if defined(__AVX2__)
+	const __m256i slash = _mm256_set1_epi8('/');
+	const __m256i quote = _mm256_set1_epi8('"');
+	const __m256i backslash = _mm256_set1_epi8('\\');
+	const __m256i backtick = _mm256_set1_epi8('`');
+	while (end - s >= 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*) s);
+		__m256i m = _mm256_or_si256(
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, slash),
+						_mm256_cmpeq_epi8(v, quote)),
+				_mm256_or_si256(_mm256_cmpeq_epi8(v, backslash),
+						_mm256_cmpeq_epi8(v, backtick)));
+		unsigned mask = (unsigned) _mm256_movemask_epi8(m);
+		if (mask)
+			return s + __builtin_ctz(mask);
+		s += 32;
+	}
+#endif
+#if defined(__AVX2__) || defined(__SSE2__)
+	while (end - s >= 16) {
+		int mask = code_special_char_mask(
+				_mm_loadu_si128((const __m128i*) s));
+		if (mask)
+			return s + __builtin_ctz(mask);
+		s += 16;
+	}
+#endif
+	for (; s < end; s++) {
+		char c = *s;
+		if (c == '/' || c == '"' || c == '\\' || c == '`')
+			break;
+	}
+	return s;
+}
+
+IfdefScanner::IfdefScanner() :
+		data(nullptr), size(0), p(0), code_slash_end(string::npos), directive_open(
+				false), blank_outside(true) {
+}
+
+void IfdefScanner::extend_directive(size_t start, bool is_plain_code) {
+	if (!directive_open)
+		return;
+	auto &d = directives.back();
+	d.second = p;
+	auto nl = (const char*) memchr(data + start, '\n', p - start);
+	if (nl) {
+		// the directive ends on the end of line, the CODE can be split there
+		if (is_plain_code)
+			d.second = nl - data + 1;
+		directive_open = false;
+	}
+}
+
+void IfdefScanner::mark_visible(size_t start, size_t end) {
+	if (open_blocks.size()) {
+		auto &b = open_blocks.back();
+		if (b.visible_start == string::npos)
+			b.visible_start = start;
+		b.visible_end = end;
+	} else if (blank_outside) {
+		for (size_t i = start; i < end; i++) {
+			char c = data[i];
+			if (c != ' ' && c != '\t' && c != '\r' && c != '\n') {
+				blank_outside = false;
+				break;
+			}
+		}
+	}
+}
+
+// STR: '"' ( ('\\' ('"' | CRLF)) | ~["\r\n] )* '"';
+bool IfdefScanner::skip_str() {
+	size_t i = p + 1;
+	while (i < size) {
+		char c = data[i];
+		if (c == '"') {
+			p = i + 1;
+			return true;
+		} else if (c == '\\' && i + 1 < size) {
+			char n = data[i + 1];
+			if (n == '"' || n == '\n') {
+				i += 2;
+				continue;
+			} else if (n == '\r' && i + 2 < size && data[i + 2] == '\n') {
+				i += 3;
+				continue;
+			}
+		} else if (c == '\r' || c == '\n') {
+			// unterminated string (or the string which would be resolved by backtracking of the lexer)
+			return false;
+		}
+		i++;
+	}
+	return false;
+}
+
+// LINE_COMMENT : '//' ~[\r\n]* ( CRLF | EOF );
+void IfdefScanner::skip_line_comment() {
+	auto nl = (const char*) memchr(data + p, '\n', size - p);
+	if (nl)
+		p = nl - data + 1;
+	else
+		p = size;
+}
+
+// COMMENT: '/*' .*? '*/';
+bool IfdefScanner::skip_comment() {
+	const char *s = data + p + 2;
+	const char *end = data + size;
+	while (s < end) {
+		s = (const char*) memchr(s, '*', end - s);
+		if (!s || s + 1 >= end)
+			return false;
+		if (s[1] == '/') {
+			p = s + 2 - data;
+			return true;
+		}
+		s++;
+	}
+	return false;
+}
+
+// F_WS+, :return: false if there was no whitespace
+bool IfdefScanner::skip_ws() {
+	size_t start = p;
+	while (p < size && is_ws(data[p]))
+		p++;
+	return p != start;
+}
+
+// F_ID, :return: false if there is no identifier
+bool IfdefScanner::skip_id() {
+	if (p >= size || !is_id_first(data[p]))
+		return false;
+	p++;
+	while (p < size && is_id_char(data[p]))
+		p++;
+	return true;
+}
+
+// ('`' '\\' '`')+ '"', :return: false if there is no such sequence
+bool IfdefScanner::skip_escaped_quote() {
+	size_t i = p;
+	while (i + 2 < size && data[i] == '`' && data[i + 1] == '\\'
+			&& data[i + 2] == '`')
+		i += 3;
+	if (i != p && i < size && data[i] == '"') {
+		p = i + 1;
+		return true;
+	}
+	return false;
+}
+
+/*
+ * Skip the expression in the argument list of a macro call or the default value
+ * of a macro parameter (EXPR_MODE of the lexer)
+ *
+ * :param ends_with_rp: set to true if the expression ends with ')', false if it ends with ','
+ * :note: the comments are not supported because the lexer recognizes them
+ * 		only if they are at the start of the token
+ * */
+bool IfdefScanner::skip_expr(bool &ends_with_rp) {
+	size_t parenthesis = 0;
+	size_t braces = 0;
+	size_t square_braces = 0;
+	while (p < size) {
+		switch (data[p]) {
+		case '(':
+			parenthesis++;
+			break;
+		case ')':
+			if (parenthesis == 0) {
+				ends_with_rp = true;
+				return true;
+			}
+			parenthesis--;
+			break;
+		case '{':
+			braces++;
+			break;
+		case '}':
+			if (braces)
+				braces--;
+			break;
+		case '[':
+			square_braces++;
+			break;
+		case ']':
+			if (square_braces)
+				square_braces--;
+			break;
+		case ',':
+			if (parenthesis == 0 && braces == 0 && square_braces == 0) {
+				ends_with_rp = false;
+				return true;
+			}
+			break;
+		case '"':
+			if (!skip_str())
+				return false;
+			continue;
+		case '/':
+			if (p + 1 < size && (data[p + 1] == '/' || data[p + 1] == '*'))
+				return false;
+			break;
+		}
+		p++;
+	}
+	return false;
+}
+
+// the part of `define behind the 'define' keyword (DEFINE_MODE, DEFINE_BODY_MODE)
+bool IfdefScanner::skip_define() {
+	if (!skip_ws())
+		return false;
+	// line escapes and comments before the macro name are not supported
+	if (!skip_id())
+		return false;
+	if (p == size)
+		return true;
+
+	char c = data[p];
+	if (c == '(') {
+		p++;
+		if (!skip_define_params())
+			return false;
+	} else if (is_ws(c)) {
+		skip_ws();
+	} else if (c == '\n') {
+		p++;
+		return true;
+	} else if (c == '\r' && p + 1 < size && data[p + 1] == '\n') {
+		p += 2;
+		return true;
+	} else if (c == '/' && p + 1 < size && data[p + 1] == '/') {
+		skip_line_comment();
+		return true;
+	} else {
+		return false;
+	}
+	return skip_define_body();
+}
+
+// the parameters of the macro behind the '('
+bool IfdefScanner::skip_define_params() {
+	while (p < size) {
+		char c = data[p];
+		if (is_ws(c) || c == '\n' || c == '\r' || c == ',') {
+			p++;
+		} else if (c == '\\' && p + 1 < size
+				&& (data[p + 1] == '\n' || data[p + 1] == '\r')) {
+			p += 2;
+		} else if (c == '/' && p + 1 < size && data[p + 1] == '/') {
+			skip_line_comment();
+		} else if (c == '/' && p + 1 < size && data[p + 1] == '*') {
+			if (!skip_comment())
+				return false;
+		} else if (is_id_first(c)) {
+			skip_id();
+		} else if (c == '=') {
+			p++;
+			bool ends_with_rp;
+			if (!skip_expr(ends_with_rp))
+				return false;
+			p++;
+			if (ends_with_rp)
+				return true;
+		} else if (c == ')') {
+			p++;
+			return true;
+		} else {
+			return false;
+		}
+	}
+	return false;
+}
+
+// DEFINE_BODY_MODE, ends behind the NEW_LINE
+bool IfdefScanner::skip_define_body() {
+	// true if the lexer is at the start of the token
+	// (the line comment is recognized only there)
+	bool token_start = true;
+	while (p < size) {
+		char c = data[p];
+		if (c == '\n') {
+			p++;
+			return true;
+		} else if (c == '"') {
+			if (!skip_str())
+				return false;
+			token_start = true;
+		} else if (c == '/' && token_start && p + 1 < size
+				&& data[p + 1] == '/') {
+			// hidden comment, the define continues on the next line
+			skip_line_comment();
+			token_start = true;
+		} else if (c == '\\') {
+			// ( '\\'+ ~[\n] ) in DB_CODE has precedence before the F_LINE_ESCAPE
+			// if it results in the longer token
+			size_t i = p;
+			while (i < size && data[i] == '\\')
+				i++;
+			if (i == size)
+				return false;
+			bool single = i - p == 1;
+			if (data[i] == '\n') {
+				p = i + 1;
+				if (!single)
+					return true;
+				token_start = true;
+			} else if (data[i] == '\r' && i + 1 < size && data[i + 1] == '\n') {
+				p = i + 2;
+				if (!single || !token_start)
+					return true;
+				token_start = true;
+			} else {
+				p = i + 1;
+				token_start = false;
+			}
+		} else if (c == '`') {
+			if (p + 1 < size && data[p + 1] == '"')
+				p += 2;
+			else if (!skip_escaped_quote())
+				p++;
+			token_start = false;
+		} else {
+			p++;
+			token_start = false;
+		}
+	}
+	return true;
+}
+
+// the arguments of the macro call behind the '('
+bool IfdefScanner::skip_macro_args() {
+	for (;;) {
+		bool ends_with_rp;
+		if (!skip_expr(ends_with_rp))
+			return false;
+		p++;
+		if (ends_with_rp)
+			return true;
+	}
+}
+
+bool IfdefScanner::process_conditional(const string &name, size_t start) {
+	// the "/`" is a part of the CODE token, the token would have to be split
+	if (start == code_slash_end)
+		return false;
+
+	if (name == "ifdef" || name == "ifndef" || name == "elsif") {
+		if (!skip_ws())
+			return false;
+		size_t id_start = p;
+		// the NUM or a macro in condition is an error or the lexer handles it differently
+		if (!skip_id())
+			return false;
+		string cond_id(data + id_start, p - id_start);
+		if (name == "elsif") {
+			if (open_blocks.empty() || open_blocks.back().has_else)
+				return false;
+			auto &b = open_blocks.back();
+			b.end_group();
+			b.start_group(cond_id, p);
+		} else {
+			open_blocks.emplace_back();
+			auto &b = open_blocks.back();
+			b.block.is_negated = name == "ifndef";
+			b.block.start = start;
+			b.has_else = false;
+			b.start_group(cond_id, p);
+		}
+		return true;
+	}
+
+	if (open_blocks.empty())
+		return false;
+	// ELSE: 'else' ANY_WS; ENDIF: 'endif' (ANY_WS | EOF)
+	if (!skip_ws()) {
+		if (p < size && data[p] == '\n') {
+			p++;
+		} else if (p + 1 < size && data[p] == '\r' && data[p + 1] == '\n') {
+			p += 2;
+		} else if (p != size || name == "else") {
+			return false;
+		}
+	}
+	auto &b = open_blocks.back();
+	if (name == "else") {
+		if (b.has_else)
+			return false;
+		b.end_group();
+		b.has_else = true;
+		b.start_group("", p);
+		return true;
+	}
+
+	b.end_group();
+	b.block.end = p;
+	IfdefBlock block = move(b.block);
+	open_blocks.pop_back();
+	if (open_blocks.size()) {
+		mark_visible(block.start, block.end);
+		open_blocks.back().nested.push_back(move(block));
+	} else {
+		blocks.push_back(move(block));
+	}
+	return true;
+}
+
+// process the directive or macro call starting with '`' at actual position
+bool IfdefScanner::process_directive() {
+	size_t start = p;
+	if (start == code_slash_end && !(p + 1 < size && is_id_first(data[p + 1])))
+		return false;
+
+	// CODE: '`' '"' | '`' '`' | ('`' '\\' '`')+ '"'
+	if (p + 1 < size && (data[p + 1] == '"' || data[p + 1] == '`')) {
+		p += 2;
+		mark_visible(start, p);
+		extend_directive(start, true);
+		return true;
+	}
+	if (skip_escaped_quote()) {
+		mark_visible(start, p);
+		extend_directive(start, true);
+		return true;
+	}
+
+	p++;
+	size_t name_start = p;
+	if (!skip_id())
+		return false;
+	string name(data + name_start, p - name_start);
+	size_t name_end = p;
+	bool is_keyword = is_directive_keyword(name);
+	skip_ws();
+	bool has_args = p < size && data[p] == '(';
+	p = name_end;
+	if (is_keyword && has_args) {
+		// the lexer would use OTHER_MACRO_CALL_WITH_ARGS because it is longer
+		return false;
+	}
+
+	if (name == "ifdef" || name == "ifndef" || name == "elsif"
+			|| name == "else" || name == "endif") {
+		// the conditional directives are resolved by the caller (using the blocks)
+		directive_open = false;
+		return process_conditional(name, start);
+	} else if (name == "define") {
+		if (!skip_define())
+			return false;
+	} else if (name == "include") {
+		if (skip_ws() && p < size && data[p] == '<') {
+			// INCLUDE_MODE_STR_CHEVRONS: '<' ( ~('\\'|'>') )* '>'
+			size_t i = p + 1;
+			while (i < size && data[i] != '>' && data[i] != '\\')
+				i++;
+			if (i == size || data[i] != '>')
+				return false;
+			p = i + 1;
+		}
+		// the STR or the macro is processed as in default mode
+	} else if (name == "protected") {
+		auto e = string_view(data + p, size - p).find("`endprotected");
+		if (e == string_view::npos)
+			return false;
+		p += e + strlen("`endprotected");
+	} else if (has_args) {
+		skip_ws();
+		p++;
+		if (!skip_macro_args())
+			return false;
+	}
+	// the rest of other directives is processed as in default mode
+	mark_visible(start, p);
+	if (directive_open) {
+		directives.back().second = p;
+	} else {
+		directives.push_back( { start, p });
+		directive_open = true;
+	}
+	if (data[p - 1] == '\n')
+		directive_open = false;
+	return true;
+}
+
+bool IfdefScanner::scan(const char *_data, size_t _size) {
+	data = _data;
+	size = _size;
+	p = 0;
+	code_slash_end = string::npos;
+	directive_open = false;
+	open_blocks.clear();
+	blocks.clear();
+	directives.clear();
+	blank_outside = true;
+
+	while (p < size) {
+		size_t start = p;
+		switch (data[p]) {
+		case '/':
+			if (p + 1 == size) {
+				return false;
+			} else if (data[p + 1] == '/') {
+				skip_line_comment();
+				extend_directive(start, false);
+			} else if (data[p + 1] == '*') {
+				if (!skip_comment())
+					return false;
+				extend_directive(start, false);
+			} else if (data[p + 1] == '`') {
+				// CODE ... '/' '`' and the DIRECTIVE_MODE
+				p++;
+				code_slash_end = p;
+				mark_visible(start, p);
+				extend_directive(start, true);
+			} else {
+				// '/' ~( '/' | '*' | '`' ), the second char is always a part of CODE
+				p += 2;
+				mark_visible(start, p);
+				extend_directive(start, true);
+			}
+			break;
+		case '"':
+			if (!skip_str())
+				return false;
+			mark_visible(start, p);
+			extend_directive(start, false);
+			break;
+		case '\\':
+			// escaped identifier: '\\' (~[ \t\r\n])* ([ \t\r\n] | EOF)
+			p++;
+			while (p < size && !is_ws(data[p]) && data[p] != '\r'
+					&& data[p] != '\n')
+				p++;
+			if (p < size)
+				p++;
+			mark_visible(start, p);
+			extend_directive(start, false);
+			break;
+		case '`':
+			if (!process_directive())
+				return false;
+			break;
+		default:
+			p = find_code_end(data + p + 1, data + size) - data;
+			mark_visible(start, p);
+			extend_directive(start, true);
+			break;
+		}
+	}
+	directive_open = false;
+	if (open_blocks.size())
+		return false;
+	return true;
+}
+
+IfdefScanner::~IfdefScanner() {
+}
+
+}
+}
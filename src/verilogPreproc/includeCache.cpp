@@ -0,0 +1,111 @@
+#include <hdlConvertor/verilogPreproc/includeCache.h>
+
+namespace hdlConvertor {
+namespace verilog_pp {
+
+using namespace std;
+
+IncludeCacheEntry::IncludeCacheEntry() :
+		file_size(0), lang(Language::SV2017), nested_include_depth(0), cacheable(
+				true), _incfile_stack_size(0) {
+}
+
+void IncludeCacheEntry::add_macro_dep(const string &name,
+		const aMacroDef *cur_def) {
+	if (macro_deps.find(name) != macro_deps.end())
+		return;
+	unique_ptr<aMacroDef> d;
+	if (cur_def)
+		d.reset(cur_def->clone());
+	macro_deps.emplace(name, move(d));
+}
+
+IncludeCache::IncludeCache() :
+		_hit_cnt(0), _miss_cnt(0), _guard_skip_cnt(0), enabled(true) {
+}
+
+vector<shared_ptr<const IncludeCacheEntry>> IncludeCache::get(
+		const filesystem::path &file_name) {
+	lock_guard<mutex> lock(_lock);
+	auto e = _entries.find(file_name);
+	if (e == _entries.end())
+		return {};
+	return e->second;
+}
+
+void IncludeCache::insert(const filesystem::path &file_name,
+		unique_ptr<IncludeCacheEntry> entry) {
+	lock_guard<mutex> lock(_lock);
+	auto &variants = _entries[file_name];
+	// the entries for the older versions of the file are not usable anymore
+	for (auto it = variants.begin(); it != variants.end();) {
+		if ((*it)->mtime != entry->mtime || (*it)->file_size != entry->file_size)
+			it = variants.erase(it);
+		else
+			++it;
+	}
+	if (variants.size() >= MAX_ENTRIES_PER_FILE)
+		variants.erase(variants.begin());
+	variants.push_back(shared_ptr<const IncludeCacheEntry>(move(entry)));
+}
+
+void IncludeCache::register_lookup(bool hit) {
+	lock_guard<mutex> lock(_lock);
+	if (hit)
+		_hit_cnt++;
+	else
+		_miss_cnt++;
+}
+
+bool IncludeCache::get_include_guard(const filesystem::path &file_name,
+		IncludeGuard &res) {
+	lock_guard<mutex> lock(_lock);
+	auto g = _include_guards.find(file_name);
+	if (g == _include_guards.end())
+		return false;
+	res = g->second;
+	return true;
+}
+
+void IncludeCache::add_include_guard(const filesystem::path &file_name,
+		const IncludeGuard &guard) {
+	lock_guard<mutex> lock(_lock);
+	_include_guards[file_name] = guard;
+}
+
+void IncludeCache::register_guard_skip() {
+	lock_guard<mutex> lock(_lock);
+	_guard_skip_cnt++;
+}
+
+void IncludeCache::clear_include_guards() {
+	lock_guard<mutex> lock(_lock);
+	_include_guards.clear();
+}
+
+size_t IncludeCache::get_hit_cnt() {
+	lock_guard<mutex> lock(_lock);
+	return _hit_cnt;
+}
+
+size_t IncludeCache::get_miss_cnt() {
+	lock_guard<mutex> lock(_lock);
+	return _miss_cnt;
+}
+
+size_t IncludeCache::get_guard_skip_cnt() {
+	lock_guard<mutex> lock(_lock);
+	return _guard_skip_cnt;
+}
+
+void IncludeCache::clear() {
+	lock_guard<mutex> lock(_lock);
+	_entries.clear();
+	_include_guards.clear();
+	_hit_cnt = 0;
+	_miss_cnt = 0;
+	_guard_skip_cnt = 0;
+}
+
+}
+}
@@ -0,0 +1,208 @@
+#include <hdlConvertor/verilogPreproc/macroDB.h>
+#include <stdexcept>
+
+namespace hdlConvertor {
+namespace verilog_pp {
+
+using namespace std;
+
+MacroDB::MacroDB() :
+		_persistent_version(0) {
+}
+
+MacroDB::iterator MacroDB::begin() {
+	return _items.begin();
+}
+
+MacroDB::iterator MacroDB::end() {
+	return _items.end();
+}
+
+MacroDB::const_iterator MacroDB::begin() const {
+	return _items.begin();
+}
+
+MacroDB::const_iterator MacroDB::end() const {
+	return _items.end();
+}
+
+size_t MacroDB::size() const {
+	return _items.size();
+}
+
+bool MacroDB::empty() const {
+	return _items.empty();
+}
+
+void MacroDB::_track_non_persistent(const string &name) {
+	if (_non_persistent_name_set.find(name) != _non_persistent_name_set.end())
+		return;
+	_non_persistent_names.push_back(name);
+	_non_persistent_name_set.insert(_non_persistent_names.back());
+}
+
+MacroDB::iterator MacroDB::find(const string &name) {
+	auto i = _index.find(name);
+	if (i != _index.end())
+		return i->second;
+	return _items.end();
+}
+
+MacroDB::const_iterator MacroDB::find(const string &name) const {
+	auto i = _index.find(name);
+	if (i != _index.end())
+		return i->second;
+	return _items.end();
+}
+
+aMacroDef* MacroDB::get(const string &name) const {
+	auto i = _index.find(name);
+	if (i != _index.end())
+		return i->second->second;
+	if (_base)
+		return _base->db.get(name);
+	return nullptr;
+}
+
+bool MacroDB::contains(const string &name) const {
+	return _index.find(name) != _index.end()
+			|| (_base && _base->db.contains(name));
+}
+
+bool MacroDB::insert(const value_type &item) {
+	if (contains(item.first))
+		return false;
+	auto it = _items.insert(_items.end(), item);
+	_index.emplace(it->first, it);
+	if (item.second == nullptr || !item.second->is_persistent)
+		_track_non_persistent(item.first);
+	else
+		_persistent_version++;
+	return true;
+}
+
+pair<MacroDB::iterator, bool> MacroDB::insert_or_assign(const string &name,
+		aMacroDef *def) {
+	auto i = _index.find(name);
+	bool inserted = i == _index.end();
+	iterator it;
+	if (inserted) {
+		// the item in the base is shadowed by the new item
+		it = _items.insert(_items.end(), { name, nullptr });
+		_index.emplace(it->first, it);
+		if (_base && _base->db.contains(name))
+			_persistent_version++;
+	} else {
+		it = i->second;
+		if (it->second && it->second->is_persistent)
+			_persistent_version++;
+	}
+	it->second = def;
+	if (def == nullptr || !def->is_persistent)
+		_track_non_persistent(name);
+	else
+		_persistent_version++;
+	return {it, inserted};
+}
+
+MacroDB::iterator MacroDB::erase(const_iterator it) {
+	auto i = _index.find(it->first);
+	if (i == _index.end() || i->second != it)
+		throw invalid_argument(
+				"MacroDB: the items of the base can not be removed");
+	if (it->second == nullptr || it->second->is_persistent)
+		_persistent_version++;
+	_index.erase(i);
+	return _items.erase(it);
+}
+
+size_t MacroDB::erase(const string &name) {
+	auto i = _index.find(name);
+	if (i == _index.end())
+		return 0;
+	erase(i->second);
+	return 1;
+}
+
+void MacroDB::clear() {
+	_index.clear();
+	_items.clear();
+	_non_persistent_name_set.clear();
+	_non_persistent_names.clear();
+	_persistent_version++;
+}
+
+vector<aMacroDef*> MacroDB::extract_non_persistent() {
+	vector<aMacroDef*> res;
+	for (auto &name : _non_persistent_names) {
+		auto i = _index.find(name);
+		if (i == _index.end())
+			continue;
+		auto it = i->second;
+		if (it->second && it->second->is_persistent)
+			continue;
+		_index.erase(i);
+		if (it->second)
+			res.push_back(it->second);
+		_items.erase(it);
+	}
+	_non_persistent_name_set.clear();
+	_non_persistent_names.clear();
+	return res;
+}
+
+void MacroDB::set_persistent(const string &name, bool is_persistent) {
+	auto i = _index.find(name);
+	if (i == _index.end())
+		throw out_of_range("MacroDB: " + name + " is not defined");
+	auto def = i->second->second;
+	if (def == nullptr || def->is_persistent == is_persistent)
+		return;
+	def->is_persistent = is_persistent;
+	if (!is_persistent)
+		_track_non_persistent(name);
+	_persistent_version++;
+}
+
+shared_ptr<MacroDBSnapshot> MacroDB::snapshot_persistent() const {
+	auto res = make_shared<MacroDBSnapshot>();
+	auto add_persistent = [&res](const MacroDB &db) {
+		for (auto &m : db) {
+			if (m.second && m.second->is_persistent)
+				res->db.insert( { m.first, m.second->clone() });
+		}
+	};
+	add_persistent(*this);
+	if (_base) {
+		// the items which are not shadowed by the items of this DB
+		for (auto &m : _base->db) {
+			if (_index.find(m.first) == _index.end())
+				res->db.insert( { m.first, m.second->clone() });
+		}
+	}
+	return res;
+}
+
+void MacroDB::set_base(shared_ptr<MacroDBSnapshot> base) {
+	_base = base;
+	_persistent_version++;
+}
+
+const shared_ptr<MacroDBSnapshot>& MacroDB::get_base() const {
+	return _base;
+}
+
+size_t MacroDB::get_persistent_version() const {
+	return _persistent_version;
+}
+
+MacroDBSnapshot::MacroDBSnapshot() {
+}
+
+MacroDBSnapshot::~MacroDBSnapshot() {
+	for (auto &m : db)
+		delete m.second;
+}
+
+}
+}
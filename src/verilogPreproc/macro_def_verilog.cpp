@@ -149,6 +149,33 @@ void MacroDefVerilog::collect_string_intervals(const string &tmpl) {
 				"Unfinished string in definition of macro " + name + ".");
 }
 
+aMacroDef* MacroDefVerilog::clone() const {
+	return new MacroDefVerilog(*this);
+}
+
+bool MacroDefVerilog::equals(const aMacroDef &_other) const {
+	if (!aMacroDef::equals(_other))
+		return false;
+	auto &other = static_cast<const MacroDefVerilog&>(_other);
+	if (has_params != other.has_params || params.size() != other.params.size()
+			|| body.size() != other.body.size())
+		return false;
+	for (size_t i = 0; i < params.size(); i++) {
+		auto &a = params[i];
+		auto &b = other.params[i];
+		if (a.name != b.name || a.has_def_val != b.has_def_val
+				|| a.def_val != b.def_val)
+			return false;
+	}
+	for (size_t i = 0; i < body.size(); i++) {
+		auto &a = body[i];
+		auto &b = other.body[i];
+		if (a.arg_no != b.arg_no || a.str != b.str)
+			return false;
+	}
+	return true;
+}
+
 bool MacroDefVerilog::requires_args() {
 	return has_params;
 }
@@ -1,6 +1,8 @@
 #include <hdlConvertor/verilogPreproc/verilogPreproc.h>
 #include <hdlConvertor/verilogPreproc/macro_def_verilog.h>
 #include <antlr4-runtime.h>
+#include <algorithm>
+#include <set>
 
 namespace hdlConvertor {
 namespace verilog_pp {
@@ -21,10 +23,12 @@ void replaceStringInPlace(string &subject, const string &search,
 }
 
 VerilogPreproc::VerilogPreproc(VerilogPreprocContainer &_container,
-		TokenStream &tokens, bool _added_incdir, size_t include_depth_limit) :
-		container(_container), _tokens(*(CommonTokenStream*) &tokens), added_incdir(
-				_added_incdir), include_depth_limit(include_depth_limit), _rewriter(
-				&tokens) {
+		TokenStream &tokens, bool _added_incdir, PreprocOutput &_out,
+		size_t include_depth_limit) :
+		_flushed(0), container(_container), _tokens(
+				*(CommonTokenStream*) &tokens), added_incdir(_added_incdir), include_depth_limit(
+				include_depth_limit), out(_out) {
+	_file_id = out.source_map.get_file_id(_tokens.getSourceName());
 	switch (container.lang) {
 	case Language::VERILOG1995:
 	case Language::VERILOG2001:
@@ -45,45 +49,95 @@ VerilogPreproc::~VerilogPreproc() {
 
 template<typename CTX_T>
 void processIfdef(VerilogPreproc &sefl, CTX_T *ctx, bool is_negated,
-		MacroDB &defineDB, antlr4::TokenStreamRewriter &rewriter) {
+		VerilogPreprocContainer &container) {
 	// printf("@%s\n", __PRETTY_FUNCTION__);
 	bool en_in = !is_negated;
 	auto cond_ids = ctx->cond_id();
 	auto group_of_lines = ctx->group_of_lines();
 	auto group_of_line = group_of_lines.begin();
-	bool matched = false;
-	misc::Interval token_to_keep;
+	auto token = ctx->getSourceInterval();
+	// the directives before the group are deleted before the visit of the group
+	// because the output up to the nested `include is flushed before the include
 	for (auto cond_id : cond_ids) {
 		auto macro_name = cond_id->getText();
-		auto is_defined = defineDB.find(macro_name) != defineDB.end();
+		auto is_defined = container.get_macro(macro_name) != nullptr;
 		if (is_defined == en_in) {
 			auto gl = *group_of_line;
 			assert(gl);
+			auto token_to_keep = gl->getSourceInterval();
+			sefl.delete_tokens(token.a, token_to_keep.a - 1);
 			sefl.visitGroup_of_lines(gl);
-			token_to_keep = gl->getSourceInterval();
-			matched = true;
-			break;
+			sefl.delete_tokens(token_to_keep.b + 1, token.b);
+			return;
 		}
 		++group_of_line;
 	}
-	if (!matched && ctx->ELSE() != nullptr) {
+	if (ctx->ELSE() != nullptr) {
 		auto eg = ctx->else_group_of_lines();
+		auto token_to_keep = eg->getSourceInterval();
+		sefl.delete_tokens(token.a, token_to_keep.a - 1);
 		sefl.visitElse_group_of_lines(eg);
-		token_to_keep = eg->getSourceInterval();
-		matched = true;
-	}
-	auto token = ctx->getSourceInterval();
-	if (matched) {
-		rewriter.Delete(token.a, token_to_keep.a - 1);
-		rewriter.Delete(token_to_keep.b + 1, token.b);
+		sefl.delete_tokens(token_to_keep.b + 1, token.b);
 	} else {
-		rewriter.Delete(token.a, token.b);
+		sefl.delete_tokens(token.a, token.b);
 	}
 }
 
 void VerilogPreproc::replace_context_by_bank(antlr4::ParserRuleContext *ctx) {
 	misc::Interval token = ctx->getSourceInterval();
-	_rewriter.Delete(token.a, token.b);
+	delete_tokens(token.a, token.b);
+}
+
+void VerilogPreproc::replace_tokens(ssize_t start, ssize_t stop,
+		unique_ptr<PreprocOutput> replacement) {
+	if (start > stop)
+		return;
+	// the edits inside of this range are overridden
+	// (e.g. the macro call in the `include path)
+	auto e = _edits.lower_bound(start);
+	while (e != _edits.end() && e->first <= (size_t) stop)
+		e = _edits.erase(e);
+	_edits[start] = {(size_t) stop, move(replacement)};
+}
+
+void VerilogPreproc::delete_tokens(ssize_t start, ssize_t stop) {
+	replace_tokens(start, stop, nullptr);
+}
+
+void VerilogPreproc::flush_output(size_t end) {
+	// the edits before _flushed were already written and removed
+	auto e = _edits.begin();
+	while (_flushed < end) {
+		// the edits inside of an already written edit (added after the enclosing edit)
+		// are overridden by it
+		while (e != _edits.end() && e->first < _flushed)
+			e = _edits.erase(e);
+		if (e != _edits.end() && e->first == _flushed) {
+			if (e->second.replacement)
+				out.append(*e->second.replacement);
+			_flushed = e->second.stop + 1;
+			e = _edits.erase(e);
+			continue;
+		}
+		auto t = _tokens.get(_flushed);
+		if (t->getType() == Token::EOF) {
+			_flushed = end;
+			break;
+		}
+		out.append(t->getText(), _file_id, t->getLine(), false);
+		_flushed++;
+	}
+}
+
+antlrcpp::Any VerilogPreproc::visitFile(
+		verilogPreprocParser::FileContext *ctx) {
+	for (auto t : ctx->text()) {
+		visitText(t);
+		// the edits are final for the tokens of the already processed text
+		flush_output(t->getSourceInterval().b + 1);
+	}
+	flush_output(_tokens.size());
+	return nullptr;
 }
 
 antlrcpp::Any VerilogPreproc::visitResetall(
@@ -169,11 +223,7 @@ antlrcpp::Any VerilogPreproc::visitUndef(
 	//printf("@%s\n",__PRETTY_FUNCTION__);
 	// we simply remove the macro from the macroDB object. So it is not anymore
 	// defined
-	auto m = container.defineDB.find(ctx->ID()->getText());
-	if (m != container.defineDB.end() && !m->second->is_persistent) {
-		container.defineDB.erase(m);
-		delete m->second;
-	}
+	container.undef_macro(ctx->ID()->getText());
 
 	replace_context_by_bank(ctx);
 	return NULL;
@@ -183,7 +233,7 @@ antlrcpp::Any VerilogPreproc::visitUndefineall(
 		verilogPreprocParser::UndefineallContext *ctx) {
 	//printf("@%s\n",__PRETTY_FUNCTION__);
 	replace_context_by_bank(ctx);
-	container.delete_non_persystent_macro_defs();
+	container.undefineall();
 	return NULL;
 }
 
@@ -253,7 +303,7 @@ antlrcpp::Any VerilogPreproc::visitDefine(
 	bool has_params = da != nullptr;
 	try {
 		auto item = new MacroDefVerilog(def_name, has_params, *params, body);
-		container.defineDB.insert( { def_name, item });
+		container.define_macro(item);
 	} catch (const ParseException &e) {
 		throw_input_caused_error(ctx, e.what());
 	}
@@ -348,6 +398,232 @@ std::string vector_to_string(const std::vector<T> &vec) {
 	return oss.str();
 }
 
+// names which are not macro calls when used behind '`'
+static const set<string> PREPROC_DIRECTIVE_NAMES = { "include", "define",
+		"ifndef", "ifdef", "elsif", "else", "endif", "undef", "begin_keywords",
+		"end_keywords", "pragma", "undefineall", "resetall", "celldefine",
+		"endcelldefine", "timescale", "default_nettype", "line",
+		"unconnected_drive", "nounconnected_drive", "protected" };
+
+static inline bool is_id_first_char(char c) {
+	return isalpha(static_cast<unsigned char>(c)) || c == '_';
+}
+
+static inline bool is_id_char(char c) {
+	return isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+
+/*
+ * Match the string literal (STR token of the lexer) starting at str[i]
+ * :return: the index behind the string or npos if the string is not valid
+ *          or if it contains escape sequences (not supported by the fast expansion)
+ * */
+static size_t match_str_literal(const string &str, size_t i) {
+	assert(str[i] == '"');
+	for (i++; i < str.size(); i++) {
+		char c = str[i];
+		if (c == '"')
+			return i + 1;
+		if (c == '\\' || c == '\r' || c == '\n')
+			return string::npos;
+	}
+	return string::npos;
+}
+
+/*
+ * Parse the argument list of the macro call (same as EXPR_MODE of the lexer)
+ * :param i: index behind the '('
+ * :return: the index behind the ')' or npos if the argument list is not complete
+ *          or contains something not supported by the fast expansion
+ * */
+static size_t parse_macro_args_str(const string &str, size_t i,
+		vector<string> &args) {
+	size_t parenthesis = 0;
+	size_t braces = 0;
+	size_t square_braces = 0;
+	size_t arg_start = i;
+	while (i < str.size()) {
+		char c = str[i];
+		switch (c) {
+		case '"':
+			i = match_str_literal(str, i);
+			if (i == string::npos)
+				return i;
+			continue;
+		case '/':
+			if (i + 1 < str.size() && (str[i + 1] == '/' || str[i + 1] == '*'))
+				return string::npos;
+			break;
+		case '(':
+			parenthesis++;
+			break;
+		case ')':
+			if (parenthesis == 0) {
+				// `macro() has no argument, `macro( ) has an empty argument
+				if (args.size() || i != arg_start) {
+					string a = str.substr(arg_start, i - arg_start);
+					args.push_back(trim(a));
+				}
+				return i + 1;
+			}
+			parenthesis--;
+			break;
+		case '{':
+			braces++;
+			break;
+		case '}':
+			if (braces)
+				braces--;
+			break;
+		case '[':
+			square_braces++;
+			break;
+		case ']':
+			if (square_braces)
+				square_braces--;
+			break;
+		case ',':
+			if (parenthesis == 0 && braces == 0 && square_braces == 0) {
+				string a = str.substr(arg_start, i - arg_start);
+				args.push_back(trim(a));
+				arg_start = i + 1;
+			}
+			break;
+		}
+		i++;
+	}
+	return string::npos;
+}
+
+/*
+ * :return: true if the body of the macro contains `" or `` which can not be processed
+ * 		by the fast expansion, the arguments of the macro call would be stringified/pasted
+ * 		before they are expanded in the full preprocessor
+ * */
+static bool uses_stringification_or_pasting(const MacroDefVerilog &m) {
+	for (const auto &f : m.body) {
+		if (f.arg_no < 0
+				&& (f.str.find("`\"") != string::npos
+						|| f.str.find("``") != string::npos))
+			return true;
+	}
+	return false;
+}
+
+bool VerilogPreproc::expand_macro_calls_fast(const string &str, size_t line,
+		string &res) {
+	const size_t npos = string::npos;
+	const size_t n = str.size();
+	size_t i = 0;
+	res.reserve(res.size() + n);
+	while (i < n) {
+		char c = str[i];
+		if (c == '"') {
+			size_t e = match_str_literal(str, i);
+			if (e == npos)
+				return false;
+			res.append(str, i, e - i);
+			i = e;
+			continue;
+		} else if (c == '/' && i + 1 < n
+				&& (str[i + 1] == '/' || str[i + 1] == '*')) {
+			// comments may contain anything
+			return false;
+		} else if (c == '\\') {
+			// escaped identifier, the '`' in it is not a macro call
+			size_t e = i + 1;
+			while (e < n && !isspace(static_cast<unsigned char>(str[e])))
+				e++;
+			if (e < n) {
+				if (str[e] == '\n')
+					line++;
+				e++;
+			}
+			res.append(str, i, e - i);
+			i = e;
+			continue;
+		} else if (c != '`') {
+			if (c == '\n')
+				line++;
+			res.push_back(c);
+			i++;
+			continue;
+		}
+
+		// '`'
+		if (i + 1 >= n)
+			return false;
+		char c1 = str[i + 1];
+		if (!is_id_first_char(c1)) {
+			// `" and `` (stringification and token pasting) are processed by the lexer
+			// and the macro calls inside of them are not expanded in the same way
+			return false;
+		}
+		size_t name_end = i + 2;
+		while (name_end < n && is_id_char(str[name_end]))
+			name_end++;
+		string macro_name = str.substr(i + 1, name_end - i - 1);
+		if (PREPROC_DIRECTIVE_NAMES.find(macro_name)
+				!= PREPROC_DIRECTIVE_NAMES.end())
+			return false;
+
+		size_t call_end = name_end;
+		while (call_end < n && (str[call_end] == ' ' || str[call_end] == '\t'))
+			call_end++;
+		bool has_args = call_end < n && str[call_end] == '(';
+		vector<string> args;
+		if (has_args) {
+			call_end = parse_macro_args_str(str, call_end + 1, args);
+			if (call_end == npos)
+				return false;
+		} else {
+			call_end = name_end;
+		}
+
+		auto m = dynamic_cast<MacroDefVerilog*>(container.get_macro(macro_name));
+		// `__LINE__ and `__FILE__ depend on the location of the call
+		if (m == nullptr || uses_stringification_or_pasting(*m))
+			return false;
+		// the arguments would be a part of the replacement
+		if (has_args && !m->requires_args())
+			return false;
+
+		string replacement;
+		try {
+			replacement = m->replace(args, has_args, this, nullptr);
+		} catch (const ParseException&) {
+			// let the full preprocessor report the error with the location
+			return false;
+		}
+		if (container.lang >= Language::SV2005) {
+			replace_substring(replacement, "``", "");
+			replace_substring(replacement, "`\\`", "\\");
+		}
+		if (replacement.find('`') != npos) {
+			if (container.macro_call_stack.size()
+					>= container.max_macro_call_stack_size)
+				return false;
+			container.macro_call_stack.push_back(macro_name);
+			string expanded;
+			if (!expand_macro_calls_fast(replacement, line, expanded))
+				expanded = container.run_preproc_str(replacement, line - 1);
+			container.macro_call_stack.pop_back();
+			replacement = move(expanded);
+		}
+		if (container.lang >= Language::SV2005) {
+			try {
+				unescape_string_dblquotes(replacement);
+			} catch (const ParseException&) {
+				return false;
+			}
+		}
+		res += replacement;
+		line += count(str.begin() + i, str.begin() + call_end, '\n');
+		i = call_end;
+	}
+	return true;
+}
+
 //method call when `macro is found in the source code
 antlrcpp::Any VerilogPreproc::visitMacro_call(
 		verilogPreprocParser::Macro_callContext *ctx) {
@@ -378,15 +654,15 @@ antlrcpp::Any VerilogPreproc::visitMacro_call(
 	}
 
 	//test if the macro has already been defined
-	auto m = container.defineDB.find(macro_name);
-	if (m == container.defineDB.end()) {
+	auto m = container.get_macro(macro_name);
+	if (m == nullptr) {
 		throw_input_caused_error(ctx, macro_name + " is not defined");
 	}
 
 	//build the replacement string by calling the replacement method of the
 	//macro_replace object and the provided argument of the macro.
 	bool _has_args = has_args;
-	if (m->second->requires_args()) {
+	if (m->requires_args()) {
 		if (has_args) {
 			parse_macro_args(ctx, args);
 		}
@@ -395,11 +671,11 @@ antlrcpp::Any VerilogPreproc::visitMacro_call(
 	}
 	string replacement;
 	try {
-		replacement = m->second->replace(args, _has_args, this, ctx);
+		replacement = m->replace(args, _has_args, this, ctx);
 	} catch (const ParseException &e) {
 		throw_input_caused_error(ctx, e.what());
 	}
-	if (!m->second->requires_args() && has_args) {
+	if (!m->requires_args() && has_args) {
 		// args belongs to the code and not to macro
 		auto a = ctx->start->getStartIndex() + macro_name.size();
 		auto b = ctx->stop->getStopIndex();
@@ -422,8 +698,15 @@ antlrcpp::Any VerilogPreproc::visitMacro_call(
 							+ ".");
 		}
 		container.macro_call_stack.push_back(macro_name);
-		replacement = container.run_preproc_str(replacement,
-				ctx->start->getLine() - 1);
+		string expanded;
+		if (container.fast_macro_expansion
+				&& expand_macro_calls_fast(replacement, ctx->start->getLine(),
+						expanded)) {
+			replacement = move(expanded);
+		} else {
+			replacement = container.run_preproc_str(replacement,
+					ctx->start->getLine() - 1);
+		}
 		container.macro_call_stack.pop_back();
 	}
 
@@ -433,7 +716,10 @@ antlrcpp::Any VerilogPreproc::visitMacro_call(
 	// replace the original macro in the source code by the replacement string
 	// we just setup
 	misc::Interval token = ctx->getSourceInterval();
-	_rewriter.replace(token.a, token.b, replacement);
+	auto out = make_unique<PreprocOutput>();
+	auto file_id = out->source_map.get_file_id(_tokens.getSourceName());
+	out->append(replacement, file_id, ctx->start->getLine(), true);
+	replace_tokens(token.a, token.b, move(out));
 	return replacement;
 }
 
@@ -441,7 +727,7 @@ antlrcpp::Any VerilogPreproc::visitMacro_call(
 antlrcpp::Any VerilogPreproc::visitIfdef_directive(
 		verilogPreprocParser::Ifdef_directiveContext *ctx) {
 	//  printf("@%s\n",__PRETTY_FUNCTION__);
-	processIfdef(*this, ctx, false, container.defineDB, _rewriter);
+	processIfdef(*this, ctx, false, container);
 	return nullptr;
 }
 
@@ -450,7 +736,7 @@ antlrcpp::Any VerilogPreproc::visitIfdef_directive(
 antlrcpp::Any VerilogPreproc::visitIfndef_directive(
 		verilogPreprocParser::Ifndef_directiveContext *ctx) {
 	//printf("@%s\n",__PRETTY_FUNCTION__);
-	processIfdef(*this, ctx, true, container.defineDB, _rewriter);
+	processIfdef(*this, ctx, true, container);
 	return nullptr;
 }
 
@@ -501,25 +787,65 @@ antlrcpp::Any VerilogPreproc::visitInclude(
 	} else {
 		// We are going to replace the content of the `include
 		// directive by the content of the processed file
-		misc::Interval token = ctx->getSourceInterval();
-		_rewriter.Delete(token.a, token.b);
 		filesystem::path my_incdir;
 		if (added_incdir) {
 			my_incdir = container.incdirs.back();
 			container.incdirs.pop_back();
 		}
+		// the output of the included file is written directly to the output
+		// after everything before the `include
+		misc::Interval token = ctx->getSourceInterval();
+		flush_output(token.a);
+		delete_tokens(token.a, token.b);
 		// run the pre-processor on it
-		auto replacement = container.run_preproc_file(filename);
+		container.run_preproc_include(filename, include_depth_limit, out);
 		if (added_incdir) {
 			container.incdirs.push_back(my_incdir);
 		}
-		//update the current source code
-		_rewriter.insertAfter(ctx->getStop(), replacement);
 
 	}
 	return nullptr;
 }
 
+static bool is_blank_text(verilogPreprocParser::TextContext *t) {
+	if (t->NEW_LINE().size())
+		return true;
+	auto code = t->CODE();
+	if (code) {
+		auto str = code->getText();
+		return str.find_first_not_of(" \t\r\n") == string::npos;
+	}
+	return false;
+}
+
+void VerilogPreproc::detect_include_guard(
+		verilogPreprocParser::FileContext *ctx, IncludeGuard &guard) {
+	guard.macro_name.clear();
+	guard.text_outside.clear();
+	verilogPreprocParser::Ifndef_directiveContext *ifndef = nullptr;
+	for (auto t : ctx->text()) {
+		if (is_blank_text(t))
+			continue;
+		auto pd = t->preprocess_directive();
+		if (ifndef || !pd || !pd->conditional()
+				|| !pd->conditional()->ifndef_directive())
+			return;
+		ifndef = pd->conditional()->ifndef_directive();
+	}
+	// `elsif/`else would be used if the guard is defined
+	if (!ifndef || ifndef->cond_id().size() != 1 || ifndef->ELSE())
+		return;
+
+	// there are only blank lines and comments around the `ifndef
+	// and the preprocessor left them untouched
+	auto token = ifndef->getSourceInterval();
+	if (token.a > 0)
+		guard.text_outside = _tokens.getText(misc::Interval(0, token.a - 1));
+	guard.text_outside += _tokens.getText(
+			misc::Interval(token.b + 1, (ssize_t) _tokens.size() - 1));
+	guard.macro_name = ifndef->cond_id(0)->getText();
+}
+
 void VerilogPreproc::throw_input_caused_error(antlr4::ParserRuleContext *ctx,
 		const std::string &_msg) {
 	auto ts = _tokens.getTokenSource();
@@ -1,6 +1,8 @@
 #include <hdlConvertor/verilogPreproc/verilogPreprocContainer.h>
 #include <hdlConvertor/verilogPreproc/default_macro_defs.h>
 #include <hdlConvertor/verilogPreproc/verilogPreproc.h>
+#include <hdlConvertor/utf8CharStream.h>
+#include <algorithm>
 
 namespace hdlConvertor {
 namespace verilog_pp {
@@ -11,7 +13,9 @@ using namespace antlr4;
 VerilogPreprocContainer::VerilogPreprocContainer(Language _lang,
 		SyntaxErrorLogger &_syntaxErrLogger, verilog_pp::MacroDB &_defineDB) :
 		defineDB(_defineDB), lang(_lang), syntaxErrLogger(_syntaxErrLogger), max_macro_call_stack_size(
-				DEFAULT_MAX_MACRO_CALL_STACK_SIZE), debug_dump_tokens(false) {
+				DEFAULT_MAX_MACRO_CALL_STACK_SIZE), debug_dump_tokens(false), include_cache(
+				nullptr), fast_ifdef_skip(false), fast_copy(false), fast_macro_expansion(
+				true) {
 }
 
 void VerilogPreprocContainer::init(const vector<string> &_incdirs) {
@@ -24,9 +28,12 @@ void VerilogPreprocContainer::init(const vector<string> &_incdirs) {
 		incdirs.push_back(p);
 }
 
-string VerilogPreprocContainer::run_preproc(ANTLRInputStream &input,
-		bool added_incdir) {
+void VerilogPreprocContainer::run_preproc(CharStream &input,
+		bool added_incdir, PreprocOutput &out, size_t line_offset,
+		IncludeGuard *include_guard) {
 	verilogPreproc_antlr::verilogPreprocLexer pp_lexer(&input);
+	if (line_offset)
+		pp_lexer.setLine(line_offset + 1);
 	pp_lexer.removeErrorListeners();
 	pp_lexer.addErrorListener(&syntaxErrLogger);
 
@@ -37,7 +44,7 @@ string VerilogPreprocContainer::run_preproc(ANTLRInputStream &input,
 	parser.addErrorListener(&syntaxErrLogger);
 	parser.language_version = lang;
 
-	tree::ParseTree *tree = parser.file();
+	auto tree = parser.file();
 	if (debug_dump_tokens) {
 		auto rec = dynamic_cast<antlr4::Recognizer*>(&pp_lexer);
 		cout << "#tokens.size()=" << tokens.size() << endl;
@@ -57,10 +64,10 @@ string VerilogPreprocContainer::run_preproc(ANTLRInputStream &input,
 	}
 	syntaxErrLogger.error_prefix = orig_err_prefix;
 
-	verilog_pp::VerilogPreproc extractor(*this, tokens, added_incdir);
+	verilog_pp::VerilogPreproc extractor(*this, tokens, added_incdir, out);
 	extractor.visit(tree);
-	string res = extractor._rewriter.getText();
-	return res;
+	if (include_guard)
+		extractor.detect_include_guard(tree, *include_guard);
 }
 
 bool VerilogPreprocContainer::add_parent_dir_to_incldirs(
@@ -73,60 +80,311 @@ bool VerilogPreprocContainer::add_parent_dir_to_incldirs(
 		incdirs.push_back(dir);
 	return add_to_inc_dir;
 }
-string VerilogPreprocContainer::run_preproc_file(
-		const filesystem::path &file_name) {
+void VerilogPreprocContainer::run_preproc_file(
+		const filesystem::path &file_name, PreprocOutput &out,
+		IncludeGuard *include_guard) {
 	bool add_to_inc_dir = add_parent_dir_to_incldirs(file_name);
 	// register the include file on the include file stack
 	incfile_stack.push_back( { file_name, 0 });
+	for (auto r : include_cache_recording) {
+		r->nested_include_depth = max(r->nested_include_depth,
+				incfile_stack.size() - r->_incfile_stack_size - 1);
+	}
 
-	ANTLRFileStream input(file_name.u8string());
-	auto res = run_preproc(input, add_to_inc_dir);
+	MmapFileCharStream input(file_name);
+	if (fast_ifdef_skip || fast_copy)
+		run_preproc_fast(input, add_to_inc_dir, out, include_guard);
+	else
+		run_preproc(input, add_to_inc_dir, out, 0, include_guard);
 
 	incfile_stack.pop_back();
 
 	if (add_to_inc_dir)
 		incdirs.pop_back();
+}
 
-	return res;
+void VerilogPreprocContainer::run_preproc_fast(Utf8CharStream &input,
+		bool added_incdir, PreprocOutput &out, IncludeGuard *include_guard) {
+	auto data = input.get_utf8_data();
+	IfdefScanner scanner;
+	if (!scanner.scan(data.data(), data.size())
+			|| (!fast_copy && scanner.blocks.empty())) {
+		run_preproc(input, added_incdir, out, 0, include_guard);
+		return;
+	}
+	if (include_guard) {
+		// same as VerilogPreproc::detect_include_guard()
+		include_guard->macro_name.clear();
+		include_guard->text_outside.clear();
+		if (scanner.blank_outside && scanner.blocks.size() == 1
+				&& scanner.blocks[0].is_negated
+				&& scanner.blocks[0].branches.size() == 1) {
+			auto &b = scanner.blocks[0];
+			include_guard->text_outside = data.substr(0, b.start);
+			include_guard->text_outside += data.substr(b.end);
+			include_guard->macro_name = b.branches[0].cond_id;
+		}
+	}
+	FastPreprocInput in { input, data, scanner, added_incdir, out,
+			out.source_map.get_file_id(input.getSourceName()), 0, 0 };
+	run_preproc_ifdef_blocks(in, scanner.blocks, 0, data.size());
 }
 
-string VerilogPreprocContainer::run_preproc_str(const std::string &input_str,
-		size_t line_offset) {
-	std::string line_offset_str;
-	string formal_file_name;
-	if (line_offset) {
-		// [TODO] in efficient (I do not know how to set line offset for ANTLRInputStream)
-		line_offset_str = std::string(line_offset, '\n');
+void VerilogPreprocContainer::run_preproc_ifdef_blocks(FastPreprocInput &in,
+		const vector<IfdefBlock> &blocks, size_t start, size_t end) {
+	for (auto &b : blocks) {
+		run_preproc_segment(in, start, b.start);
+		if (!fast_ifdef_skip) {
+			run_preproc_range(in, b.start, b.end);
+			start = b.end;
+			continue;
+		}
+		// the condition is evaluated in the same way as in processIfdef()
+		// (`elsif uses the polarity of the `ifdef/`ifndef)
+		for (auto &br : b.branches) {
+			if (br.cond_id.empty()
+					|| (get_macro(br.cond_id) != nullptr) != b.is_negated) {
+				run_preproc_ifdef_blocks(in, br.nested, br.text_start,
+						br.text_end);
+				break;
+			}
+		}
+		start = b.end;
+	}
+	run_preproc_segment(in, start, end);
+}
+
+void VerilogPreprocContainer::run_preproc_segment(FastPreprocInput &in,
+		size_t start, size_t end) {
+	if (!fast_copy)
+		return run_preproc_range(in, start, end);
+
+	// the directives overlapping with [start, end)
+	auto &dirs = in.scanner.directives;
+	auto d = partition_point(dirs.begin(), dirs.end(),
+			[start](const pair<size_t, size_t> &r) {
+				return r.second <= start;
+			});
+	while (start < end) {
+		if (d == dirs.end() || d->first >= end) {
+			copy_range(in, start, end);
+			return;
+		}
+		size_t dir_start = max(d->first, start);
+		size_t dir_end = min(d->second, end);
+		for (++d; d != dirs.end() && d->first < end; ++d) {
+			if (d->first - dir_end >= FAST_COPY_MIN_SIZE)
+				break;
+			dir_end = min(d->second, end);
+		}
+		copy_range(in, start, dir_start);
+		run_preproc_range(in, dir_start, dir_end);
+		start = dir_end;
+	}
+}
+
+void VerilogPreprocContainer::run_preproc_range(FastPreprocInput &in,
+		size_t start, size_t end) {
+	if (start >= end)
+		return;
+	// the skipped parts are not lexed, only the lines are counted
+	in.line_offset += count(in.data.begin() + in.pos, in.data.begin() + start,
+			'\n');
+	in.pos = start;
+	Utf8CharStream segment(in.data.data() + start, end - start);
+	segment.name = in.input.name;
+	run_preproc(segment, in.added_incdir, in.out, in.line_offset);
+}
+
+void VerilogPreprocContainer::copy_range(FastPreprocInput &in, size_t start,
+		size_t end) {
+	if (start >= end)
+		return;
+	in.line_offset += count(in.data.begin() + in.pos, in.data.begin() + start,
+			'\n');
+	in.pos = start;
+	in.out.append(in.data.substr(start, end - start), in.file_id,
+			in.line_offset + 1, false);
+}
+
+string VerilogPreprocContainer::run_preproc_file(
+		const filesystem::path &file_name) {
+	PreprocOutput out;
+	run_preproc_file(file_name, out);
+	return move(out.text);
+}
+
+bool VerilogPreprocContainer::include_cache_entry_usable(
+		const IncludeCacheEntry &e, filesystem::file_time_type mtime,
+		uintmax_t file_size, size_t include_depth_limit) {
+	if (e.mtime != mtime || e.file_size != file_size || e.lang != lang
+			|| e.incdirs != incdirs)
+		return false;
+	// the nested includes would fail on the include depth limit
+	if (incfile_stack.size() + e.nested_include_depth > include_depth_limit)
+		return false;
+	for (auto &d : e.macro_deps) {
+		auto cur = defineDB.get(d.first);
+		if (cur == nullptr) {
+			if (d.second)
+				return false;
+		} else if (!d.second || !d.second->equals(*cur)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void VerilogPreprocContainer::replay_include_cache_entry(
+		const IncludeCacheEntry &e) {
+	// the files which are including this file depend on same macros
+	for (auto r : include_cache_recording) {
+		for (auto &d : e.macro_deps)
+			r->add_macro_dep(d.first, d.second.get());
+		r->nested_include_depth = max(r->nested_include_depth,
+				incfile_stack.size() + e.nested_include_depth
+						- r->_incfile_stack_size);
+	}
+	for (auto &op : e.side_effects) {
+		if (op.def)
+			define_macro(op.def->clone());
+		else
+			undef_macro(op.name);
 	}
+}
+
+void VerilogPreprocContainer::run_preproc_include_file(
+		const filesystem::path &file_name, IncludeGuard &guard,
+		PreprocOutput &out) {
+	run_preproc_file(file_name, out, &guard);
+	if (guard.macro_name.size())
+		include_cache->add_include_guard(file_name, guard);
+}
+
+void VerilogPreprocContainer::run_preproc_include(
+		const filesystem::path &file_name, size_t include_depth_limit,
+		PreprocOutput &out) {
+	if (include_cache == nullptr || !include_cache->enabled)
+		return run_preproc_file(file_name, out);
+
+	IncludeGuard guard;
+	if (include_cache->get_include_guard(file_name, guard)
+			&& get_macro(guard.macro_name)) {
+		include_cache->register_guard_skip();
+		// the text around the guard has no meaningful location, it is mostly whitespace
+		out.append(guard.text_outside,
+				out.source_map.get_file_id(file_name.u8string()), 1, true);
+		return;
+	}
+	// the include from the macro expansion depends also on macro_call_stack
+	if (macro_call_stack.size())
+		return run_preproc_include_file(file_name, guard, out);
+
+	error_code ec;
+	auto mtime = filesystem::last_write_time(file_name, ec);
+	if (ec)
+		return run_preproc_include_file(file_name, guard, out);
+	auto file_size = filesystem::file_size(file_name, ec);
+	if (ec)
+		return run_preproc_include_file(file_name, guard, out);
+
+	for (auto &e : include_cache->get(file_name)) {
+		if (include_cache_entry_usable(*e, mtime, file_size,
+				include_depth_limit)) {
+			include_cache->register_lookup(true);
+			if (e->include_guard.macro_name.size())
+				include_cache->add_include_guard(file_name, e->include_guard);
+			replay_include_cache_entry(*e);
+			out.append(e->output);
+			return;
+		}
+	}
+	include_cache->register_lookup(false);
+
+	auto entry = make_unique<IncludeCacheEntry>();
+	entry->mtime = mtime;
+	entry->file_size = file_size;
+	entry->lang = lang;
+	entry->incdirs = incdirs;
+	entry->_incfile_stack_size = incfile_stack.size();
+	include_cache_recording.push_back(entry.get());
+	// the output is streamed, the entry just takes a copy of it
+	out.add_recorder(&entry->output);
+	try {
+		run_preproc_include_file(file_name, entry->include_guard, out);
+	} catch (...) {
+		out.remove_recorder(&entry->output);
+		include_cache_recording.pop_back();
+		throw;
+	}
+	out.remove_recorder(&entry->output);
+	include_cache_recording.pop_back();
+	if (entry->cacheable)
+		include_cache->insert(file_name, move(entry));
+}
+
+void VerilogPreprocContainer::run_preproc_str(const std::string &input_str,
+		size_t line_offset, PreprocOutput &out) {
+	string formal_file_name;
 	if (incfile_stack.size()) {
 		formal_file_name = incfile_stack.back().first.u8string();
 	} else {
 		formal_file_name = STRING_FILENAME;
 	}
-	ANTLRInputStream input_for_preprocessor(line_offset_str + input_str);
+	// the input is not copied, it lives longer than the preprocessor
+	Utf8CharStream input_for_preprocessor(input_str.data(), input_str.size());
 	input_for_preprocessor.name = formal_file_name;
-	auto res = run_preproc(input_for_preprocessor, false);
-	if (line_offset) {
-		if (res.size() < line_offset) {
-			throw runtime_error(
-					"Running preprocessor consumed offset newlines, this should not happend");
-		}
-		return res.substr(line_offset);
-	} else {
-		return res;
+	run_preproc(input_for_preprocessor, false, out, line_offset);
+}
+
+string VerilogPreprocContainer::run_preproc_str(const std::string &input_str,
+		size_t line_offset) {
+	PreprocOutput out;
+	run_preproc_str(input_str, line_offset, out);
+	return move(out.text);
+}
+
+aMacroDef* VerilogPreprocContainer::get_macro(const string &name) {
+	aMacroDef *res = defineDB.get(name);
+	for (auto r : include_cache_recording)
+		r->add_macro_dep(name, res);
+	return res;
+}
+
+bool VerilogPreprocContainer::define_macro(aMacroDef *def) {
+	// the result of the define depends on the previous definition
+	get_macro(def->name);
+	if (!defineDB.insert( { def->name, def })) {
+		delete def;
+		return false;
+	}
+	for (auto rec : include_cache_recording) {
+		rec->side_effects.push_back(
+				{ def->name, unique_ptr<aMacroDef>(def->clone()) });
 	}
+	return true;
+}
 
+void VerilogPreprocContainer::undef_macro(const string &name) {
+	auto d = get_macro(name);
+	if (d && !d->is_persistent) {
+		defineDB.erase(name);
+		delete d;
+		for (auto rec : include_cache_recording)
+			rec->side_effects.push_back( { name, nullptr });
+	}
+}
+
+void VerilogPreprocContainer::undefineall() {
+	// the result would depend on all macros
+	for (auto rec : include_cache_recording)
+		rec->cacheable = false;
+	delete_non_persystent_macro_defs();
 }
 
 void VerilogPreprocContainer::delete_non_persystent_macro_defs() {
-	auto it = defineDB.begin();
-	for (; it != defineDB.end();) {
-		if (!it->second->is_persistent) {
-			defineDB.erase(it++);
-		} else {
-			++it;
-		}
-	}
+	for (auto d : defineDB.extract_non_persistent())
+		delete d;
 }
 
 VerilogPreprocContainer::~VerilogPreprocContainer() {
@@ -9,6 +9,7 @@
 #include <hdlConvertor/vhdlConvertor/packageHeaderParser.h>
 #include <hdlConvertor/vhdlConvertor/packageParser.h>
 #include <hdlConvertor/vhdlConvertor/referenceParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 namespace vhdl {
@@ -151,7 +152,7 @@ void VhdlDesignFileParser::visitLibrary_clause(
 
 void flatten_doted_expr(std::unique_ptr<iHdlExpr> e,
 		std::vector<std::unique_ptr<iHdlExpr>> &arr) {
-	auto o = dynamic_cast<HdlCall*>(e->data);
+	auto o = hdl_expr_item_cast<HdlCall>(e->data);
 	if (o) {
 		if (o->op == HdlOperatorType::DOT) {
 			for (auto &_o : o->operands) {
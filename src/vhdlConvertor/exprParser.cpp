@@ -6,6 +6,7 @@
 #include <hdlConvertor/vhdlConvertor/literalParser.h>
 #include <hdlConvertor/vhdlConvertor/referenceParser.h>
 #include <hdlConvertor/createObject.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 #include <assert.h>
 
 namespace hdlConvertor {
@@ -582,7 +583,7 @@ std::unique_ptr<iHdlExpr> VhdlExprParser::visitProcedure_call(
 		vhdlParser::Procedure_callContext *ctx) {
 	// procedure_call: name;
 	auto fnCall = VhdlReferenceParser::visitName(ctx->name());
-	auto c = dynamic_cast<HdlCall*>(fnCall->data);
+	auto c = hdl_expr_item_cast<HdlCall>(fnCall->data);
 
 	if (c == nullptr || c->op != HdlOperatorType::CALL) {
 		std::vector<std::unique_ptr<iHdlExpr>> args;
@@ -7,6 +7,7 @@
 #include <hdlConvertor/notImplementedLogger.h>
 #include <hdlConvertor/vhdlConvertor/literalParser.h>
 #include <hdlConvertor/vhdlConvertor/referenceParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 namespace vhdl {
@@ -167,7 +168,7 @@ std::unique_ptr<iHdlExpr> VhdlLiteralParser::visitEnumeration_literal(
 
 	auto _cl = ctx->CHARACTER_LITERAL()->getText();
 	auto cl = visitCHARACTER_LITERAL(ctx->CHARACTER_LITERAL(), _cl);
-	dynamic_cast<HdlValue*>(cl->data)->bits = 8;
+	hdl_expr_item_cast<HdlValue>(cl->data)->bits = 8;
 	return cl;
 }
 std::unique_ptr<iHdlExpr> VhdlLiteralParser::visitSTRING_LITERAL(
@@ -9,6 +9,7 @@
 #include <hdlConvertor/vhdlConvertor/subProgramParser.h>
 #include <hdlConvertor/vhdlConvertor/subtypeDeclarationParser.h>
 #include <hdlConvertor/vhdlConvertor/variableParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 namespace hdlConvertor {
 namespace vhdl {
@@ -26,7 +27,7 @@ std::unique_ptr<hdlObjects::HdlStmProcess> VhdlProcessParser::visitProcess_state
 	//           KW_END ( KW_POSTPONED )? KW_PROCESS ( label )? SEMI
 	// ;
 	auto p = create_object<HdlStmProcess>(ctx);
-	auto &stms = dynamic_cast<HdlStmBlock*>(p->body.get())->statements;
+	auto &stms = hdl_obj_cast<HdlStmBlock>(p->body.get())->statements;
 	auto sl = ctx->process_sensitivity_list();
 	if (sl) {
 		p->sensitivity_list = std::make_unique<
@@ -14,6 +14,7 @@
 #include <hdlConvertor/vhdlConvertor/literalParser.h>
 #include <hdlConvertor/vhdlConvertor/processParser.h>
 #include <hdlConvertor/vhdlConvertor/statementParser.h>
+#include <hdlConvertor/hdlObjects/hdlObjVisitor.h>
 
 using namespace std;
 using vhdlParser = vhdl_antlr::vhdlParser;
@@ -23,7 +24,7 @@ namespace hdlConvertor {
 namespace vhdl {
 
 bool is_others(unique_ptr<iHdlExpr> &e) {
-	auto _e = dynamic_cast<HdlValue*>(e->data);
+	auto _e = hdl_expr_item_cast<HdlValue>(e->data);
 	return (_e && _e->type == HdlValueType::symb_OTHERS);
 }
 
@@ -1,7 +1,12 @@
 import unittest
 
+from tests.test_binary_ast import BinaryAstTC
+from tests.test_hdl_expr_tree import HdlExprTreeTC
 from tests.test_icarus_verilog_testsuite import IcarusVerilogTestsuiteTC
+from tests.test_input_stream import InputStreamTC
+from tests.test_parse_api import ParseApiTC
 from tests.test_sv2017_std_examples_parse import Sv2017StdExamplesParseTC
+from tests.test_to_py import ToPyTC
 from tests.test_verilator_testsuite import VerilatorTestsuiteTC
 from tests.test_verilog_conversion import VerilogConversionTC
 from tests.test_verilog_preproc import VerilogPreprocTC
@@ -23,6 +28,11 @@ def main_test_suite():
         VerilogPreprocMacroDbApiTC,
         VerilogConversionTC,
         VhdlConversionTC,
+        ParseApiTC,
+        InputStreamTC,
+        ToPyTC,
+        HdlExprTreeTC,
+        BinaryAstTC,
         Sv2017StdExamplesParseTC,
         IcarusVerilogTestsuiteTC,
         VerilatorTestsuiteTC,
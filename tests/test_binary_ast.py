@@ -0,0 +1,127 @@
+from enum import Enum
+import os
+import struct
+import tempfile
+import unittest
+
+from hdlConvertor import HdlConvertor
+from hdlConvertor.hdlAst import CodePosition
+from hdlConvertor.language import Language
+
+from tests.basic_tc import TEST_DIR
+
+
+class BinaryAstTC(unittest.TestCase):
+
+    def _save(self, c):
+        fd, fname = tempfile.mkstemp(suffix=".hdlb")
+        os.close(fd)
+        try:
+            c.save_ast(fname)
+            with open(fname, "rb") as f:
+                return f.read()
+        finally:
+            os.remove(fname)
+
+    def _load(self, c, data):
+        fd, fname = tempfile.mkstemp(suffix=".hdlb")
+        try:
+            os.write(fd, data)
+            os.close(fd)
+            return c.load_ast(fname)
+        finally:
+            os.remove(fname)
+
+    def assertSameAst(self, a, b, positions, path="objs"):
+        self.assertIs(type(a), type(b), path)
+        if isinstance(a, list):
+            self.assertEqual(len(a), len(b), path)
+            for i, (_a, _b) in enumerate(zip(a, b)):
+                self.assertSameAst(_a, _b, positions, "%s[%d]" % (path, i))
+        elif isinstance(a, Enum) or not hasattr(type(a), "__slots__"):
+            self.assertEqual(a, b, path)
+        else:
+            if isinstance(a, CodePosition):
+                positions.append(a)
+            for c in type(a).__mro__:
+                for s in getattr(c, "__slots__", ()):
+                    self.assertSameAst(getattr(a, s), getattr(b, s),
+                                       positions, path + "." + s)
+
+    def test_save_ast(self):
+        c = HdlConvertor()
+        c.parse([os.path.join(TEST_DIR, "vhdl", "mux.vhd")],
+                Language.VHDL, [], debug=False)
+        data = self._save(c)
+        magic, version, root, strings, positions, size = struct.unpack_from(
+            "<4sIIIII", data)
+        self.assertEqual(magic, b"HDLB")
+        self.assertEqual(version, 1)
+        self.assertEqual(size, len(data))
+        self.assertLess(root, positions)
+        self.assertLess(positions, strings)
+        self.assertIn(b"mux", data[strings:])
+
+    def test_load_ast(self):
+        # the loaded objects are the same as the parsed ones (including the positions)
+        for fname, lang in [
+                (os.path.join("vhdl", "mux.vhd"), Language.VHDL),
+                (os.path.join("vhdl", "ram.vhd"), Language.VHDL),
+                (os.path.join("verilog", "aes.v"), Language.VERILOG),
+                (os.path.join("verilog", "fifo_rx.v"), Language.VERILOG),
+                (os.path.join("verilog", "decoder_using_case.v"), Language.VERILOG),
+                (os.path.join("verilog", "parity_using_function2.v"), Language.VERILOG),
+            ]:
+            with self.subTest(fname):
+                c = HdlConvertor()
+                res = c.parse([os.path.join(TEST_DIR, fname)], lang,
+                              [os.path.join(TEST_DIR, "verilog")], debug=False)
+                loaded = self._load(HdlConvertor(), self._save(c))
+                positions = []
+                self.assertSameAst(res.objs, loaded.objs, positions)
+                self.assertTrue(positions)
+
+    def test_load_ast_accumulates(self):
+        # save_ast stores the objects from all parse calls,
+        # load_ast appends them to the objects of the instance
+        c = HdlConvertor()
+        c.parse_str("entity a is end entity;", Language.VHDL, [])
+        c.parse_str("entity b is end entity;", Language.VHDL, [])
+        data = self._save(c)
+
+        c2 = HdlConvertor()
+        c2.parse_str("entity c is end entity;", Language.VHDL, [])
+        res = self._load(c2, data)
+        self.assertEqual([o.name for o in res.objs], ["c", "a", "b"])
+        res = self._load(c2, data)
+        self.assertEqual([o.name for o in res.objs], ["c", "a", "b", "a", "b"])
+
+    def test_load_ast_invalid(self):
+        c = HdlConvertor()
+        c.parse_str("entity a is end entity;", Language.VHDL, [])
+        data = self._save(c)
+        bad_version = data[:4] + struct.pack("<I", 99) + data[8:]
+        bad_root = data[:8] + struct.pack("<I", 0) + data[12:]
+        for name, d, msg in [
+                ("truncated", data[:len(data) // 2], "truncated"),
+                ("empty", b"", "not a binary AST file"),
+                ("bad magic", b"XDLB" + data[4:], "not a binary AST file"),
+                ("bad version", bad_version, "unsupported version"),
+                ("bad root", bad_root, "invalid root node"),
+            ]:
+            with self.subTest(name):
+                c = HdlConvertor()
+                c.parse_str("entity b is end entity;", Language.VHDL, [])
+                with self.assertRaisesRegex(RuntimeError, msg):
+                    self._load(c, d)
+                # the AST of the instance is not modified
+                res = c.parse_str("entity c is end entity;", Language.VHDL, [])
+                self.assertEqual([o.name for o in res.objs], ["b", "c"])
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    suite.addTest(unittest.makeSuite(BinaryAstTC))
+
+    runner = unittest.TextTestRunner(verbosity=3)
+    runner.run(suite)
@@ -0,0 +1,92 @@
+import unittest
+
+from hdlConvertor import HdlExprTree
+from hdlConvertor.hdlAst import HdlAll, HdlBuiltinFn, HdlCall, HdlIntValue, \
+    HdlName, HdlOthers, HdlTypeAuto, HdlTypeType
+
+
+class HdlExprTreeTC(unittest.TestCase):
+
+    def test_shared_nodes(self):
+        t = HdlExprTree()
+        a = t.add_id("a")
+        b = t.add_int(3, 8)
+        s = t.add_call(HdlBuiltinFn.ADD, [a, b])
+        m = t.add_call(HdlBuiltinFn.MUL, [s, s])
+        self.assertEqual(len(t), 4)
+
+        e = t.to_py()
+        self.assertIsInstance(e, HdlCall)
+        self.assertEqual(e.fn, HdlBuiltinFn.MUL)
+        # the shared node is converted to a single object
+        self.assertIs(e.ops[0], e.ops[1])
+        add = e.ops[0]
+        self.assertEqual(add.fn, HdlBuiltinFn.ADD)
+        self.assertEqual(add.ops, [HdlName("a"), HdlIntValue(3, 8, None)])
+
+        # to_expr copies the shared node for each of its users
+        t2 = t.rebuild()
+        self.assertEqual(len(t2), 7)
+        e2 = t2.to_py()
+        self.assertEqual(e2, e)
+        self.assertIsNot(e2.ops[0], e2.ops[1])
+        self.assertEqual(t2.to_py(s), add)
+
+    def test_values(self):
+        t = HdlExprTree()
+        items = [
+            t.add_value("T"),
+            t.add_value("AUTO"),
+            t.add_value("ALL"),
+            t.add_value("OTHERS"),
+            t.add_value("OPEN"),
+            t.add_none(),
+            t.add_str("str"),
+            t.add_float(1.5),
+            t.add_int(-1),
+            t.add_id("b"),
+        ]
+        arr = t.add_array(items)
+        t.add_call(HdlBuiltinFn.INDEX, [t.add_id("c"), arr])
+        ref = [HdlTypeType, HdlTypeAuto, HdlAll, HdlOthers, None, None,
+               "str", 1.5, HdlIntValue(-1, None, None), HdlName("b")]
+        self.assertEqual(t.to_py(arr), ref)
+        for _t in [t, t.rebuild()]:
+            e = _t.to_py()
+            self.assertEqual(e.fn, HdlBuiltinFn.INDEX)
+            self.assertEqual(e.ops, [HdlName("c"), ref])
+
+        with self.assertRaises(KeyError):
+            t.add_value("INT")
+
+    def test_invalid_nodes(self):
+        t = HdlExprTree()
+        with self.assertRaises(IndexError):
+            t.to_py()
+        a = t.add_id("a")
+        # the operands have to be added before the node
+        with self.assertRaises(IndexError):
+            t.add_call(HdlBuiltinFn.ADD, [a, a + 1])
+        with self.assertRaises(IndexError):
+            t.to_py(a + 10)
+
+    def test_deep_expression(self):
+        # converted without recursion
+        t = HdlExprTree()
+        n = t.add_id("a")
+        depth = 100000
+        for _ in range(depth):
+            n = t.add_call(HdlBuiltinFn.NEG, [n])
+        e = t.to_py()
+        for _ in range(depth):
+            self.assertEqual(e.fn, HdlBuiltinFn.NEG)
+            e = e.ops[0]
+        self.assertEqual(e, HdlName("a"))
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    # suite.addTest(HdlExprTreeTC('test_shared_nodes'))
+    suite.addTest(unittest.makeSuite(HdlExprTreeTC))
+    runner = unittest.TextTestRunner(verbosity=3)
+    runner.run(suite)
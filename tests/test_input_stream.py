@@ -0,0 +1,72 @@
+# -*- coding: utf-8 -*-
+import os
+import shutil
+import tempfile
+import unittest
+
+from hdlConvertor import HdlConvertor
+from hdlConvertor.language import Language
+from hdlConvertor import hdlAst
+
+
+class InputStreamTC(unittest.TestCase):
+    """
+    Tests for the reading of the input files (Utf8CharStream/MmapFileCharStream)
+    """
+
+    def setUp(self):
+        self.tmp_dir = tempfile.mkdtemp()
+
+    def tearDown(self):
+        shutil.rmtree(self.tmp_dir)
+
+    def write_file(self, name, data):
+        fname = os.path.join(self.tmp_dir, name)
+        with open(fname, "wb") as f:
+            f.write(data)
+        return fname
+
+    def parse(self, fname, lang=Language.VHDL):
+        return HdlConvertor().parse([fname], lang, [], debug=False)
+
+    def test_empty_file(self):
+        for name, lang in [("empty.vhd", Language.VHDL),
+                           ("empty.sv", Language.SYSTEM_VERILOG)]:
+            res = self.parse(self.write_file(name, b""), lang)
+            self.assertEqual(res.objs, [])
+
+    def test_non_ascii(self):
+        # the file starts with UTF-8 BOM
+        src = u"""\ufeff-- komentář: žluťoučký kůň
+package p is
+    constant s : string := "Å©§";
+    constant i : integer := 1;
+end package;
+""".encode("utf-8")
+        res = self.parse(self.write_file("non_ascii.vhd", src))
+        pkg = res.objs[0]
+        self.assertIsInstance(pkg, hdlAst.HdlNamespace)
+        self.assertEqual(pkg.name, "p")
+        s, i = pkg.objs
+        self.assertEqual(s.name, "s")
+        self.assertEqual(s.value, u"Å©§")
+        self.assertEqual(i.name, "i")
+
+    def test_invalid_utf8(self):
+        # overlong encoding, surrogate, code point above U+10FFFF, truncated sequence,
+        # all of them are replaced by U+FFFD and do not stop the parsing
+        src = (b"-- \xc0\xaf \xed\xa0\x80 \xf4\x90\x80\x80 \xe2\x82\n"
+               b"package p is\n"
+               b"    constant i : integer := 1;\n"
+               b"end package;\n")
+        res = self.parse(self.write_file("invalid_utf8.vhd", src))
+        self.assertEqual(res.objs[0].name, "p")
+        self.assertEqual(res.objs[0].objs[0].name, "i")
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    suite.addTest(unittest.makeSuite(InputStreamTC))
+
+    runner = unittest.TextTestRunner(verbosity=3)
+    runner.run(suite)
@@ -0,0 +1,220 @@
+from io import StringIO
+import os
+import tempfile
+from threading import Thread
+import unittest
+
+from hdlConvertor import ParseException, HdlConvertor
+from hdlConvertor.language import Language
+from hdlConvertor import hdlAst
+from hdlConvertor.toVerilog import ToVerilog
+from hdlConvertor.toVhdl import ToVhdl
+
+from tests.basic_tc import TEST_DIR
+
+
+def vhdl_files(*names):
+    return [os.path.join(TEST_DIR, "vhdl", f) for f in names]
+
+
+def to_vhdl(ctx):
+    buff = StringIO()
+    ToVhdl(buff).print_context(ctx)
+    return buff.getvalue()
+
+
+class ParseApiTC(unittest.TestCase):
+    """
+    Tests for the options of HdlConvertor which should not change the result of the parsing
+    """
+
+    def test_parallel_parse_keeps_file_order(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "with_select.vhd",
+                           "package_constants.vhd", "fourbit_adder.vhd")
+        ref = HdlConvertor().parse(files, Language.VHDL, [], debug=False)
+        res = HdlConvertor().parse(files, Language.VHDL, [], debug=False, jobs=4)
+        self.assertEqual(to_vhdl(ref), to_vhdl(res))
+
+    def test_parallel_parse_malformed(self):
+        files = vhdl_files("mux.vhd", "malformed.vhd", "ram.vhd")
+        with self.assertRaises(ParseException):
+            HdlConvertor().parse(files, Language.VHDL, [], debug=False, jobs=2)
+
+    def test_two_stage_prediction(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "with_select.vhd",
+                           "package_constants.vhd")
+        ref = HdlConvertor().parse(files, Language.VHDL, [], debug=False)
+        c = HdlConvertor()
+        c.two_stage_prediction = True
+        res = c.parse(files, Language.VHDL, [], debug=False)
+        self.assertEqual(to_vhdl(ref), to_vhdl(res))
+        stats = c.get_parse_stats()
+        self.assertEqual(stats["parsed"], len(files))
+
+    def test_two_stage_prediction_fallback(self):
+        # the SLL stage bails out on any syntax error, the error has to be reported
+        # by the LL stage the same way as in the LL only mode
+        files = vhdl_files("malformed.vhd")
+        with self.assertRaises(ParseException) as ref:
+            HdlConvertor().parse(files, Language.VHDL, [], debug=False)
+        c = HdlConvertor()
+        c.two_stage_prediction = True
+        with self.assertRaises(ParseException) as res:
+            c.parse(files, Language.VHDL, [], debug=False)
+        self.assertEqual(str(ref.exception), str(res.exception))
+        stats = c.get_parse_stats()
+        self.assertEqual(stats["parsed"], 1)
+        self.assertEqual(stats["sll_fallback"], 1)
+
+    def test_warmup_dfa(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "malformed.vhd")
+        c = HdlConvertor()
+        dfa_states = c.warmup_dfa(files, Language.VHDL, [])
+        self.assertGreater(dfa_states, 0)
+        res = HdlConvertor().parse(vhdl_files("mux.vhd"), Language.VHDL, [], debug=False)
+        self.assertTrue(res.objs)
+
+    def test_ast_arena(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "with_select.vhd")
+        ref = to_vhdl(HdlConvertor().parse(files, Language.VHDL, [], debug=False))
+        for jobs in [1, 4]:
+            c = HdlConvertor()
+            c.ast_arena = True
+            res = c.parse(files, Language.VHDL, [], debug=False, jobs=jobs)
+            self.assertEqual(ref, to_vhdl(res))
+
+    def test_lazy_ast(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "package_constants.vhd")
+        ref = HdlConvertor().parse(files, Language.VHDL, [], debug=False)
+        c = HdlConvertor()
+        c.lazy_ast = True
+        res = c.parse(files, Language.VHDL, [], debug=False)
+        archs = [o for o in res.objs if isinstance(o, hdlAst.HdlModuleDef)]
+        self.assertTrue(archs)
+        for a, ref_a in zip(archs, [o for o in ref.objs
+                                    if isinstance(o, hdlAst.HdlModuleDef)]):
+            self.assertIsInstance(a.objs, list)
+            self.assertEqual(len(a.objs), len(ref_a.objs))
+        del c
+        self.assertEqual(to_vhdl(ref), to_vhdl(res))
+
+    def test_parse_cache(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "package_constants.vhd")
+        ref = to_vhdl(HdlConvertor().parse(files, Language.VHDL, [], debug=False))
+        with tempfile.TemporaryDirectory() as d:
+            c = HdlConvertor()
+            self.assertIsNone(c.parse_cache_dir)
+            c.parse_cache_dir = d
+            self.assertEqual(c.parse_cache_dir, d)
+            res = c.parse(files, Language.VHDL, [], debug=False)
+            self.assertEqual(ref, to_vhdl(res))
+            self.assertEqual(c.get_parse_cache_stats(), {"hit": 0, "miss": len(files)})
+            self.assertEqual(len(os.listdir(d)), len(files))
+
+            # an other instance (or process) uses the entries, the parser does not run
+            for jobs in [1, 4]:
+                c = HdlConvertor()
+                c.parse_cache_dir = d
+                res = c.parse(files, Language.VHDL, [], debug=False, jobs=jobs)
+                self.assertEqual(ref, to_vhdl(res))
+                self.assertEqual(c.get_parse_cache_stats(), {"hit": len(files), "miss": 0})
+                self.assertEqual(c.get_parse_stats()["parsed"], 0)
+
+            # hierarchyOnly produces a different AST
+            c = HdlConvertor()
+            c.parse_cache_dir = d
+            c.parse(files[:1], Language.VHDL, [], hierarchyOnly=True, debug=False)
+            self.assertEqual(c.get_parse_cache_stats(), {"hit": 0, "miss": 1})
+
+    def test_parse_cache_malformed(self):
+        with tempfile.TemporaryDirectory() as d:
+            for _ in range(2):
+                c = HdlConvertor()
+                c.parse_cache_dir = d
+                with self.assertRaises(ParseException):
+                    c.parse(vhdl_files("malformed.vhd"), Language.VHDL, [], debug=False)
+                self.assertEqual(c.get_parse_cache_stats(), {"hit": 0, "miss": 1})
+            self.assertEqual(os.listdir(d), [])
+
+    def test_parse_cache_verilog_macros(self):
+        # the key is computed from the output of the preprocessor
+        code = "module m; wire [`W-1:0] a; endmodule\n"
+
+        def parse(d, w):
+            c = HdlConvertor()
+            c.parse_cache_dir = d
+            c.preproc_macro_db["W"] = w
+            res = c.parse_str(code, Language.SYSTEM_VERILOG, [], debug=False)
+            buff = StringIO()
+            ToVerilog(buff).print_context(res)
+            return c, buff.getvalue()
+
+        with tempfile.TemporaryDirectory() as d:
+            _, ref8 = parse(d, "8")
+            c, res8 = parse(d, "8")
+            self.assertEqual(ref8, res8)
+            self.assertEqual(c.get_parse_cache_stats(), {"hit": 1, "miss": 0})
+            c, res4 = parse(d, "4")
+            self.assertEqual(c.get_parse_cache_stats(), {"hit": 0, "miss": 1})
+            self.assertNotEqual(res8, res4)
+
+    def test_parse_in_threads(self):
+        files = vhdl_files("mux.vhd", "ram.vhd", "call.vhd", "with_select.vhd")
+        ref = [to_vhdl(HdlConvertor().parse([f], Language.VHDL, [], debug=False))
+               for f in files]
+        res = [None for _ in files]
+        def parse(i):
+            for _ in range(4):
+                # the context of the HdlConvertor accumulates the results
+                c = HdlConvertor()
+                res[i] = to_vhdl(c.parse([files[i]], Language.VHDL, [], debug=False))
+
+        threads = [Thread(target=parse, args=(i,)) for i in range(len(files))]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        self.assertEqual(ref, res)
+
+    def test_shared_instance_in_threads(self):
+        # the calls on the same instance are serialized by its lock
+        c = HdlConvertor()
+        c.lazy_ast = True
+        c.preproc_macro_db["W"] = "8"
+        names = ["m%d" % i for i in range(8)]
+        results = []
+
+        def parse(name):
+            res = c.parse_str(
+                "`define D_%s 1\nmodule %s; wire [`W-1:0] a; endmodule\n" % (name, name),
+                Language.SYSTEM_VERILOG, [], debug=False)
+            results.append(res)
+
+        threads = [Thread(target=parse, args=(n,)) for n in names]
+        for t in threads:
+            t.start()
+        for _ in range(100):
+            len(c.preproc_macro_db)
+            self.assertIn("W", c.preproc_macro_db)
+            for res in list(results):
+                for o in res.objs:
+                    if isinstance(o, hdlAst.HdlModuleDef):
+                        len(list(o.objs))
+        for t in threads:
+            t.join()
+
+        # the context accumulates the results, the last converted one has all modules
+        res = max(results, key=lambda r: len(r.objs))
+        self.assertEqual(
+            sorted(o.name for o in res.objs if isinstance(o, hdlAst.HdlModuleDef)),
+            names)
+        # the macros from the code are not persistent
+        self.assertEqual(list(c.preproc_macro_db.keys()), ["W"])
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    suite.addTest(unittest.makeSuite(ParseApiTC))
+
+    runner = unittest.TextTestRunner(verbosity=3)
+    runner.run(suite)
@@ -0,0 +1,184 @@
+from enum import Enum
+import unittest
+
+from hdlConvertor import HdlConvertor, HdlExprTree
+from hdlConvertor.language import Language
+from hdlConvertor import hdlAst
+
+from tests.basic_tc import parseFile
+
+
+class ToPyTC(unittest.TestCase):
+    """
+    Tests for the conversion of the C++ AST to Python objects
+    """
+
+    def test_shared_names(self):
+        f, res = parseFile("mux.vhd", Language.VHDL)
+        names = {}
+
+        def collect(o):
+            if isinstance(o, hdlAst.HdlName):
+                self.assertIs(names.setdefault(str(o), o), o)
+            elif isinstance(o, (list, tuple)):
+                for i in o:
+                    collect(i)
+            elif isinstance(o, (hdlAst.HdlCall, hdlAst.HdlVariableDef,
+                                hdlAst.HdlModuleDef, hdlAst.HdlModuleDec)):
+                for c in type(o).__mro__:
+                    for s in getattr(c, "__slots__", []):
+                        collect(getattr(o, s, None))
+
+        collect(res.objs)
+        self.assertTrue(names)
+
+    def test_shared_ints(self):
+        # with share_int_values the same integer values share the HdlIntValue,
+        # the bitstrings do not
+        code = (
+            "package p is\n"
+            "    constant A : integer := 5;\n"
+            "    constant B : integer := 5;\n"
+            "    constant C : integer := 6;\n"
+            "    constant D : std_logic_vector(3 downto 0) := X\"5\";\n"
+            "    constant E : std_logic_vector(3 downto 0) := X\"5\";\n"
+            "end package;\n")
+        c = HdlConvertor()
+        self.assertFalse(c.share_int_values)
+        c.share_int_values = True
+        res = c.parse_str(code, Language.VHDL, [])
+        a, b, c, d, e = res.objs[0].objs
+        self.assertIs(a.value, b.value)
+        self.assertEqual(a.value, hdlAst.HdlIntValue(5, None, None))
+        self.assertIsNot(a.value, c.value)
+        self.assertEqual(d.value, e.value)
+        self.assertIsNot(d.value, e.value)
+        self.assertIsNot(a.value, d.value)
+
+    def test_not_shared_ints(self):
+        # by default each occurrence has its own HdlIntValue which can be modified
+        res = HdlConvertor().parse_str(
+            "package p is\n"
+            "    constant A : integer := 5;\n"
+            "    constant B : integer := 5;\n"
+            "end package;\n", Language.VHDL, [])
+        a, b = res.objs[0].objs
+        self.assertEqual(a.value, b.value)
+        self.assertIsNot(a.value, b.value)
+        a.value.val = 6
+        self.assertEqual(b.value, hdlAst.HdlIntValue(5, None, None))
+
+    def test_shared_ints_bits(self):
+        # the width is a part of the key of the cache
+        t = HdlExprTree()
+        t.add_array([
+            t.add_int(5), t.add_int(5),
+            t.add_int(5, 8), t.add_int(5, 8),
+            t.add_int(5, 4),
+            t.add_int(5, 0),
+            t.add_int(-1), t.add_int(-1, 1),
+        ])
+        v = t.to_py(share_int_values=True)
+        self.assertIs(v[0], v[1])
+        self.assertIs(v[2], v[3])
+        self.assertEqual(v[2], hdlAst.HdlIntValue(5, 8, None))
+        self.assertIsNot(v[0], v[2])
+        self.assertIsNot(v[2], v[4])
+        self.assertEqual(v[4], hdlAst.HdlIntValue(5, 4, None))
+        # the width 0 is not specified in Python, same as -1
+        self.assertEqual(v[5], v[0])
+        self.assertIsNot(v[6], v[7])
+        self.assertEqual((v[6].bits, v[7].bits), (None, 1))
+
+        v = t.to_py()
+        self.assertEqual(v[0], v[1])
+        self.assertIsNot(v[0], v[1])
+
+    def test_int64_values(self):
+        # the values out of the range of 32b long (Windows) are not truncated
+        t = HdlExprTree()
+        vals = [2 ** 40, -2 ** 40, 2 ** 63 - 1, -2 ** 63]
+        t.add_array([t.add_int(v) for v in vals])
+        self.assertEqual([i.val for i in t.to_py()], vals)
+
+    @staticmethod
+    def _slots(cls):
+        for c in cls.__mro__:
+            for s in getattr(c, "__slots__", ()):
+                yield s
+
+    def test_objects_same_as_constructed(self):
+        # ToPy::new_inst creates the objects without the call of __init__,
+        # all slots have to be set and each object has to have its own lists
+        seen_lists = {}
+        visited = set()
+        checked_classes = set()
+
+        def check(o):
+            if isinstance(o, (list, tuple)):
+                for i in o:
+                    check(i)
+                return
+            if o is None or isinstance(o, (type, Enum, str, int, float)) \
+                    or not hasattr(type(o), "__slots__") or id(o) in visited:
+                return
+            visited.add(id(o))
+            try:
+                ref = type(o)()
+            except TypeError:
+                # the class created by its constructor with arguments
+                ref = None
+            for s in self._slots(type(o)):
+                v = getattr(o, s)  # AttributeError if the slot is not set
+                if ref is not None:
+                    ref_v = getattr(ref, s)
+                    if isinstance(ref_v, list):
+                        self.assertIsInstance(v, list, (type(o), s))
+                        self.assertNotIn(id(v), seen_lists, (type(o), s))
+                        seen_lists[id(v)] = v
+                    checked_classes.add(type(o))
+                check(v)
+
+        for f, lang in [("mux.vhd", Language.VHDL),
+                        ("ram.vhd", Language.VHDL),
+                        ("call.vhd", Language.VHDL),
+                        ("with_select.vhd", Language.VHDL),
+                        ("arbiter.v", Language.VERILOG),
+                        ("decoder_using_case.v", Language.VERILOG),
+                        ("parity_using_function2.v", Language.VERILOG),
+                        ("lfsr_updown_tb.v", Language.VERILOG)]:
+            _, res = parseFile(f, lang)
+            check(res.objs)
+        for cls in [hdlAst.HdlModuleDec, hdlAst.HdlModuleDef,
+                    hdlAst.HdlVariableDef, hdlAst.HdlCall, hdlAst.HdlStmIf,
+                    hdlAst.HdlStmAssign, hdlAst.HdlStmProcess, hdlAst.HdlStmCase,
+                    hdlAst.HdlStmBlock, hdlAst.HdlFunctionDef]:
+            self.assertIn(cls, checked_classes)
+
+    def test_empty_objects_same_as_constructed(self):
+        # the slots which are not set by the converter have the values from the constructor
+        res = HdlConvertor().parse_str(
+            "entity e is\n"
+            "end entity;\n"
+            "architecture a of e is\n"
+            "begin\n"
+            "end architecture;\n", Language.VHDL, [])
+        dec, _def = res.objs
+        for o, converted_slots in [(dec, ("name", "position")),
+                                   (_def, ("name", "module_name", "position"))]:
+            ref = type(o)()
+            for s in self._slots(type(o)):
+                if s not in converted_slots:
+                    self.assertEqual(getattr(o, s), getattr(ref, s), (type(o), s))
+            self.assertEqual(o.objs, [])
+            o.objs.append(1)
+            self.assertEqual(ref.objs, [])
+        self.assertEqual(_def.module_name, "e")
+
+
+if __name__ == "__main__":
+    suite = unittest.TestSuite()
+    suite.addTest(unittest.makeSuite(ToPyTC))
+
+    runner = unittest.TextTestRunner(verbosity=3)
+    runner.run(suite)
@@ -2,7 +2,7 @@ from os import path
 import unittest
 
 from hdlConvertor import HdlConvertor
-from hdlConvertor.hdlAst import HdlModuleDec, HdlModuleDef, HdlDirection
+from hdlConvertor.hdlAst import HdlModuleDec, HdlModuleDef, HdlDirection, HdlVariableDef
 from hdlConvertor.language import Language
 
 from tests.basic_tc import TEST_DIR, BasicTC, parseFile
@@ -78,6 +78,87 @@ class VerilogConversionTC(BasicTC):
         str(res)
         self.check_obj_names(res, HdlModuleDec, ["arbiter", "uart"])
 
+    def test_include_positions(self):
+        # the lines of the objects from the included files are translated
+        # by the source map of the preprocessor to the lines of the included files
+        f, res = parseFile("include.v", VERILOG)
+        for name, file_name, start, stop in [("arbiter", "arbiter.v", 6, 124),
+                                             ("uart", "uart.v", 8, 155)]:
+            m = self.find_obj_by_name(res, HdlModuleDef, name)
+            p = m.position
+            self.assertIsNotNone(p, name)
+            self.assertEqual(path.basename(p.file), file_name)
+            self.assertEqual((p.startLine, p.stopLine), (start, stop))
+
+    def test_macro_positions(self):
+        # the lines removed/added by the preprocessor do not shift the lines of the objects
+        c = HdlConvertor()
+        res = c.parse_str(
+            "`define W(name) \\\n"
+            "    wire name; \\\n"
+            "    wire name``_1;\n"
+            "`ifdef NOT_DEFINED\n"
+            "module skipped;\n"
+            "endmodule\n"
+            "`endif\n"
+            "module a;\n"
+            "    `W(x)\n"
+            "endmodule\n"
+            "module b;\n"
+            "endmodule\n", SV, [])
+        for name, start, stop in [("a", 8, 10), ("b", 11, 12)]:
+            m = self.find_obj_by_name(res, HdlModuleDef, name)
+            self.assertEqual((m.position.startLine, m.position.stopLine),
+                             (start, stop), name)
+
+    def test_position_columns(self):
+        # same values with and without HDLCONVERTOR_COMPACT_POSITION
+        c = HdlConvertor()
+        res = c.parse_str(
+            "module a;\n"
+            "  wire x;\n"
+            "endmodule\n"
+            "  module b; endmodule\n", SV, [])
+        for name, pos in [("a", (1, 3, 1, 9)), ("b", (4, 4, 3, 21))]:
+            p = self.find_obj_by_name(res, HdlModuleDef, name).position
+            self.assertEqual((p.startLine, p.stopLine, p.startColumn, p.stopColumn),
+                             pos, name)
+            self.assertIsNone(p.file)
+
+    def test_position_multiline_stop_token(self):
+        # HDLCONVERTOR_COMPACT_POSITION computes the stop from the start and the length,
+        # the line continuation in the string is not counted as a new line
+        c = HdlConvertor()
+        res = c.parse_str(
+            "module m;\n"
+            "    parameter P = \"a\\\nbc\";\n"
+            "endmodule\n", SV, [])
+        m = self.find_obj_by_name(res, HdlModuleDef, "m")
+        p = self.find_obj_by_name(m, HdlVariableDef, "P").position
+        if HdlConvertor.COMPACT_POSITION:
+            pos = (2, 3, 15, 3)
+        else:
+            pos = (2, 2, 15, 25)
+        self.assertEqual((p.startLine, p.stopLine, p.startColumn, p.stopColumn), pos)
+
+    def test_long_bitstring(self):
+        # the bitstrings longer than BigInteger::INLINE_BITSTRING_SIZE are on the heap
+        c = HdlConvertor()
+        res = c.parse_str(
+            "module m #(\n"
+            "    parameter [79:0] A = 80'h0123456789abcdef0123,\n"
+            "    parameter [15:0] B = 16'b0101010101010101,\n"
+            "    parameter [16:0] C = 17'b10101010101010101\n"
+            ") ();\n"
+            "endmodule\n", SV, [])
+        m = self.find_obj_by_name(res, HdlModuleDec, "m")
+        vals = [(p.value.val, p.value.bits, p.value.base) for p in m.params]
+        self.assertEqual(vals, [
+            ("0123456789abcdef0123", 80, 16),
+            ("0101010101010101", 16, 2),
+            ("10101010101010101", 17, 2),
+        ])
+
     def test_lfsr_updown_tb(self):
         self.parseWithRef("lfsr_updown_tb.v", VERILOG)
 
@@ -128,6 +209,16 @@ class VerilogConversionTC(BasicTC):
     def test_operator_type(self):
         self.parseWithRef("operator_type.sv", SV)
 
+    def test_same_names_share_str(self):
+        c = HdlConvertor()
+        res = c.parse_str(
+            "module a(input clk); endmodule\n"
+            "module b(input clk); endmodule\n", SV, [], debug=False)
+        a, b = [o for o in res.objs if isinstance(o, HdlModuleDec)]
+        self.assertEqual(a.ports[0].name, "clk")
+        # the identifiers are interned, the converted names are shared
+        self.assertIs(a.ports[0].name, b.ports[0].name)
+
 
 if __name__ == "__main__":
     suite = unittest.TestSuite()
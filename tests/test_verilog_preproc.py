@@ -188,6 +188,149 @@ class VerilogPreprocTC(unittest.TestCase):
     def test_macro_args(self):
         self.assertPPWorks("macro_args.txt")
 
+    def test_fast_modes(self):
+        # the output has to be the same as if everything is processed by the preprocessor parser
+        files = ["ifdef_branches.txt", "debug_macro.txt",
+                 "preproc_hash_table.txt", "2012_p641.txt", "test_FILE_LINE.sv",
+                 "stringify.txt", "macro_args.txt",
+                 path.join("include_same_dir", "basic_include2times.txt")]
+        modes = [("preproc_fast_ifdef_skip", ), ("preproc_fast_copy", ),
+                 ("preproc_fast_ifdef_skip", "preproc_fast_copy")]
+        incdirs = [path.join('sv_pp', 'src'), ]
+        for f in files:
+            test_file = path.join('sv_pp', 'src', f)
+            with cd(TEST_DIR):
+                c = HdlConvertor()
+                ref = c.verilog_pp(test_file, Language.SYSTEM_VERILOG, incdirs)
+                for mode in modes:
+                    c = HdlConvertor()
+                    for m in mode:
+                        setattr(c, m, True)
+                    res = c.verilog_pp(test_file, Language.SYSTEM_VERILOG, incdirs)
+                    self.assertEqual(res, ref, (f, mode))
+
+    def test_output_callback(self):
+        # the chunks streamed to the callback have to form the same output
+        # as the one returned by verilog_pp
+        files = ["2012_p641.txt", "test_FILE_LINE.sv", "stringify.txt",
+                 path.join("include_same_dir", "basic_include2times.txt")]
+        incdirs = [path.join('sv_pp', 'src'), ]
+        for f in files:
+            test_file = path.join('sv_pp', 'src', f)
+            with cd(TEST_DIR):
+                c = HdlConvertor()
+                ref = c.verilog_pp(test_file, Language.SYSTEM_VERILOG, incdirs)
+                chunks = []
+                c = HdlConvertor()
+                res = c.verilog_pp(test_file, Language.SYSTEM_VERILOG, incdirs,
+                                   output_callback=chunks.append)
+            self.assertIsNone(res)
+            self.assertGreater(len(chunks), 1, f)
+            self.assertEqual("".join(chunks), ref, f)
+
+    def test_output_callback_error(self):
+        # the exception from the callback stops the preprocessor and it is propagated
+
+        class CallbackError(Exception):
+            pass
+
+        def callback(data):
+            raise CallbackError(data)
+
+        c = HdlConvertor()
+        with cd(TEST_DIR):
+            with self.assertRaises(CallbackError):
+                c.verilog_pp(path.join('sv_pp', 'src', "2012_p641.txt"),
+                             Language.SYSTEM_VERILOG, [path.join('sv_pp', 'src')],
+                             output_callback=callback)
+
+    def test_nested_macro_call(self):
+        c = HdlConvertor()
+        res = c.verilog_pp_str(
+            "`define A(x) (x + 1)\n"
+            "`define B(y) `A(y) * `A(2)\n"
+            "assign z = `B(a);\n", Language.SYSTEM_VERILOG)
+        self.assertEqual(res, "assign z = (a + 1) * (2 + 1);\n")
+
+    def test_nested_macro_line_offset(self):
+        # the replacement of the macro is preprocessed again with the line offset
+        # of the macro call, `__LINE__ and errors have to report the line of the call
+        for fast in (False, True):
+            c = HdlConvertor()
+            c.preproc_fast_macro_expansion = fast
+            res = c.verilog_pp_str(
+                "`define L `__LINE__\n"
+                "`define LL(x) x + `L\n"
+                "\n"
+                "a = `L;\n"
+                "b = `LL(1);\n", Language.SYSTEM_VERILOG)
+            self.assertEqual(res, "\na = 4;\nb = 1 + 5;\n")
+
+            c = HdlConvertor()
+            c.preproc_fast_macro_expansion = fast
+            with self.assertRaises(ParseException) as context:
+                c.verilog_pp_str(
+                    "`define U `NOT_DEFINED\n"
+                    "\n"
+                    "\n"
+                    "a = `U;\n", Language.SYSTEM_VERILOG)
+            e = str(context.exception)
+            self.assertIn("NOT_DEFINED is not defined", e)
+            self.assertRegex(e, ":4:[0-9]+:Error")
+
+    def assertFastMacroExpansionSame(self, src, ref=None):
+        # the output has to be the same as if the nested macro calls are processed
+        # by the preprocessor parser
+        res = []
+        for fast in (False, True):
+            c = HdlConvertor()
+            c.preproc_fast_macro_expansion = fast
+            res.append(c.verilog_pp_str(src, Language.SYSTEM_VERILOG))
+        self.assertEqual(res[0], res[1])
+        if ref is not None:
+            self.assertEqual(res[1], ref)
+
+    def test_nested_macro_call_stringify(self):
+        self.assertFastMacroExpansionSame(
+            "`define W world\n"
+            "`define STR(x) `\"x`\"\n"
+            "`define OUTER(y) `STR(y) `STR(`W) `\"y `W`\"\n"
+            "s = `OUTER(hello);\n"
+            "s = `OUTER(`W);\n")
+
+    def test_nested_macro_call_paste(self):
+        self.assertFastMacroExpansionSame(
+            "`define PRE p\n"
+            "`define CAT(a, b) a``b\n"
+            "`define OUTER(x) `CAT(x, _suffix) `CAT(`PRE, x) x``_1\n"
+            "wire `OUTER(w);\n"
+            "wire `OUTER(`PRE);\n")
+
+    def test_nested_macro_call_default_args(self):
+        self.assertFastMacroExpansionSame(
+            "`define A(x, y=1) (x + y)\n"
+            "`define B(z) `A(z) * `A(z, 2)\n"
+            "assign o = `B(a);\n",
+            "assign o = (a + 1) * (a + 2);\n")
+        self.assertFastMacroExpansionSame(
+            "`define ONE 1\n"
+            "`define A(x, y=`ONE) (x + y)\n"
+            "`define B(z) `A(z) * `A(, z)\n"
+            "assign o = `B(a);\n")
+
+    def test_edits_after_nested_edit(self):
+        # the edits inside of the already written edit must not block the edits
+        # which follow it
+        c = HdlConvertor()
+        res = c.verilog_pp_str(
+            "`define A(x) x\n"
+            "`define B 2\n"
+            "`define EN\n"
+            "`ifdef EN\n a = `A(`B) ;\n`else\n a = `B ;\n`endif\n"
+            "b = `A(`A(`B)) ;\n"
+            "c = `B ;\n", Language.SYSTEM_VERILOG)
+        self.assertEqual(res.split(), "a = 2 ; b = 2 ; c = 2 ;".split())
+
 
 if __name__ == "__main__":
     suite = unittest.TestSuite()
@@ -67,6 +67,29 @@ class VerilogPreprocIncludeTC(unittest.TestCase):
             ["include_many_dir", "transitive.txt"],
             [])
 
+    def test_include_cache(self):
+        c = HdlConvertor()
+        f = path.join(SRC_DIR, "include_same_dir", "basic_include2times.txt")
+        ref_file = path.join(EXPECTED_DIR, "include_same_dir", "basic_include2times.txt")
+        with open(ref_file) as exp_f:
+            expected = exp_f.read()
+
+        res0 = c.verilog_pp(f, Language.VERILOG, [])
+        # the second include is skipped because of the include guard
+        self.assertEqual(c.get_include_cache_stats(),
+                         {"hit": 0, "miss": 1, "guard_skip": 1})
+        res1 = c.verilog_pp(f, Language.VERILOG, [])
+        self.assertEqual(c.get_include_cache_stats(),
+                         {"hit": 1, "miss": 1, "guard_skip": 2})
+        self.assertEqual(res0, expected)
+        self.assertEqual(res1, expected)
+
+        c.include_cache_enabled = False
+        res2 = c.verilog_pp(f, Language.VERILOG, [])
+        self.assertEqual(res2, expected)
+        self.assertEqual(c.get_include_cache_stats(),
+                         {"hit": 1, "miss": 1, "guard_skip": 2})
+
 
 if __name__ == "__main__":
     suite = unittest.TestSuite()
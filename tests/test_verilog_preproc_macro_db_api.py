@@ -1,6 +1,10 @@
+import os
+import shutil
+import tempfile
 import unittest
 
 from hdlConvertor import HdlConvertor
+from hdlConvertor.hdlAst import HdlModuleDec
 from hdlConvertor.language import Language
 
 
@@ -16,7 +20,7 @@ class VerilogPreprocMacroDbApiTC(unittest.TestCase):
         keys = list(db.keys())
         values = [(v.name, v.get_body()) for v in db.values()]
         items = [(i[0], i[1].get_body()) for i in db.items()]
-        # [note] we know order as the std::map is ordered
+        # [note] we know order as the MacroDB keeps the order of insertion
         self.assertEqual(keys, ["SYMBOL%d" % i for i in range(3)])
         ref_values = [("SYMBOL%d" % i, "%d" % i) for i in range(3)]
         self.assertEqual(values, ref_values )
@@ -55,6 +59,63 @@ class VerilogPreprocMacroDbApiTC(unittest.TestCase):
         db = c.preproc_macro_db
         self.assertIn("TEST_SYMBOL", db)
 
+    def test_non_persistent_is_removed(self):
+        # the macro made non persistent later is removed before the next run as well
+        c = HdlConvertor()
+        db = c.preproc_macro_db
+        db["S0"] = "0"
+        db["S1"] = "1"
+        db["S0"].is_persistent = False
+        res = c.verilog_pp_str("`ifdef S0 a `else b `endif `S1",
+                               Language.SYSTEM_VERILOG)
+        self.assertEqual(res.split(), ["b", "1"])
+        self.assertNotIn("S0", db)
+        self.assertIn("S1", db)
+
+    def test_parallel_parse_sees_changes(self):
+        # the parallel parse uses the cached snapshot of the persistent macros,
+        # the snapshot has to be rebuilt after each change of the macros
+        tmp_dir = tempfile.mkdtemp()
+        try:
+            files = []
+            for i in range(2):
+                fname = os.path.join(tmp_dir, "m%d.v" % i)
+                with open(fname, "w") as f:
+                    f.write("`ifdef EN\n"
+                            "module `NAME%d;\n"
+                            "endmodule\n"
+                            "`endif\n" % i)
+                files.append(fname)
+            c = HdlConvertor()
+            db = c.preproc_macro_db
+
+            prev_objs = []
+
+            def parse():
+                res = c.parse(files, Language.VERILOG, [], debug=False, jobs=2)
+                # the context of the HdlConvertor accumulates the results
+                objs = res.objs[len(prev_objs):]
+                prev_objs.extend(objs)
+                return [o.name for o in objs if isinstance(o, HdlModuleDec)]
+
+            db["EN"] = ""
+            db["NAME0"] = "a"
+            db["NAME1"] = "b"
+            self.assertEqual(parse(), ["a", "b"])
+            # overwrite of the existing definition
+            db["NAME1"] = "c"
+            self.assertEqual(parse(), ["a", "c"])
+            # the macro is removed before the parsing if it is not persistent
+            db["EN"].is_persistent = False
+            self.assertEqual(parse(), [])
+            self.assertNotIn("EN", db)
+            db["EN"] = ""
+            del db["NAME0"]
+            db["NAME0"] = "d"
+            self.assertEqual(parse(), ["d", "c"])
+        finally:
+            shutil.rmtree(tmp_dir)
+
 
 if __name__ == "__main__":
     suite = unittest.TestSuite()
@@ -1,6 +1,6 @@
 import unittest
 
-from hdlConvertor import ParseException
+from hdlConvertor import HdlConvertor, ParseException
 from hdlConvertor.language import Language
 from hdlConvertor import hdlAst
 
@@ -65,6 +65,27 @@ class VhdlConversionTC(BasicTC):
     def test_type_attribute_designator(self):
         self.parseWithRef("type_attribute_designator.vhd", Language.VHDL)
 
+    def test_long_bitstring_clone(self):
+        # the bitstrings longer than BigInteger::INLINE_BITSTRING_SIZE are on the heap,
+        # the default value of B is a copy of the value of A
+        c = HdlConvertor()
+        res = c.parse_str(
+            "entity e is\n"
+            "    generic (\n"
+            "        A, B : std_logic_vector(71 downto 0) := X\"0123456789ABCDEF01\";\n"
+            "        C : std_logic_vector(3 downto 0) := X\"F\"\n"
+            "    );\n"
+            "end entity;\n", Language.VHDL, [])
+        e = self.find_obj_by_name(res, hdlAst.HdlModuleDec, "e")
+        a, b, _c = e.params
+        for p in (a, b):
+            v = p.value
+            self.assertIsInstance(v, hdlAst.HdlIntValue)
+            self.assertEqual((v.val, v.bits, v.base),
+                             ("0123456789ABCDEF01", 72, 16), p.name)
+        self.assertIsNot(a.value, b.value)
+        self.assertEqual((_c.value.val, _c.value.bits, _c.value.base), ("F", 4, 16))
+
     def test_library_declaration(self):
         f, res = parseFile("ram.vhd")
         self.assertEqual(str(type(res.objs[0])),